@@ -20,6 +20,8 @@ from pickle import PickleError
 from libc.stdint cimport uint8_t, int8_t, uint16_t, int16_t, uint32_t, int32_t,\
     uint64_t, int64_t
 from libc.errno cimport errno
+from libc.stdlib cimport malloc, free
+from cpython.buffer cimport PyBuffer_FillInfo
 cimport gsd.libgsd as libgsd
 cimport numpy
 
@@ -147,8 +149,84 @@ cdef void * __get_ptr_float64(data):
         return <void*>&data_array_float64[0, 0]
 
 
-def open(name, mode, application=None, schema=None, schema_version=None):
-    """open(name, mode, application=None, schema=None, schema_version=None)
+cdef __chunk_dtype(libgsd.gsd_type gsd_type):
+    """Return the numpy dtype that stores a gsd type (None if invalid)."""
+    if gsd_type == libgsd.GSD_TYPE_UINT8:
+        return numpy.uint8
+    elif gsd_type == libgsd.GSD_TYPE_UINT16:
+        return numpy.uint16
+    elif gsd_type == libgsd.GSD_TYPE_UINT32:
+        return numpy.uint32
+    elif gsd_type == libgsd.GSD_TYPE_UINT64:
+        return numpy.uint64
+    elif gsd_type == libgsd.GSD_TYPE_INT8:
+        return numpy.int8
+    elif gsd_type == libgsd.GSD_TYPE_INT16:
+        return numpy.int16
+    elif gsd_type == libgsd.GSD_TYPE_INT32:
+        return numpy.int32
+    elif gsd_type == libgsd.GSD_TYPE_INT64:
+        return numpy.int64
+    elif gsd_type == libgsd.GSD_TYPE_FLOAT:
+        return numpy.float32
+    elif gsd_type == libgsd.GSD_TYPE_DOUBLE:
+        return numpy.float64
+    else:
+        return None
+
+# gsd type that stores each numpy dtype
+_gsd_types = {
+    numpy.dtype(numpy.uint8): libgsd.GSD_TYPE_UINT8,
+    numpy.dtype(numpy.uint16): libgsd.GSD_TYPE_UINT16,
+    numpy.dtype(numpy.uint32): libgsd.GSD_TYPE_UINT32,
+    numpy.dtype(numpy.uint64): libgsd.GSD_TYPE_UINT64,
+    numpy.dtype(numpy.int8): libgsd.GSD_TYPE_INT8,
+    numpy.dtype(numpy.int16): libgsd.GSD_TYPE_INT16,
+    numpy.dtype(numpy.int32): libgsd.GSD_TYPE_INT32,
+    numpy.dtype(numpy.int64): libgsd.GSD_TYPE_INT64,
+    numpy.dtype(numpy.float32): libgsd.GSD_TYPE_FLOAT,
+    numpy.dtype(numpy.float64): libgsd.GSD_TYPE_DOUBLE,
+}
+
+cdef struct __chunk_write:
+    uint16_t id
+    libgsd.gsd_type type
+    uint64_t N
+    uint32_t M
+    void *data
+
+cdef void * __get_ptr(data, libgsd.gsd_type gsd_type):
+    """Return a pointer to the data in a chunk array of the given gsd type."""
+    if gsd_type == libgsd.GSD_TYPE_UINT8:
+        return __get_ptr_uint8(data)
+    elif gsd_type == libgsd.GSD_TYPE_UINT16:
+        return __get_ptr_uint16(data)
+    elif gsd_type == libgsd.GSD_TYPE_UINT32:
+        return __get_ptr_uint32(data)
+    elif gsd_type == libgsd.GSD_TYPE_UINT64:
+        return __get_ptr_uint64(data)
+    elif gsd_type == libgsd.GSD_TYPE_INT8:
+        return __get_ptr_int8(data)
+    elif gsd_type == libgsd.GSD_TYPE_INT16:
+        return __get_ptr_int16(data)
+    elif gsd_type == libgsd.GSD_TYPE_INT32:
+        return __get_ptr_int32(data)
+    elif gsd_type == libgsd.GSD_TYPE_INT64:
+        return __get_ptr_int64(data)
+    elif gsd_type == libgsd.GSD_TYPE_FLOAT:
+        return __get_ptr_float32(data)
+    elif gsd_type == libgsd.GSD_TYPE_DOUBLE:
+        return __get_ptr_float64(data)
+    else:
+        return NULL
+
+
+def open(name, mode, application=None, schema=None, schema_version=None,
+         mmap=False, compression=None, shuffle='byte', async_write=False,
+         durability='always', search_tree=False):
+    """open(name, mode, application=None, schema=None, schema_version=None, \
+mmap=False, compression=None, shuffle='byte', async_write=False, \
+durability='always', search_tree=False)
 
     :py:func:`open` opens a GSD file and returns a :py:class:`GSDFile` instance.
     The return value of :py:func:`open` can be used as a context manager.
@@ -165,6 +243,22 @@ def open(name, mode, application=None, schema=None, schema_version=None):
         schema_version (`typing.Tuple` [int, int]): Schema version number
             (major, minor).
 
+        mmap (bool): Set to True to memory map the file and return read-only
+            views of the file data from :py:meth:`GSDFile.read_chunk()`.
+            Requires mode ``'rb'``.
+
+        compression (str): Compression codec for chunks written to the file:
+            ``None`` or ``'lz4'``.
+
+        shuffle (str): Filter applied to chunks before compression:
+            ``None``, ``'byte'``, or ``'bit'``.
+
+        async_write (bool): Set to True to write frames in a background
+            thread. Requires a writable mode.
+
+        search_tree (bool): Set to True to build an in-memory search tree of
+            the file index when opening the file. Requires mode ``'rb'``.
+
     Valid values for mode:
 
     +------------------+---------------------------------------------+
@@ -206,6 +300,56 @@ def open(name, mode, application=None, schema=None, schema_version=None):
     ``application``, ``schema``, and ``schema_version`` are saved in the file
     and must not be None.
 
+    When ``mmap`` is True, :py:meth:`GSDFile.read_chunk()` and
+    :py:meth:`GSDFile.read_chunks()` return read-only numpy arrays that view
+    the file mapping directly instead of copying the data into new arrays.
+    These arrays remain valid after the file is closed: the mapping is
+    released when the file is closed and the last array viewing it is freed.
+
+    When ``compression`` is ``'lz4'``, :py:meth:`GSDFile.write_chunk()`
+    compresses every chunk with a fast LZ4 codec. ``shuffle='byte'`` groups
+    the bytes of the elements by significance before compressing, which
+    compresses floating point data better. ``shuffle='bit'`` groups the bits
+    of the elements by significance, which compresses data with few
+    significant bits better at a small additional cost. Chunks that do not
+    compress are stored uncompressed. Reading compressed chunks requires no
+    options: :py:meth:`GSDFile.read_chunk()` decompresses them.
+
+    When ``async_write`` is True, :py:meth:`GSDFile.end_frame()` hands the
+    completed frame to a background thread that writes it to the file while
+    the caller writes the next frame. Errors that occur in the background
+    thread are raised by a later call to :py:meth:`GSDFile.end_frame()`,
+    :py:meth:`GSDFile.flush()`, or :py:meth:`GSDFile.close()`.
+
+    ``durability`` sets when a writable file is synchronized to the storage
+    device:
+
+    +------------------+---------------------------------------------+
+    | Durability       | Synchronize                                 |
+    +==================+=============================================+
+    | ``'always'``     | Whenever the file header is updated and     |
+    |                  | when the file is closed (the default).      |
+    +------------------+---------------------------------------------+
+    | *N* (int)        | Every *N* frames and when the file is       |
+    |                  | closed.                                     |
+    +------------------+---------------------------------------------+
+    | ``'close'``      | When the file is closed.                    |
+    +------------------+---------------------------------------------+
+    | ``'never'``      | Only when :py:meth:`GSDFile.flush()` is     |
+    |                  | called.                                     |
+    +------------------+---------------------------------------------+
+
+    With any policy other than ``'always'``, a system crash (but not an
+    application crash) may lose the frames written since the last
+    synchronization or leave the file corrupt.
+
+    When ``search_tree`` is True, :py:func:`open` reads a sample of the file
+    index into memory. The first lookup of a chunk in each frame then reads
+    one page of the index instead of searching the whole index. This speeds up
+    random access to files with millions of chunks, especially when the file
+    is not in the operating system's cache, at the cost of reading the sample
+    when the file is opened.
+
     Example:
 
         .. ipython:: python
@@ -234,7 +378,8 @@ def open(name, mode, application=None, schema=None, schema_version=None):
             f.close()
     """
 
-    return GSDFile(str(name), mode, application, schema, schema_version)
+    return GSDFile(str(name), mode, application, schema, schema_version, mmap,
+                   compression, shuffle, async_write, durability, search_tree)
 
 
 cdef class GSDFile:
@@ -263,10 +408,34 @@ cdef class GSDFile:
             (major, minor).
 
         nframes (int): Number of frames.
+
+        mmap (bool): True when the file is memory mapped.
+
+        compression (str): Compression codec for chunks written to the file.
+
+        async_write (bool): True when frames are written in a background
+            thread.
+
+        durability (str or int): When the file is synchronized to the storage
+            device.
+
+        search_tree (bool): True when the file index has an in-memory search
+            tree.
     """
 
     cdef libgsd.gsd_handle __handle
     cdef bint __is_open
+    cdef bint _close_pending
+    cdef Py_ssize_t _n_views
+    cdef bint mmap
+    cdef object compression
+    cdef bint async_write
+    cdef object durability
+    cdef bint search_tree
+    cdef list _lent_frame
+    cdef list _lent_writing
+    cdef dict _name_ids
+    cdef uint8_t __write_flags
     cdef str mode
     cdef str name
 
@@ -275,8 +444,16 @@ cdef class GSDFile:
                  mode,
                  application,
                  schema,
-                 schema_version):
+                 schema_version,
+                 mmap=False,
+                 compression=None,
+                 shuffle='byte',
+                 async_write=False,
+                 durability='always',
+                 search_tree=False):
         cdef libgsd.gsd_open_flag c_flags
+        cdef libgsd.gsd_durability c_durability
+        cdef uint64_t c_sync_interval = 0
         cdef int exclusive_create = 0
         cdef int overwrite = 0
 
@@ -304,8 +481,57 @@ cdef class GSDFile:
             raise ValueError("mode must be 'wb', 'wb+', 'rb', 'rb+', "
                              "'xb', 'xb+', or 'ab'")
 
+        if mmap and mode != 'rb':
+            raise ValueError("mmap requires mode 'rb'")
+
+        if search_tree and mode != 'rb':
+            raise ValueError("search_tree requires mode 'rb'")
+
+        if async_write and mode == 'rb':
+            raise ValueError("async_write requires a writable mode")
+
+        if durability == 'always':
+            c_durability = libgsd.GSD_DURABILITY_ALWAYS
+        elif durability == 'close':
+            c_durability = libgsd.GSD_DURABILITY_CLOSE
+        elif durability == 'never':
+            c_durability = libgsd.GSD_DURABILITY_NEVER
+        elif (isinstance(durability, int) and not isinstance(durability, bool)
+              and durability > 0):
+            c_durability = libgsd.GSD_DURABILITY_FRAMES
+            c_sync_interval = durability
+        else:
+            raise ValueError("durability must be 'always', 'close', 'never', "
+                             "or a positive number of frames")
+
+        if durability != 'always' and mode == 'rb':
+            raise ValueError("durability requires a writable mode")
+
+        self.__write_flags = libgsd.GSD_COMPRESSION_NONE
+        if compression == 'lz4':
+            self.__write_flags = libgsd.GSD_COMPRESSION_LZ4
+        elif compression is not None:
+            raise ValueError("compression must be None or 'lz4'")
+
+        if shuffle == 'byte':
+            if compression is not None:
+                self.__write_flags |= libgsd.GSD_FILTER_SHUFFLE
+        elif shuffle == 'bit':
+            if compression is not None:
+                self.__write_flags |= libgsd.GSD_FILTER_BITSHUFFLE
+        elif shuffle is not None:
+            raise ValueError("shuffle must be None, 'byte', or 'bit'")
+
         self.name = name
         self.mode = mode
+        self.mmap = mmap
+        self.compression = compression
+        self.async_write = async_write
+        self.durability = durability
+        self.search_tree = search_tree
+        self._lent_frame = []
+        self._lent_writing = []
+        self._name_ids = {}
 
         cdef char * c_name
         cdef char * c_application
@@ -357,6 +583,38 @@ cdef class GSDFile:
 
         __raise_on_error(retval, name)
 
+        if mmap:
+            with nogil:
+                retval = libgsd.gsd_map_data(&self.__handle)
+
+            if retval != libgsd.GSD_SUCCESS:
+                libgsd.gsd_close(&self.__handle)
+                __raise_on_error(retval, name)
+
+        if search_tree:
+            with nogil:
+                retval = libgsd.gsd_build_search_tree(&self.__handle)
+
+            if retval != libgsd.GSD_SUCCESS:
+                libgsd.gsd_close(&self.__handle)
+                __raise_on_error(retval, name)
+
+        if async_write:
+            with nogil:
+                retval = libgsd.gsd_set_async(&self.__handle, 1)
+
+            if retval != libgsd.GSD_SUCCESS:
+                libgsd.gsd_close(&self.__handle)
+                __raise_on_error(retval, name)
+
+        if c_durability != libgsd.GSD_DURABILITY_ALWAYS:
+            retval = libgsd.gsd_set_durability(&self.__handle, c_durability,
+                                               c_sync_interval)
+
+            if retval != libgsd.GSD_SUCCESS:
+                libgsd.gsd_close(&self.__handle)
+                __raise_on_error(retval, name)
+
         # validate schema
         if schema is not None:
             schema_truncated = schema
@@ -376,7 +634,8 @@ cdef class GSDFile:
         Once closed, any other operation on the file object will result in a
         `ValueError`. :py:meth:`close()` may be called more than once.
         The file is automatically closed when garbage collected or when
-        the context manager exits.
+        the context manager exits. When the file is memory mapped, the mapping
+        is released after the last array viewing it is freed.
 
         Example:
             .. ipython:: python
@@ -396,13 +655,103 @@ cdef class GSDFile:
 
         """
         if self.__is_open:
+            self.__is_open = False
+
+            if self._n_views > 0:
+                # arrays still view the mapping, close when they are freed
+                logger.info('deferring close of file: ' + self.name)
+                self._close_pending = True
+                return
+
             logger.info('closing file: ' + self.name)
             with nogil:
                 retval = libgsd.gsd_close(&self.__handle)
-            self.__is_open = False
 
+            self._lent_frame = []
+            self._lent_writing = []
+            self._name_ids = {}
             __raise_on_error(retval, self.name)
 
+    cdef int _intern_name(self, name, uint16_t *c_id) except -1:
+        """Find the id of a chunk name, adding it to a writable file.
+
+        Ids are cached by name to avoid encoding and hashing the name on
+        every call.
+        """
+        cdef char * c_name
+        cdef int retval
+
+        cached_id = self._name_ids.get(name)
+        if cached_id is not None:
+            c_id[0] = cached_id
+            return 0
+
+        name_e = name.encode('utf-8')
+        c_name = name_e
+        with nogil:
+            retval = libgsd.gsd_intern_name(&self.__handle, c_name, c_id)
+
+        __raise_on_error(retval, self.name)
+        self._name_ids[name] = c_id[0]
+        return 0
+
+    cdef const libgsd.gsd_index_entry* _find_chunk(self, uint64_t frame,
+                                                   name):
+        """Find a chunk by name, looking up the name id in the cache."""
+        cdef const libgsd.gsd_index_entry* index_entry
+        cdef char * c_name
+        cdef uint16_t c_id
+
+        cached_id = self._name_ids.get(name)
+        if cached_id is not None:
+            c_id = cached_id
+            with nogil:
+                index_entry = libgsd.gsd_find_chunk_id(&self.__handle,
+                                                       frame,
+                                                       c_id)
+            return index_entry
+
+        name_e = name.encode('utf-8')
+        c_name = name_e
+        with nogil:
+            index_entry = libgsd.gsd_find_chunk(&self.__handle, frame, c_name)
+
+        # names are not added when reading, cache only names in the file
+        if index_entry != NULL:
+            self._name_ids[name] = index_entry.id
+        return index_entry
+
+    cdef _chunk_view(self, const libgsd.gsd_index_entry* index_entry, dtype):
+        """Make a read-only array that views the chunk in the file mapping.
+
+        Returns None when the chunk cannot be accessed in place.
+        """
+        cdef const void *ptr
+        ptr = libgsd.gsd_chunk_pointer(&self.__handle, index_entry)
+        if ptr == NULL:
+            return None
+
+        cdef _MappedChunk buf = _MappedChunk.__new__(_MappedChunk)
+        buf.file = self
+        buf.ptr = ptr
+        buf.size = (index_entry.N * index_entry.M
+                    * libgsd.gsd_sizeof_type(<libgsd.gsd_type>index_entry.type))
+        self._n_views += 1
+
+        return numpy.frombuffer(buf, dtype=dtype).reshape([index_entry.N,
+                                                           index_entry.M])
+
+    cdef _release_view(self):
+        """Release one view of the file mapping.
+
+        Completes a deferred close after the last view is released.
+        """
+        self._n_views -= 1
+        if self._n_views == 0 and self._close_pending:
+            logger.info('closing file: ' + self.name)
+            self._close_pending = False
+            libgsd.gsd_close(&self.__handle)
+
     def truncate(self):
         """truncate()
 
@@ -440,6 +789,9 @@ cdef class GSDFile:
         with nogil:
             retval = libgsd.gsd_truncate(&self.__handle)
 
+        self._lent_frame = []
+        self._lent_writing = []
+        self._name_ids = {}
         __raise_on_error(retval, self.name)
 
     def end_frame(self):
@@ -486,10 +838,91 @@ cdef class GSDFile:
         with nogil:
             retval = libgsd.gsd_end_frame(&self.__handle)
 
+        # gsd_end_frame returns after the writer finishes the previous frame
+        if retval == libgsd.GSD_SUCCESS:
+            self._lent_writing = self._lent_frame
+        else:
+            self._lent_writing = []
+        self._lent_frame = []
         __raise_on_error(retval, self.name)
 
-    def write_chunk(self, name, data):
-        """write_chunk(name, data)
+    def flush(self):
+        """flush()
+
+        Wait for all completed frames to be written and synchronize the file
+        to disk. Chunks written since the last call to :py:meth:`end_frame()`
+        remain buffered.
+
+        Example:
+            .. ipython:: python
+
+                f = gsd.fl.open(name='file.gsd', mode='wb',
+                                application="My application",
+                                schema="My Schema", schema_version=[1,0],
+                                async_write=True)
+
+                f.write_chunk(name='chunk1',
+                              data=numpy.array([1,2,3,4], dtype=numpy.float32))
+                f.end_frame()
+                f.flush()
+                f.close()
+        """
+
+        if not self.__is_open:
+            raise ValueError("File is not open")
+
+        logger.debug('flush: ' + self.name)
+
+        with nogil:
+            retval = libgsd.gsd_flush(&self.__handle)
+
+        self._lent_writing = []
+        __raise_on_error(retval, self.name)
+
+    def reserve(self, nframes, chunks_per_frame, nbytes=0):
+        """reserve(nframes, chunks_per_frame, nbytes=0)
+
+        Reserve space in the file for frames that will be added.
+
+        Args:
+            nframes (int): Number of frames that will be added.
+            chunks_per_frame (int): Number of chunks in each frame.
+            nbytes (int): Number of bytes of chunk data that the frames will
+                add.
+
+        The file index grows by moving to the end of the file, which leaves
+        the old copy unused. Call :py:meth:`reserve()` before writing a run of
+        known length to size the index once. On Linux, :py:meth:`reserve()`
+        also allocates *nbytes* of storage for the chunk data.
+
+        Example:
+            .. ipython:: python
+
+                f = gsd.fl.open(name='file.gsd', mode='wb',
+                                application="My application",
+                                schema="My Schema", schema_version=[1,0])
+                f.reserve(nframes=1000, chunks_per_frame=2)
+                f.close()
+        """
+
+        if not self.__is_open:
+            raise ValueError("File is not open")
+        if nframes < 0 or chunks_per_frame < 0 or nbytes < 0:
+            raise ValueError("nframes, chunks_per_frame, and nbytes must not "
+                             "be negative")
+
+        cdef uint64_t c_nframes = nframes
+        cdef uint64_t c_chunks_per_frame = chunks_per_frame
+        cdef uint64_t c_nbytes = nbytes
+
+        with nogil:
+            retval = libgsd.gsd_reserve(&self.__handle, c_nframes,
+                                        c_chunks_per_frame, c_nbytes)
+
+        __raise_on_error(retval, self.name)
+
+    def write_chunk(self, name, data, lend=False):
+        """write_chunk(name, data, lend=False)
 
         Write a data chunk to the file. After writing all chunks in the
         current frame, call :py:meth:`end_frame()`.
@@ -499,6 +932,8 @@ cdef class GSDFile:
             data: Data to write into the chunk. Must be a numpy
                   array, or array-like, with 2 or fewer
                   dimensions.
+            lend (bool): Set to True to lend *data* to the background
+                  writer instead of copying it.
 
         Warning:
             :py:meth:`write_chunk()` will implicitly converts array-like and
@@ -506,6 +941,17 @@ cdef class GSDFile:
             ``numpy.ascontiguousarray(data)``. This may or may not produce
             desired data types in the output file and incurs overhead.
 
+        When the file is opened with a ``compression`` codec,
+        :py:meth:`write_chunk()` compresses the chunk before writing it.
+
+        When the file is opened with ``async_write=True`` and without
+        compression, ``lend=True`` avoids copying large chunks: the
+        background writer writes the chunk straight from *data*. The file
+        keeps a reference to *data*, and you must not modify it until the
+        frame is written, which is after the next call to
+        :py:meth:`end_frame()` that follows the one that ends the frame, or
+        after :py:meth:`flush()` or :py:meth:`close()`.
+
         Example:
             .. ipython:: python
 
@@ -588,17 +1034,234 @@ cdef class GSDFile:
 
         logger.debug('write chunk: ' + self.name + ' - ' + name)
 
+        cdef char * c_name
+        cdef uint16_t c_id
+        if lend:
+            name_e = name.encode('utf-8')
+            c_name = name_e
+            with nogil:
+                retval = libgsd.gsd_write_chunk_lent(&self.__handle,
+                                                     c_name,
+                                                     gsd_type,
+                                                     N,
+                                                     M,
+                                                     self.__write_flags,
+                                                     data_ptr,
+                                                     NULL,
+                                                     NULL)
+
+            if retval == libgsd.GSD_SUCCESS:
+                self._lent_frame.append(data_array)
+        else:
+            self._intern_name(name, &c_id)
+            with nogil:
+                retval = libgsd.gsd_write_chunk_id(&self.__handle,
+                                                   c_id,
+                                                   gsd_type,
+                                                   N,
+                                                   M,
+                                                   self.__write_flags,
+                                                   data_ptr)
+
+        __raise_on_error(retval, self.name)
+
+    def write_chunks(self, mapping, end_frame=True):
+        """write_chunks(mapping, end_frame=True)
+
+        Write many data chunks to the file and optionally end the frame.
+
+        Args:
+            mapping (dict[str, numpy.ndarray]): Data to write into each chunk,
+                by chunk name. Each value must be a numpy array, or
+                array-like, with 2 or fewer dimensions.
+            end_frame (bool): Set to True to call :py:meth:`end_frame()`
+                after writing the chunks.
+
+        :py:meth:`write_chunks()` checks all the arrays before writing any
+        chunk, and then writes the chunks and ends the frame in one call to
+        the C library without the global interpreter lock. It is faster than
+        calling :py:meth:`write_chunk()` for each chunk when a frame has many
+        small chunks. Chunks are written and compressed the same way as
+        :py:meth:`write_chunk()`.
+
+        Example:
+            .. ipython:: python
+
+                f = gsd.fl.open(name='file.gsd', mode='wb',
+                                application="My application",
+                                schema="My Schema", schema_version=[1,0])
+
+                f.write_chunks({'float1d': numpy.array([1,2,3,4],
+                                                       dtype=numpy.float32),
+                                'int1d': numpy.array([70,80,90],
+                                                     dtype=numpy.int64)})
+                f.nframes
+                f.close()
+        """
+
+        if not self.__is_open:
+            raise ValueError("File is not open")
+
+        items = list(mapping.items())
+        cdef size_t n_chunks = len(items)
+        cdef size_t i
+        cdef numpy.ndarray data_array
+        arrays = [None] * n_chunks
+        types = [None] * n_chunks
+
+        # check all chunks before writing any of them
+        for i in range(n_chunks):
+            name, data = items[i]
+            data_array = numpy.ascontiguousarray(data)
+            if data_array is not data:
+                logger.warning('implicit data copy when writing chunk: '
+                               + name)
+
+            if data_array.ndim > 2:
+                raise ValueError("GSD can only write 1 or 2 dimensional "
+                                 "arrays: " + name)
+
+            types[i] = _gsd_types.get(data_array.dtype)
+            if types[i] is None:
+                raise ValueError("invalid type for chunk: " + name)
+
+            arrays[i] = data_array
+
+        cdef __chunk_write *chunks
+        chunks = <__chunk_write *>malloc(sizeof(__chunk_write)
+                                         * max(n_chunks, 1))
+        if chunks == NULL:
+            raise MemoryError("Memory allocation failed: " + self.name)
+
+        cdef uint8_t write_flags = self.__write_flags
+        cdef bint c_end_frame = end_frame
+        cdef bint frame_ended = False
+        cdef int retval = libgsd.GSD_SUCCESS
+
+        try:
+            for i in range(n_chunks):
+                data_array = arrays[i]
+                self._intern_name(items[i][0], &chunks[i].id)
+                chunks[i].type = types[i]
+                chunks[i].N = data_array.shape[0]
+                chunks[i].M = 1
+                if data_array.ndim == 2:
+                    chunks[i].M = data_array.shape[1]
+                chunks[i].data = NULL
+                if chunks[i].N != 0 and chunks[i].M != 0:
+                    chunks[i].data = numpy.PyArray_DATA(data_array)
+
+            logger.debug('write chunks: ' + self.name)
+
+            with nogil:
+                for i in range(n_chunks):
+                    retval = libgsd.gsd_write_chunk_id(&self.__handle,
+                                                       chunks[i].id,
+                                                       chunks[i].type,
+                                                       chunks[i].N,
+                                                       chunks[i].M,
+                                                       write_flags,
+                                                       chunks[i].data)
+                    if retval != libgsd.GSD_SUCCESS:
+                        break
+
+                if retval == libgsd.GSD_SUCCESS and c_end_frame:
+                    retval = libgsd.gsd_end_frame(&self.__handle)
+                    frame_ended = True
+        finally:
+            free(chunks)
+
+        # gsd_end_frame returns after the writer finishes the previous frame
+        if frame_ended:
+            if retval == libgsd.GSD_SUCCESS:
+                self._lent_writing = self._lent_frame
+            else:
+                self._lent_writing = []
+            self._lent_frame = []
+        __raise_on_error(retval, self.name)
+
+    def write_quantized_chunk(self, name, data, precision, extent=None):
+        """write_quantized_chunk(name, data, precision, extent=None)
+
+        Write a float32 data chunk quantized to a fixed precision. After
+        writing all chunks in the current frame, call :py:meth:`end_frame()`.
+
+        Args:
+            name (str): Name of the chunk
+            data: Data to write into the chunk. Must be a numpy array, or
+                  array-like, with 2 or fewer dimensions.
+            precision (float): Distance between adjacent representable values.
+            extent: Minimum range of each column, or None. Column ``c``
+                    represents at least the range
+                    ``[-extent[c]/2, extent[c]/2]``.
+
+        :py:meth:`write_quantized_chunk()` stores each column as fixed point
+        integers with just enough bits to represent the range of the column.
+        :py:meth:`read_chunk()` returns float32 values that differ from *data*
+        by at most ``precision / 2``. When the file is opened with a
+        ``compression`` codec, the codec compresses the quantized values.
+
+        Example:
+            .. ipython:: python
+
+                f = gsd.fl.open(name='file.gsd', mode='wb',
+                                application="My application",
+                                schema="My Schema", schema_version=[1,0])
+
+                f.write_quantized_chunk(name='position',
+                                        data=[[0.1234, -1.5, 2.0]],
+                                        precision=0.01,
+                                        extent=[10, 10, 10])
+                f.end_frame()
+                f.close()
+        """
+
+        if not self.__is_open:
+            raise ValueError("File is not open")
+
+        data_array = numpy.ascontiguousarray(data, dtype=numpy.float32)
+        if data_array is not data:
+            logger.warning('implicit data copy when writing chunk: ' + name)
+        data_array = data_array.view()
+
+        if len(data_array.shape) > 2:
+            raise ValueError("GSD can only write 1 or 2 dimensional arrays: "
+                             + name)
+
+        if len(data_array.shape) == 1:
+            data_array = data_array.reshape([data_array.shape[0], 1])
+
+        cdef uint64_t N = data_array.shape[0]
+        cdef uint32_t M = data_array.shape[1]
+        cdef float *data_ptr = <float *>__get_ptr_float32(data_array)
+
+        cdef numpy.ndarray[float, ndim=1, mode="c"] extent_array
+        cdef float *extent_ptr = NULL
+        if extent is not None:
+            extent_array = numpy.ascontiguousarray(extent, dtype=numpy.float32)
+            if extent_array.shape[0] != M:
+                raise ValueError("extent must have one value per column: "
+                                 + name)
+            extent_ptr = &extent_array[0]
+
+        cdef double c_precision = precision
+        cdef uint8_t flags = (self.__write_flags
+                              & libgsd.GSD_COMPRESSION_MASK)
+
+        logger.debug('write quantized chunk: ' + self.name + ' - ' + name)
+
         cdef char * c_name
         name_e = name.encode('utf-8')
         c_name = name_e
         with nogil:
-            retval = libgsd.gsd_write_chunk(&self.__handle,
-                                            c_name,
-                                            gsd_type,
-                                            N,
-                                            M,
-                                            0,
-                                            data_ptr)
+            retval = libgsd.gsd_write_quantized_chunk(&self.__handle,
+                                                      c_name,
+                                                      N,
+                                                      M,
+                                                      flags,
+                                                      data_ptr,
+                                                      c_precision,
+                                                      extent_ptr)
 
         __raise_on_error(retval, self.name)
 
@@ -646,40 +1309,105 @@ cdef class GSDFile:
                 f.close()
         """
 
+        cdef const libgsd.gsd_index_entry* index_entry
+        cdef int64_t c_frame
+        c_frame = frame
+
+        logger.debug('chunk exists: ' + self.name + ' - ' + name)
+
+        index_entry = self._find_chunk(c_frame, name)
+        return index_entry != NULL
+
+    def find_chunk_at_or_before(self, frame, name):
+        """find_chunk_at_or_before(frame, name)
+
+        Find the latest frame up to *frame* that contains a chunk.
+
+        Args:
+            frame (int): Index of the last frame to check
+            name (str): Name of the chunk
+
+        Returns:
+            int: Index of the latest frame not after *frame* that contains
+            a chunk named *name*, or ``None`` when there is no such frame.
+
+        Use this method to read files that store quantities only in the
+        frames where they change.
+
+        Example:
+            .. ipython:: python
+
+                with gsd.fl.open(name='file.gsd', mode='wb',
+                                 application="My application",
+                                 schema="My Schema", schema_version=[1,0]) as f:
+                    f.write_chunk(name='chunk1',
+                                  data=numpy.array([1,2,3,4],
+                                                   dtype=numpy.float32))
+                    f.end_frame()
+                    f.write_chunk(name='chunk2',
+                                  data=numpy.array([5,6],
+                                                   dtype=numpy.float32))
+                    f.end_frame()
+
+                f = gsd.fl.open(name='file.gsd', mode='rb')
+                f.find_chunk_at_or_before(frame=1, name='chunk1')
+                f.find_chunk_at_or_before(frame=0, name='chunk2')
+                f.close()
+        """
+
+        if not self.__is_open:
+            raise ValueError("File is not open")
+
         cdef const libgsd.gsd_index_entry* index_entry
         cdef char * c_name
         name_e = name.encode('utf-8')
         c_name = name_e
         cdef int64_t c_frame
         c_frame = frame
-
-        logger.debug('chunk exists: ' + self.name + ' - ' + name)
+        if c_frame < 0:
+            raise ValueError("frame must be non-negative")
 
         with nogil:
-            index_entry = libgsd.gsd_find_chunk(&self.__handle, c_frame, c_name)
+            index_entry = libgsd.gsd_find_chunk_at_or_before(&self.__handle,
+                                                             c_frame,
+                                                             c_name)
 
-        return index_entry != NULL
+        if index_entry == NULL:
+            return None
+        return index_entry.frame
 
-    def read_chunk(self, frame, name):
-        """read_chunk(frame, name)
+    def read_chunk(self, frame, name, out=None):
+        """read_chunk(frame, name, out=None)
 
         Read a data chunk from the file and return it as a numpy array.
 
         Args:
             frame (int): Index of the frame to read
             name (str): Name of the chunk
+            out (numpy.ndarray): Array to read the data into. Must be C
+                contiguous and writeable, and have the type and shape of the
+                returned array.
 
         Returns:
             ``numpy.ndarray[type, ndim=?, mode='c']``: Data read from file.
             ``type`` is determined by the chunk metadata. If the data is
             NxM in the file and M > 1, return a 2D array. If the data is
-            Nx1, return a 1D array.
+            Nx1, return a 1D array. Returns *out* when it is given.
+
+        Raises:
+            ValueError: When *out* does not have the type and shape of the
+                chunk.
 
         .. tip::
             Each call invokes a disk read and allocation of a
             new numpy array for storage. To avoid overhead, don't call
             :py:meth:`read_chunk()` on the same chunk repeatedly. Cache the
-            arrays instead.
+            arrays instead. When reading the same chunk from many frames,
+            pass the array read from a previous frame in ``out`` to reuse it.
+
+        When the file is opened with ``mmap=True``, :py:meth:`read_chunk()`
+        returns a read-only array that views the file mapping and does not
+        copy the data.
 
         Example:
             .. ipython:: python
@@ -716,15 +1444,10 @@ cdef class GSDFile:
             raise ValueError("File is not open")
 
         cdef const libgsd.gsd_index_entry* index_entry
-        cdef char * c_name
-        name_e = name.encode('utf-8')
-        c_name = name_e
         cdef int64_t c_frame
         c_frame = frame
 
-        with nogil:
-            index_entry = libgsd.gsd_find_chunk(&self.__handle, c_frame, c_name)
-
+        index_entry = self._find_chunk(c_frame, name)
         if index_entry == NULL:
             raise KeyError("frame " + str(frame) + " / chunk " + name
                            + " not found in: " + self.name)
@@ -732,80 +1455,325 @@ cdef class GSDFile:
         cdef libgsd.gsd_type gsd_type
         gsd_type = <libgsd.gsd_type>index_entry.type
 
-        cdef void *data_ptr
-        if gsd_type == libgsd.GSD_TYPE_UINT8:
-            data_array = numpy.empty(dtype=numpy.uint8,
-                                     shape=[index_entry.N, index_entry.M])
-        elif gsd_type == libgsd.GSD_TYPE_UINT16:
-            data_array = numpy.empty(dtype=numpy.uint16,
-                                     shape=[index_entry.N, index_entry.M])
-        elif gsd_type == libgsd.GSD_TYPE_UINT32:
-            data_array = numpy.empty(dtype=numpy.uint32,
-                                     shape=[index_entry.N, index_entry.M])
-        elif gsd_type == libgsd.GSD_TYPE_UINT64:
-            data_array = numpy.empty(dtype=numpy.uint64,
-                                     shape=[index_entry.N, index_entry.M])
-        elif gsd_type == libgsd.GSD_TYPE_INT8:
-            data_array = numpy.empty(dtype=numpy.int8,
-                                     shape=[index_entry.N, index_entry.M])
-        elif gsd_type == libgsd.GSD_TYPE_INT16:
-            data_array = numpy.empty(dtype=numpy.int16,
-                                     shape=[index_entry.N, index_entry.M])
-        elif gsd_type == libgsd.GSD_TYPE_INT32:
-            data_array = numpy.empty(dtype=numpy.int32,
-                                     shape=[index_entry.N, index_entry.M])
-        elif gsd_type == libgsd.GSD_TYPE_INT64:
-            data_array = numpy.empty(dtype=numpy.int64,
-                                     shape=[index_entry.N, index_entry.M])
-        elif gsd_type == libgsd.GSD_TYPE_FLOAT:
-            data_array = numpy.empty(dtype=numpy.float32,
-                                     shape=[index_entry.N, index_entry.M])
-        elif gsd_type == libgsd.GSD_TYPE_DOUBLE:
-            data_array = numpy.empty(dtype=numpy.float64,
-                                     shape=[index_entry.N, index_entry.M])
-        else:
+        dtype = __chunk_dtype(gsd_type)
+        if dtype is None:
             raise ValueError("invalid type for chunk: " + name)
 
         logger.debug('read chunk: ' + self.name + ' - '
                      + str(frame) + ' - ' + name)
 
-        # only read chunk if we have data
-        if index_entry.N != 0 and index_entry.M != 0:
-            if gsd_type == libgsd.GSD_TYPE_UINT8:
-                data_ptr = __get_ptr_uint8(data_array)
-            elif gsd_type == libgsd.GSD_TYPE_UINT16:
-                data_ptr = __get_ptr_uint16(data_array)
-            elif gsd_type == libgsd.GSD_TYPE_UINT32:
-                data_ptr = __get_ptr_uint32(data_array)
-            elif gsd_type == libgsd.GSD_TYPE_UINT64:
-                data_ptr = __get_ptr_uint64(data_array)
-            elif gsd_type == libgsd.GSD_TYPE_INT8:
-                data_ptr = __get_ptr_int8(data_array)
-            elif gsd_type == libgsd.GSD_TYPE_INT16:
-                data_ptr = __get_ptr_int16(data_array)
-            elif gsd_type == libgsd.GSD_TYPE_INT32:
-                data_ptr = __get_ptr_int32(data_array)
-            elif gsd_type == libgsd.GSD_TYPE_INT64:
-                data_ptr = __get_ptr_int64(data_array)
-            elif gsd_type == libgsd.GSD_TYPE_FLOAT:
-                data_ptr = __get_ptr_float32(data_array)
-            elif gsd_type == libgsd.GSD_TYPE_DOUBLE:
-                data_ptr = __get_ptr_float64(data_array)
+        cdef void *data_ptr
+        if out is not None:
+            if index_entry.M == 1:
+                shape = (index_entry.N,)
             else:
-                raise ValueError("invalid type for chunk: " + name)
+                shape = (index_entry.N, index_entry.M)
 
-            with nogil:
-                retval = libgsd.gsd_read_chunk(&self.__handle,
-                                               data_ptr,
-                                               index_entry)
+            if (not isinstance(out, numpy.ndarray) or out.dtype != dtype
+                    or out.shape != shape):
+                raise ValueError("out must be an array with dtype "
+                                 + numpy.dtype(dtype).name + " and shape "
+                                 + str(shape) + " to read chunk: " + name)
+            if not out.flags.c_contiguous or not out.flags.writeable:
+                raise ValueError("out must be C contiguous and writeable")
 
-            __raise_on_error(retval, self.name)
+            if index_entry.N != 0 and index_entry.M != 0:
+                data_ptr = __get_ptr(out.reshape([index_entry.N,
+                                                  index_entry.M]), gsd_type)
+
+                with nogil:
+                    retval = libgsd.gsd_read_chunk_into(&self.__handle,
+                                                        data_ptr,
+                                                        gsd_type,
+                                                        index_entry.N,
+                                                        index_entry.M,
+                                                        index_entry)
+
+                __raise_on_error(retval, self.name)
+
+            return out
+
+        data_array = None
+        if self.mmap:
+            data_array = self._chunk_view(index_entry, dtype)
+
+        # only read chunk if we have data
+        if data_array is None:
+            data_array = numpy.empty(dtype=dtype,
+                                     shape=[index_entry.N, index_entry.M])
+
+            if index_entry.N != 0 and index_entry.M != 0:
+                data_ptr = __get_ptr(data_array, gsd_type)
+
+                with nogil:
+                    retval = libgsd.gsd_read_chunk(&self.__handle,
+                                                   data_ptr,
+                                                   index_entry)
+
+                __raise_on_error(retval, self.name)
 
         if index_entry.M == 1:
             return data_array.reshape([index_entry.N])
         else:
             return data_array
 
+    def read_chunks(self, frame, names):
+        """read_chunks(frame, names)
+
+        Read many data chunks from one frame of the file.
+
+        Args:
+            frame (int): Index of the frame to read
+            names (typing.List[str]): Names of the chunks
+
+        Returns:
+            typing.Dict[str, numpy.ndarray]: Data read from the file for each
+            name in *names* that is present in the frame. Array shapes and
+            types follow the same rules as :py:meth:`read_chunk()`.
+
+        :py:meth:`read_chunks()` reads the chunks in the order they are
+        stored in the file and merges reads of neighboring chunks. It is
+        faster than calling :py:meth:`read_chunk()` for each name.
+
+        Example:
+            .. ipython:: python
+
+                with gsd.fl.open(name='file.gsd', mode='wb',
+                                 application="My application",
+                                 schema="My Schema", schema_version=[1,0]) as f:
+                    f.write_chunk(name='chunk1',
+                                  data=numpy.array([1,2,3,4],
+                                                   dtype=numpy.float32))
+                    f.write_chunk(name='chunk2',
+                                  data=numpy.array([[5,6],[7,8]],
+                                                   dtype=numpy.float32))
+                    f.end_frame()
+
+                f = gsd.fl.open(name='file.gsd', mode='rb')
+                f.read_chunks(frame=0, names=['chunk1', 'chunk2', 'chunk3'])
+                f.close()
+        """
+
+        if not self.__is_open:
+            raise ValueError("File is not open")
+
+        names = list(names)
+        cdef size_t n_requests = len(names)
+        cdef libgsd.gsd_chunk_request *requests
+        requests = <libgsd.gsd_chunk_request *>malloc(
+            sizeof(libgsd.gsd_chunk_request) * max(n_requests, 1))
+        cdef const char **c_names
+        c_names = <const char **>malloc(sizeof(char *) * max(n_requests, 1))
+        cdef const libgsd.gsd_index_entry **chunks
+        chunks = <const libgsd.gsd_index_entry **>malloc(
+            sizeof(libgsd.gsd_index_entry *) * max(n_requests, 1))
+        if requests == NULL or c_names == NULL or chunks == NULL:
+            free(requests)
+            free(c_names)
+            free(chunks)
+            raise MemoryError("Memory allocation failed: " + self.name)
+
+        cdef uint64_t c_frame = frame
+        cdef const libgsd.gsd_index_entry* index_entry
+        cdef libgsd.gsd_type gsd_type
+        cdef numpy.ndarray data_array
+        cdef size_t i
+        cdef size_t n_found = 0
+        names_e = [name.encode('utf-8') for name in names]
+        arrays = [None] * n_requests
+
+        logger.debug('read chunks: ' + self.name + ' - ' + str(frame))
+
+        try:
+            # find all the chunks in one pass over the frame
+            for i in range(n_requests):
+                c_names[i] = names_e[i]
+
+            with nogil:
+                retval = libgsd.gsd_find_chunks(&self.__handle,
+                                                c_frame,
+                                                c_names,
+                                                n_requests,
+                                                chunks)
+
+            __raise_on_error(retval, self.name)
+
+            for i in range(n_requests):
+                requests[i].frame = c_frame
+                requests[i].name = c_names[i]
+                requests[i].data = NULL
+                requests[i].chunk = chunks[i]
+
+                index_entry = requests[i].chunk
+                if index_entry == NULL:
+                    continue
+                n_found += 1
+
+                gsd_type = <libgsd.gsd_type>index_entry.type
+                dtype = __chunk_dtype(gsd_type)
+                if dtype is None:
+                    raise ValueError("invalid type for chunk: " + names[i])
+                if self.mmap:
+                    arrays[i] = self._chunk_view(index_entry, dtype)
+                    if arrays[i] is not None:
+                        continue
+
+                data_array = numpy.empty(dtype=dtype,
+                                         shape=[index_entry.N, index_entry.M])
+                arrays[i] = data_array
+                if index_entry.N != 0:
+                    requests[i].data = numpy.PyArray_DATA(data_array)
+
+            # there is nothing to read when the frame has none of the chunks
+            if n_found > 0:
+                with nogil:
+                    retval = libgsd.gsd_read_chunks(&self.__handle,
+                                                    requests,
+                                                    n_requests)
+
+                __raise_on_error(retval, self.name)
+
+            result = {}
+            for i in range(n_requests):
+                if arrays[i] is None:
+                    continue
+
+                index_entry = requests[i].chunk
+                if index_entry.M == 1:
+                    result[names[i]] = arrays[i].reshape([index_entry.N])
+                else:
+                    result[names[i]] = arrays[i]
+        finally:
+            free(requests)
+            free(c_names)
+            free(chunks)
+
+        return result
+
+    def read_series(self, name, start=0, stop=None, step=1, out=None):
+        """read_series(name, start=0, stop=None, step=1, out=None)
+
+        Read one data chunk from a series of frames into a single array.
+
+        Args:
+            name (str): Name of the chunk
+            start (int): First frame to read
+            stop (int): Read frames before *stop* (``None`` reads to the end
+                of the file)
+            step (int): Read every *step*-th frame
+            out (numpy.ndarray): Array to read the data into. Must be C
+                contiguous and writeable, and have the type and shape of the
+                returned array.
+
+        Returns:
+            ``numpy.ndarray[type, ndim=?, mode='c']``: Data read from file
+            with one row for each frame in ``range(start, stop, step)``. If the
+            data is NxM in the file and M > 1, return a 3D array. If the data
+            is Nx1, return a 2D array. Returns *out* when it is given.
+
+        Raises:
+            KeyError: When the first frame does not have the chunk.
+            ValueError: When a frame does not have the chunk with the type and
+                shape of the first frame, or *out* does not have the type and
+                shape of the result.
+
+        *start* and *stop* are interpreted like the bounds of a `slice`. Every
+        frame in the series must store the chunk with the same type and shape.
+        :py:meth:`read_series()` reads the chunks of all frames in file order
+        with one call to the C library, which is much faster than calling
+        :py:meth:`read_chunk()` for each frame.
+
+        Example:
+            .. ipython:: python
+
+                with gsd.fl.open(name='file.gsd', mode='wb',
+                                 application="My application",
+                                 schema="My Schema", schema_version=[1,0]) as f:
+                    for i in range(4):
+                        f.write_chunk(name='chunk1',
+                                      data=numpy.array([i, i + 1],
+                                                       dtype=numpy.float32))
+                        f.end_frame()
+
+                f = gsd.fl.open(name='file.gsd', mode='rb')
+                f.read_series(name='chunk1')
+                f.read_series(name='chunk1', start=1, step=2)
+                f.close()
+        """
+
+        if not self.__is_open:
+            raise ValueError("File is not open")
+
+        if step < 1:
+            raise ValueError("step must be positive")
+
+        frames = range(*slice(start, stop, step).indices(self.nframes))
+        if len(frames) == 0:
+            raise ValueError("No frames to read chunk " + name + " from: "
+                             + self.name)
+
+        cdef const libgsd.gsd_index_entry* index_entry
+        index_entry = self._find_chunk(frames[0], name)
+        if index_entry == NULL:
+            raise KeyError("frame " + str(frames[0]) + " / chunk " + name
+                           + " not found in: " + self.name)
+
+        cdef libgsd.gsd_type gsd_type
+        gsd_type = <libgsd.gsd_type>index_entry.type
+
+        dtype = __chunk_dtype(gsd_type)
+        if dtype is None:
+            raise ValueError("invalid type for chunk: " + name)
+
+        cdef uint64_t N = index_entry.N
+        cdef uint32_t M = index_entry.M
+        if M == 1:
+            shape = (len(frames), N)
+        else:
+            shape = (len(frames), N, M)
+
+        logger.debug('read series: ' + self.name + ' - ' + name + ' - '
+                     + str(frames))
+
+        cdef numpy.ndarray data_array
+        if out is not None:
+            if (not isinstance(out, numpy.ndarray) or out.dtype != dtype
+                    or out.shape != shape):
+                raise ValueError("out must be an array with dtype "
+                                 + numpy.dtype(dtype).name + " and shape "
+                                 + str(shape) + " to read chunk: " + name)
+            if not out.flags.c_contiguous or not out.flags.writeable:
+                raise ValueError("out must be C contiguous and writeable")
+            data_array = out
+        else:
+            data_array = numpy.empty(dtype=dtype, shape=shape)
+
+        name_e = name.encode('utf-8')
+        cdef char *c_name = name_e
+        cdef uint64_t c_start = frames.start
+        cdef uint64_t c_stop = frames.stop
+        cdef uint64_t c_step = frames.step
+        cdef void *data_ptr = numpy.PyArray_DATA(data_array)
+
+        with nogil:
+            retval = libgsd.gsd_read_chunk_series(&self.__handle,
+                                                  c_name,
+                                                  c_start,
+                                                  c_stop,
+                                                  c_step,
+                                                  gsd_type,
+                                                  N,
+                                                  M,
+                                                  data_ptr)
+
+        if retval == libgsd.GSD_ERROR_INVALID_ARGUMENT:
+            raise ValueError("chunk " + name + " is not present with the same "
+                             "type and shape in all frames " + str(frames)
+                             + " of: " + self.name)
+        __raise_on_error(retval, self.name)
+
+        return data_array
+
     def find_matching_chunk_names(self, match):
         """find_matching_chunk_names(match)
 
@@ -852,27 +1820,42 @@ cdef class GSDFile:
         if not self.__is_open:
             raise ValueError("File is not open")
 
-        cdef const char * c_found
         cdef char * c_match
         match_e = match.encode('utf-8')
         c_match = match_e
 
-        retval = []
-
+        # count the matches, then read them all in one call
+        cdef size_t n_found = 0
+        cdef int retval
         with nogil:
-            c_found = libgsd.gsd_find_matching_chunk_name(&self.__handle,
+            retval = libgsd.gsd_find_matching_chunk_names(&self.__handle,
                                                           c_match,
-                                                          NULL)
+                                                          NULL,
+                                                          &n_found)
+        __raise_on_error(retval, self.name)
 
-        while c_found != NULL:
-            retval.append(c_found.decode('utf-8'))
+        if n_found == 0:
+            return []
 
+        cdef size_t n_names = n_found
+        cdef const char **c_names
+        c_names = <const char **>malloc(sizeof(char *) * n_names)
+        if c_names == NULL:
+            raise MemoryError("Memory allocation failed: " + self.name)
+
+        cdef size_t i
+        try:
             with nogil:
-                c_found = libgsd.gsd_find_matching_chunk_name(&self.__handle,
+                retval = libgsd.gsd_find_matching_chunk_names(&self.__handle,
                                                               c_match,
-                                                              c_found)
+                                                              c_names,
+                                                              &n_found)
+            __raise_on_error(retval, self.name)
 
-        return retval
+            return [c_names[i].decode('utf-8')
+                    for i in range(min(n_names, n_found))]
+        finally:
+            free(c_names)
 
     def upgrade(self):
         """upgrade()
@@ -890,6 +1873,7 @@ cdef class GSDFile:
         with nogil:
             retval = libgsd.gsd_upgrade(&self.__handle)
 
+        self._name_ids = {}
         __raise_on_error(retval, self.name)
 
     def __enter__(self):
@@ -904,7 +1888,8 @@ cdef class GSDFile:
             raise PickleError("Only read only GSDFiles can be pickled.")
         return (GSDFile,
                 (self.name, self.mode, self.application,
-                    self.schema, self.schema_version),
+                    self.schema, self.schema_version, self.mmap,
+                    None, 'byte', False, 'always', self.search_tree),
                 )
 
     property name:
@@ -915,6 +1900,26 @@ cdef class GSDFile:
         def __get__(self):
             return self.mode
 
+    property mmap:
+        def __get__(self):
+            return self.mmap
+
+    property compression:
+        def __get__(self):
+            return self.compression
+
+    property async_write:
+        def __get__(self):
+            return self.async_write
+
+    property durability:
+        def __get__(self):
+            return self.durability
+
+    property search_tree:
+        def __get__(self):
+            return self.search_tree
+
     property gsd_version:
         def __get__(self):
             cdef uint32_t v = self.__handle.header.gsd_version
@@ -941,7 +1946,30 @@ cdef class GSDFile:
             return libgsd.gsd_get_nframes(&self.__handle)
 
     def __dealloc__(self):
-        if self.__is_open:
+        if self.__is_open or self._close_pending:
             logger.info('closing file: ' + self.name)
             libgsd.gsd_close(&self.__handle)
             self.__is_open = False
+            self._close_pending = False
+
+
+cdef class _MappedChunk:
+    """Read-only buffer over one chunk in a memory mapped file.
+
+    Holds a reference to the :py:class:`GSDFile` so that the mapping remains
+    valid while any array views this buffer.
+    """
+
+    cdef GSDFile file
+    cdef const void *ptr
+    cdef Py_ssize_t size
+
+    def __getbuffer__(self, Py_buffer *buffer, int flags):
+        PyBuffer_FillInfo(buffer, self, <void *>self.ptr, self.size, 1, flags)
+
+    def __releasebuffer__(self, Py_buffer *buffer):
+        pass
+
+    def __dealloc__(self):
+        if self.file is not None:
+            self.file._release_view()
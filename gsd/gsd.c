@@ -2,6 +2,11 @@
 // This file is part of the General Simulation Data (GSD) project, released under the BSD 2-Clause
 // License.
 
+#ifdef __linux__
+// fallocate() preallocates space without changing the file size
+#define _GNU_SOURCE
+#endif
+
 #include <sys/stat.h>
 #ifdef _WIN32
 
@@ -9,21 +14,57 @@
 #pragma warning(disable : 4996)
 
 #define GSD_USE_MMAP 0
+#define GSD_USE_THREADS 0
 #include <io.h>
 
 #else // linux / mac
 
+#ifndef _XOPEN_SOURCE
 #define _XOPEN_SOURCE 500
+#endif
+#include <pthread.h>
 #include <sys/mman.h>
 #include <unistd.h>
 #define GSD_USE_MMAP 1
+#define GSD_USE_THREADS 1
 
 #endif
 
-#ifdef __APPLE__
-#include <limits.h>
+#ifdef __linux__
+#include <sys/uio.h>
+#define GSD_USE_PREADV 1
+#define GSD_USE_FALLOCATE 1
+#else
+#define GSD_USE_PREADV 0
+#define GSD_USE_FALLOCATE 0
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define GSD_USE_SSE2 1
+#else
+#define GSD_USE_SSE2 0
 #endif
 
+// AVX2 kernels are compiled with target attributes and selected at runtime
+#if GSD_USE_SSE2 && (defined(__GNUC__) || defined(__clang__)) \
+    && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define GSD_USE_AVX2 1
+#else
+#define GSD_USE_AVX2 0
+#endif
+
+// hint that the memory at an address will be read soon
+#if defined(__GNUC__) || defined(__clang__)
+#define GSD_PREFETCH(address) __builtin_prefetch((const void*)(address))
+#else
+#define GSD_PREFETCH(address)
+#endif
+
+#include <float.h>
+#include <limits.h>
+
 #include <errno.h>
 #include <fcntl.h>
 #include <stddef.h>
@@ -69,10 +110,46 @@ enum
     GSD_COPY_BUFFER_SIZE = 128 * 1024
     };
 
-/// Size of hash map
+/// Largest gap between chunks that gsd_read_chunks() reads through to merge two reads
+enum
+    {
+    GSD_READ_MERGE_GAP = 4096
+    };
+
+/// Maximum number of buffers passed to one vectored read (the Linux IOV_MAX)
+enum
+    {
+    GSD_READ_MAX_IOV = 1024
+    };
+
+/// Largest number of bits in one quantized value
+enum
+    {
+    GSD_QUANTIZE_MAX_BITS = 32
+    };
+
+/// Smallest number of slots in the name/id map
+enum
+    {
+    GSD_NAME_MAP_MIN_SIZE = 64
+    };
+
+/// Initial number of bytes allocated for the names in the name/id map
 enum
     {
-    GSD_NAME_MAP_SIZE = 57557
+    GSD_NAME_MAP_INITIAL_NAMES_SIZE = 1024
+    };
+
+/// Largest number of new names inserted one at a time into the sorted name directory
+enum
+    {
+    GSD_NAME_DIRECTORY_MAX_INSERT = 16
+    };
+
+/// Number of file index entries per sample in the search tree (one page of entries)
+enum
+    {
+    GSD_SEARCH_TREE_STRIDE = 128
     };
 
 /// Current GSD file specification
@@ -222,1958 +299,5824 @@ inline static ssize_t gsd_io_pread_retry(int fd, void* buf, size_t count, int64_
     }
 
 /** @internal
-    @brief Allocate a name/id map
+    @brief Synchronize the contents of a file to the storage device
 
-    @param map Map to allocate.
-    @param size Number of entries in the map.
+    GSD readers need the file data and size, but not its modification times, so fdatasync() is
+    sufficient where it is available.
 
-    @returns GSD_SUCCESS on success, GSD_* error codes on error.
+    @param fd File descriptor.
+
+    @returns GSD_SUCCESS on success, GSD_ERROR_IO on failure.
 */
-inline static int gsd_name_id_map_allocate(struct gsd_name_id_map* map, size_t size)
+inline static int gsd_io_sync(int fd)
     {
-    if (map == NULL || map->v || size == 0 || map->size != 0)
-        {
-        return GSD_ERROR_INVALID_ARGUMENT;
-        }
-
-    map->v = calloc(size, sizeof(struct gsd_name_id_pair));
-    if (map->v == NULL)
+#ifdef __linux__
+    int retval = fdatasync(fd);
+#else
+    int retval = fsync(fd);
+#endif
+    if (retval != 0)
         {
-        return GSD_ERROR_MEMORY_ALLOCATION_FAILED;
+        return GSD_ERROR_IO;
         }
-
-    map->size = size;
-
     return GSD_SUCCESS;
     }
 
 /** @internal
-    @brief Free a name/id map
+    @brief Allocate storage for a range of the file that is past the end of the file
 
-    @param map Map to free.
+    Extends the file to cover the range, which reads as zeros.
 
-    @returns GSD_SUCCESS on success, GSD_* error codes on error.
+    @param fd File descriptor.
+    @param offset Start of the range.
+    @param len Length of the range in bytes.
+
+    @returns GSD_SUCCESS when the storage was allocated, GSD_ERROR_IO when the caller must write
+    the zeros instead.
 */
-inline static int gsd_name_id_map_free(struct gsd_name_id_map* map)
+inline static int gsd_io_allocate(int fd, int64_t offset, size_t len)
     {
-    if (map == NULL || map->v == NULL || map->size == 0)
+#if GSD_USE_FALLOCATE
+    if (len > 0 && posix_fallocate(fd, offset, (off_t)len) == 0)
         {
-        return GSD_ERROR_INVALID_ARGUMENT;
-        }
-
-    // free all of the linked lists
-    size_t i;
-    for (i = 0; i < map->size; i++)
-        {
-        free(map->v[i].name);
-
-        struct gsd_name_id_pair* cur = map->v[i].next;
-        while (cur != NULL)
-            {
-            struct gsd_name_id_pair* prev = cur;
-            cur = cur->next;
-            free(prev->name);
-            free(prev);
-            }
+        return GSD_SUCCESS;
         }
-
-    // free the main map
-    free(map->v);
-
-    map->v = 0;
-    map->size = 0;
-
-    return GSD_SUCCESS;
+#else
+    (void)fd;
+    (void)offset;
+    (void)len;
+#endif
+    return GSD_ERROR_IO;
     }
 
 /** @internal
-    @brief Hash a string
+    @brief Synchronize the file around an update of the file header
 
-    @param str String to hash
+    @param handle Handle to the open gsd file.
 
-    @returns Hashed value of the string.
+    @returns GSD_SUCCESS on success, GSD_ERROR_IO on failure.
 */
-inline static unsigned long gsd_hash_str(const unsigned char* str)
+inline static int gsd_sync_header_update(struct gsd_handle* handle)
     {
-    unsigned long hash = 5381; // NOLINT
-    int c;
-
-    while ((c = *str++))
+    if (handle->durability != GSD_DURABILITY_ALWAYS)
         {
-        hash = ((hash << 5) + hash) + c; /* hash * 33 + c NOLINT */
+        return GSD_SUCCESS;
         }
-
-    return hash;
+    return gsd_io_sync(handle->fd);
     }
 
 /** @internal
-    @brief Insert a string into a name/id map
+    @brief Synchronize the file after a frame is written when the durability policy requires it
 
-    @param map Map to insert into.
-    @param str String to insert.
-    @param id ID to associate with the string.
+    @param handle Handle to the open gsd file.
 
-    @returns GSD_SUCCESS on success, GSD_* error codes on error.
+    @returns GSD_SUCCESS on success, GSD_ERROR_IO on failure.
 */
-inline static int gsd_name_id_map_insert(struct gsd_name_id_map* map, const char* str, uint16_t id)
+inline static int gsd_sync_frame(struct gsd_handle* handle)
     {
-    if (map == NULL || map->v == NULL || map->size == 0)
+    if (handle->durability != GSD_DURABILITY_FRAMES)
         {
-        return GSD_ERROR_INVALID_ARGUMENT;
+        return GSD_SUCCESS;
         }
 
-    size_t hash = gsd_hash_str((const unsigned char*)str) % map->size;
-
-    // base case: no conflict
-    if (map->v[hash].name == NULL)
-        {
-        map->v[hash].name = calloc(strlen(str) + 1, sizeof(char));
-        if (map->v[hash].name == NULL)
-            {
-            return GSD_ERROR_MEMORY_ALLOCATION_FAILED;
-            }
-        memcpy(map->v[hash].name, str, strlen(str) + 1);
-        map->v[hash].id = id;
-        map->v[hash].next = NULL;
-        }
-    else
+    handle->unsynced_frames++;
+    if (handle->unsynced_frames < handle->sync_interval)
         {
-        // go to the end of the conflict list
-        struct gsd_name_id_pair* insert_point = map->v + hash;
-
-        while (insert_point->next != NULL)
-            {
-            insert_point = insert_point->next;
-            }
-
-        // allocate and insert a new entry
-        insert_point->next = malloc(sizeof(struct gsd_name_id_pair));
-        if (insert_point->next == NULL)
-            {
-            return GSD_ERROR_MEMORY_ALLOCATION_FAILED;
-            }
-
-        insert_point->next->name = calloc(strlen(str) + 1, sizeof(char));
-        if (insert_point->next->name == NULL)
-            {
-            return GSD_ERROR_MEMORY_ALLOCATION_FAILED;
-            }
-        memcpy(insert_point->next->name, str, strlen(str) + 1);
-        insert_point->next->id = id;
-        insert_point->next->next = NULL;
+        return GSD_SUCCESS;
         }
 
-    return GSD_SUCCESS;
+    handle->unsynced_frames = 0;
+    return gsd_io_sync(handle->fd);
     }
 
+#if GSD_USE_PREADV
 /** @internal
-    @brief Find an ID in a name/id mapping
+    @brief Read a contiguous range of the file into many buffers
 
-    @param map Map to search.
-    @param str String to search.
+    The system call preadv() may read fewer bytes than requested. This method calls preadv() as
+    many times as necessary to completely fill all the buffers.
 
-    @returns The ID if found, or UINT16_MAX if not found.
+    @param fd File descriptor.
+    @param iov Buffers to fill (modified).
+    @param iovcnt Number of buffers in *iov*.
+    @param offset Location in the file to start reading.
+
+    @returns The total number of bytes read or a negative value on error.
 */
-inline static uint16_t gsd_name_id_map_find(struct gsd_name_id_map* map, const char* str)
+inline static ssize_t gsd_io_preadv_retry(int fd, struct iovec* iov, int iovcnt, int64_t offset)
     {
-    if (map == NULL || map->v == NULL || map->size == 0)
+    size_t total_bytes_read = 0;
+
+    while (iovcnt > 0)
         {
-        return UINT16_MAX;
-        }
+        errno = 0;
+        ssize_t bytes_read = preadv(fd, iov, iovcnt, offset + total_bytes_read);
+        if (bytes_read == -1 || (bytes_read == 0 && errno != 0))
+            {
+            return GSD_ERROR_IO;
+            }
 
-    size_t hash = gsd_hash_str((const unsigned char*)str) % map->size;
+        // handle end of file
+        if (bytes_read == 0)
+            {
+            return total_bytes_read;
+            }
 
-    struct gsd_name_id_pair* cur = map->v + hash;
+        total_bytes_read += bytes_read;
 
-    while (cur != NULL)
-        {
-        if (cur->name == NULL)
+        // skip the buffers that are full and advance into the partially filled one
+        size_t remaining = bytes_read;
+        while (iovcnt > 0 && remaining >= iov->iov_len)
             {
-            // not found
-            return UINT16_MAX;
+            remaining -= iov->iov_len;
+            iov++;
+            iovcnt--;
             }
 
-        if (strcmp(str, cur->name) == 0)
+        if (iovcnt > 0)
             {
-            // found
-            return cur->id;
+            iov->iov_base = (char*)iov->iov_base + remaining;
+            iov->iov_len -= remaining;
             }
-
-        // keep looking
-        cur = cur->next;
         }
 
-    // not found in any conflict
-    return UINT16_MAX;
+    return total_bytes_read;
     }
+#endif
 
 /** @internal
-    @brief Utility function to validate index entry
-    @param handle handle to the open gsd file
-    @param idx index of entry to validate
+    @brief Allocate a name/id map
 
-    @returns 1 if the entry is valid, 0 if it is not
+    @param map Map to allocate.
+    @param n_names Number of names that the map should hold without growing.
+
+    @returns GSD_SUCCESS on success, GSD_* error codes on error.
 */
-inline static int gsd_is_entry_valid(struct gsd_handle* handle, size_t idx)
+inline static int gsd_name_id_map_allocate(struct gsd_name_id_map* map, size_t n_names)
     {
-    const struct gsd_index_entry entry = handle->file_index.data[idx];
-
-    // check for valid type
-    if (gsd_sizeof_type((enum gsd_type)entry.type) == 0)
+    if (map == NULL || map->v || map->size != 0)
         {
-        return 0;
+        return GSD_ERROR_INVALID_ARGUMENT;
         }
 
-    // validate that we don't read past the end of the file
-    size_t size = entry.N * entry.M * gsd_sizeof_type((enum gsd_type)entry.type);
-    if ((entry.location + size) > (uint64_t)handle->file_size)
+    // files hold at most UINT16_MAX names
+    if (n_names > UINT16_MAX)
         {
-        return 0;
+        n_names = UINT16_MAX;
         }
 
-    // check for valid frame (frame cannot be more than the number of index entries)
-    if (entry.frame >= handle->header.index_allocated_entries)
+    // keep the load factor at or below 1/2
+    size_t size = GSD_NAME_MAP_MIN_SIZE;
+    while (size < n_names * 2)
         {
-        return 0;
+        size *= 2;
         }
 
-    // check for valid id
-    if (entry.id >= (handle->file_names.n_names + handle->frame_names.n_names))
+    map->v = malloc(sizeof(struct gsd_name_id_pair) * size);
+    map->names = malloc(GSD_NAME_MAP_INITIAL_NAMES_SIZE);
+    // the load factor limits the number of names to half the slots
+    map->sorted = malloc(sizeof(struct gsd_name_id_pair) * (size / 2));
+    if (map->v == NULL || map->names == NULL || map->sorted == NULL)
         {
-        return 0;
+        free(map->v);
+        free(map->names);
+        free(map->sorted);
+        gsd_util_zero_memory(map, sizeof(struct gsd_name_id_map));
+        return GSD_ERROR_MEMORY_ALLOCATION_FAILED;
         }
 
-    // check for valid flags
-    if (entry.flags != 0)
+    size_t i;
+    for (i = 0; i < size; i++)
         {
-        return 0;
+        map->v[i].id = UINT16_MAX;
         }
 
-    return 1;
+    map->size = size;
+    map->n_names = 0;
+    map->names_size = 0;
+    map->names_reserved = GSD_NAME_MAP_INITIAL_NAMES_SIZE;
+    map->n_sorted = 0;
+
+    return GSD_SUCCESS;
     }
 
 /** @internal
-    @brief Allocate a write buffer
+    @brief Free a name/id map
 
-    @param buf Buffer to allocate.
-    @param reserve Number of bytes to allocate.
+    @param map Map to free.
 
     @returns GSD_SUCCESS on success, GSD_* error codes on error.
 */
-inline static int gsd_byte_buffer_allocate(struct gsd_byte_buffer* buf, size_t reserve)
+inline static int gsd_name_id_map_free(struct gsd_name_id_map* map)
     {
-    if (buf == NULL || buf->data || reserve == 0 || buf->reserved != 0 || buf->size != 0)
+    if (map == NULL || map->v == NULL || map->size == 0)
         {
         return GSD_ERROR_INVALID_ARGUMENT;
         }
 
-    buf->data = calloc(reserve, sizeof(char));
-    if (buf->data == NULL)
-        {
-        return GSD_ERROR_MEMORY_ALLOCATION_FAILED;
-        }
-
-    buf->size = 0;
-    buf->reserved = reserve;
+    free(map->v);
+    free(map->names);
+    free(map->sorted);
+    gsd_util_zero_memory(map, sizeof(struct gsd_name_id_map));
 
     return GSD_SUCCESS;
     }
 
 /** @internal
-    @brief Append bytes to a byte buffer
+    @brief Hash a string
 
-    @param buf Buffer to append to.
-    @param data Data to append.
-    @param size Number of bytes in *data*.
+    @param str String to hash.
+    @param len Length of the string.
 
-    @returns GSD_SUCCESS on success, GSD_* error codes on error.
+    Hashes 8 bytes at a time with a multiply and rotate step.
+
+    @returns Hashed value of the string.
 */
-inline static int gsd_byte_buffer_append(struct gsd_byte_buffer* buf, const char* data, size_t size)
+inline static uint32_t gsd_hash_str(const char* str, size_t len)
     {
-    if (buf == NULL || buf->data == NULL || size == 0 || buf->reserved == 0)
+    const uint64_t k = 0x517cc1b727220a95ULL; // NOLINT
+    uint64_t hash = len;
+
+    while (len >= sizeof(uint64_t))
         {
-        return GSD_ERROR_INVALID_ARGUMENT;
+        uint64_t word;
+        memcpy(&word, str, sizeof(uint64_t));
+        hash = (((hash << 5) | (hash >> 59)) ^ word) * k; // NOLINT
+        str += sizeof(uint64_t);
+        len -= sizeof(uint64_t);
         }
 
-    if (buf->size + size > buf->reserved)
+    if (len > 0)
         {
-        // reallocate by doubling
-        size_t new_reserved = buf->reserved * 2;
-        while (buf->size + size >= new_reserved)
-            {
-            new_reserved = new_reserved * 2;
-            }
-
-        char* old_data = buf->data;
-        buf->data = realloc(buf->data, sizeof(char) * new_reserved);
-        if (buf->data == NULL)
-            {
-            // this free should not be necessary, but clang-tidy disagrees
-            free(old_data);
-            return GSD_ERROR_MEMORY_ALLOCATION_FAILED;
-            }
-
-        // zero the new memory, but only the portion after the end of the new section to be appended
-        gsd_util_zero_memory(buf->data + (buf->size + size),
-                             sizeof(char) * (new_reserved - (buf->size + size)));
-        buf->reserved = new_reserved;
+        uint64_t word = 0;
+        memcpy(&word, str, len);
+        hash = (((hash << 5) | (hash >> 59)) ^ word) * k; // NOLINT
         }
 
-    memcpy(buf->data + buf->size, data, size);
-    buf->size += size;
-
-    return GSD_SUCCESS;
+    // the high bits are the best mixed
+    return (uint32_t)(hash >> 32); // NOLINT
     }
 
 /** @internal
-    @brief Free the memory allocated by the write buffer or unmap the mapped memory.
+    @brief Find the slot of a string in a name/id map
 
-    @param buf Buffer to free.
+    @param map Map to search.
+    @param str String to search for.
+    @param hash Hash of the string.
 
-    @returns GSD_SUCCESS on success, GSD_* error codes on error.
+    @returns The slot that holds *str*, or the empty slot where *str* would be inserted.
 */
-inline static int gsd_byte_buffer_free(struct gsd_byte_buffer* buf)
+inline static struct gsd_name_id_pair*
+gsd_name_id_map_slot(const struct gsd_name_id_map* map, const char* str, uint32_t hash)
     {
-    if (buf == NULL || buf->data == NULL)
+    size_t mask = map->size - 1;
+    size_t i = hash & mask;
+
+    // linear probing, the map always has empty slots
+    while (map->v[i].id != UINT16_MAX)
         {
-        return GSD_ERROR_INVALID_ARGUMENT;
+        if (map->v[i].hash == hash && strcmp(map->names + map->v[i].name, str) == 0)
+            {
+            break;
+            }
+        i = (i + 1) & mask;
         }
 
-    free(buf->data);
-
-    gsd_util_zero_memory(buf, sizeof(struct gsd_byte_buffer));
-    return GSD_SUCCESS;
+    return map->v + i;
     }
 
 /** @internal
-    @brief Allocate a buffer of index entries
-
-    @param buf Buffer to allocate.
-    @param reserve Number of entries to allocate.
+    @brief Double the number of slots in a name/id map
 
-    @post The buffer's data element has *reserve* elements allocated in memory.
+    @param map Map to grow.
 
     @returns GSD_SUCCESS on success, GSD_* error codes on error.
 */
-inline static int gsd_index_buffer_allocate(struct gsd_index_buffer* buf, size_t reserve)
+inline static int gsd_name_id_map_grow(struct gsd_name_id_map* map)
     {
-    if (buf == NULL || buf->mapped_data || buf->data || reserve == 0 || buf->reserved != 0
-        || buf->size != 0)
+    size_t new_size = map->size * 2;
+    struct gsd_name_id_pair* new_v = malloc(sizeof(struct gsd_name_id_pair) * new_size);
+    if (new_v == NULL)
         {
-        return GSD_ERROR_INVALID_ARGUMENT;
+        return GSD_ERROR_MEMORY_ALLOCATION_FAILED;
         }
 
-    buf->data = calloc(reserve, sizeof(struct gsd_index_entry));
-    if (buf->data == NULL)
+    struct gsd_name_id_pair* new_sorted
+        = realloc(map->sorted, sizeof(struct gsd_name_id_pair) * (new_size / 2));
+    if (new_sorted == NULL)
         {
+        free(new_v);
         return GSD_ERROR_MEMORY_ALLOCATION_FAILED;
         }
+    map->sorted = new_sorted;
 
-    buf->size = 0;
-    buf->reserved = reserve;
-    buf->mapped_data = NULL;
-    buf->mapped_len = 0;
+    size_t i;
+    for (i = 0; i < new_size; i++)
+        {
+        new_v[i].id = UINT16_MAX;
+        }
+
+    // the stored hashes place the names in the new slots
+    size_t mask = new_size - 1;
+    for (i = 0; i < map->size; i++)
+        {
+        if (map->v[i].id != UINT16_MAX)
+            {
+            size_t j = map->v[i].hash & mask;
+            while (new_v[j].id != UINT16_MAX)
+                {
+                j = (j + 1) & mask;
+                }
+            new_v[j] = map->v[i];
+            }
+        }
+
+    free(map->v);
+    map->v = new_v;
+    map->size = new_size;
 
     return GSD_SUCCESS;
     }
 
 /** @internal
-    @brief Map index entries from the file
-
-    @param buf Buffer to map.
-    @param handle GSD file handle to map.
-
-    @post The buffer's data element contains the index data from the file.
+    @brief Insert a string into a name/id map
 
-    On some systems, this will use mmap to efficiently access the file. On others, it may result in
-    an allocation and read of the entire index from the file.
+    @param map Map to insert into.
+    @param str String to insert.
+    @param id ID to associate with the string.
 
     @returns GSD_SUCCESS on success, GSD_* error codes on error.
 */
-inline static int gsd_index_buffer_map(struct gsd_index_buffer* buf, struct gsd_handle* handle)
+inline static int gsd_name_id_map_insert(struct gsd_name_id_map* map, const char* str, uint16_t id)
     {
-    if (buf == NULL || buf->mapped_data || buf->data || buf->reserved != 0 || buf->size != 0)
+    if (map == NULL || map->v == NULL || map->size == 0 || id == UINT16_MAX)
         {
         return GSD_ERROR_INVALID_ARGUMENT;
         }
 
-    // validate that the index block exists inside the file
-    if (handle->header.index_location
-            + sizeof(struct gsd_index_entry) * handle->header.index_allocated_entries
-        > (uint64_t)handle->file_size)
+    if ((map->n_names + 1) * 2 > map->size)
         {
-        return GSD_ERROR_FILE_CORRUPT;
+        int retval = gsd_name_id_map_grow(map);
+        if (retval != GSD_SUCCESS)
+            {
+            return retval;
+            }
         }
 
-#if GSD_USE_MMAP
-    // map the index in read only mode
-    size_t page_size = getpagesize();
-    size_t index_size = sizeof(struct gsd_index_entry) * handle->header.index_allocated_entries;
-    size_t offset = (handle->header.index_location / page_size) * page_size;
-    buf->mapped_data = mmap(NULL,
-                            index_size + (handle->header.index_location - offset),
-                            PROT_READ,
-                            MAP_SHARED,
-                            handle->fd,
-                            offset);
-
-    if (buf->mapped_data == MAP_FAILED)
+    size_t len = strlen(str);
+    if (map->names_size + len + 1 > UINT32_MAX)
         {
-        return GSD_ERROR_IO;
+        return GSD_ERROR_MEMORY_ALLOCATION_FAILED;
         }
 
-    buf->data = (struct gsd_index_entry*)(((char*)buf->mapped_data)
-                                          + (handle->header.index_location - offset));
-
-    buf->mapped_len = index_size + (handle->header.index_location - offset);
-    buf->reserved = handle->header.index_allocated_entries;
-#else
-    // mmap not supported, read the data from the disk
-    int retval = gsd_index_buffer_allocate(buf, handle->header.index_allocated_entries);
-    if (retval != GSD_SUCCESS)
+    if (map->names_size + len + 1 > map->names_reserved)
         {
-        return retval;
-        }
-
-    ssize_t bytes_read = gsd_io_pread_retry(handle->fd,
-                                            buf->data,
-                                            sizeof(struct gsd_index_entry)
-                                                * handle->header.index_allocated_entries,
-                                            handle->header.index_location);
+        size_t new_reserved = map->names_reserved * 2;
+        while (map->names_size + len + 1 > new_reserved)
+            {
+            new_reserved *= 2;
+            }
 
-    if (bytes_read == -1
-        || bytes_read != sizeof(struct gsd_index_entry) * handle->header.index_allocated_entries)
-        {
-        return GSD_ERROR_IO;
+        char* new_names = realloc(map->names, new_reserved);
+        if (new_names == NULL)
+            {
+            return GSD_ERROR_MEMORY_ALLOCATION_FAILED;
+            }
+        map->names = new_names;
+        map->names_reserved = new_reserved;
         }
-#endif
 
-    // determine the number of index entries in the list
-    // file is corrupt if first index entry is invalid
-    if (buf->data[0].location != 0 && !gsd_is_entry_valid(handle, 0))
+    uint32_t hash = gsd_hash_str(str, len);
+    struct gsd_name_id_pair* slot = gsd_name_id_map_slot(map, str, hash);
+    if (slot->id != UINT16_MAX)
         {
-        return GSD_ERROR_FILE_CORRUPT;
+        // the name is already in the map, keep the first id
+        return GSD_SUCCESS;
         }
 
-    if (buf->data[0].location == 0)
-        {
-        buf->size = 0;
-        }
-    else
-        {
-        // determine the number of index entries (marked by location = 0)
-        // binary search for the first index entry with location 0
-        size_t L = 0;
-        size_t R = buf->reserved;
+    memcpy(map->names + map->names_size, str, len + 1);
+    slot->name = (uint32_t)map->names_size;
+    slot->hash = hash;
+    slot->id = id;
+    map->names_size += len + 1;
 
-        // progressively narrow the search window by halves
-        do
-            {
-            size_t m = (L + R) / 2;
+    // gsd_name_id_map_sort() moves the new name into place in the directory
+    map->sorted[map->n_names] = *slot;
+    map->n_names++;
 
-            // file is corrupt if any index entry is invalid or frame does not increase
-            // monotonically
-            if (buf->data[m].location != 0
-                && (!gsd_is_entry_valid(handle, m) || buf->data[m].frame < buf->data[L].frame))
-                {
-                return GSD_ERROR_FILE_CORRUPT;
-                }
+    return GSD_SUCCESS;
+    }
 
-            if (buf->data[m].location != 0)
-                {
-                L = m;
-                }
-            else
-                {
-                R = m;
-                }
-            } while ((R - L) > 1);
+/** @internal
+    @brief Find an ID in a name/id mapping
 
-        // this finds R = the first index entry with location = 0
-        buf->size = R;
+    @param map Map to search.
+    @param str String to search.
+
+    @returns The ID if found, or UINT16_MAX if not found.
+*/
+inline static uint16_t gsd_name_id_map_find(struct gsd_name_id_map* map, const char* str)
+    {
+    if (map == NULL || map->v == NULL || map->size == 0)
+        {
+        return UINT16_MAX;
         }
 
-    return GSD_SUCCESS;
+    return gsd_name_id_map_slot(map, str, gsd_hash_str(str, strlen(str)))->id;
     }
 
 /** @internal
-    @brief Free the memory allocated by the index buffer or unmap the mapped memory.
+    @brief Name and mapping pair used to sort the name directory
+*/
+struct gsd_name_sort_item
+    {
+    /// The name
+    const char* name;
 
-    @param buf Buffer to free.
+    /// The mapping of the name
+    struct gsd_name_id_pair pair;
+    };
 
-    @returns GSD_SUCCESS on success, GSD_* error codes on error.
+/** @internal
+    @brief Compare two gsd_name_sort_item by name
+
+    @param a Pointer to the first item.
+    @param b Pointer to the second item.
+
+    @returns The result of strcmp() on the names.
 */
-inline static int gsd_index_buffer_free(struct gsd_index_buffer* buf)
+static int gsd_cmp_name_sort_item(const void* a, const void* b)
     {
-    if (buf == NULL || buf->data == NULL)
-        {
-        return GSD_ERROR_INVALID_ARGUMENT;
-        }
+    return strcmp(((const struct gsd_name_sort_item*)a)->name,
+                  ((const struct gsd_name_sort_item*)b)->name);
+    }
 
-#if GSD_USE_MMAP
-    if (buf->mapped_data)
-        {
-        int retval = munmap(buf->mapped_data, buf->mapped_len);
+/** @internal
+    @brief Find the first name in the sorted directory that is not less than a string
 
-        if (retval != 0)
+    @param map Map to search.
+    @param str String to search for.
+
+    @returns The position of the first name in map->sorted that compares greater than or equal to
+    *str*, or map->n_sorted when there is none.
+*/
+inline static size_t gsd_name_id_map_lower_bound(const struct gsd_name_id_map* map, const char* str)
+    {
+    size_t L = 0;
+    size_t R = map->n_sorted;
+    while (L < R)
+        {
+        size_t m = L + (R - L) / 2;
+        if (strcmp(map->names + map->sorted[m].name, str) < 0)
             {
-            return GSD_ERROR_IO;
+            L = m + 1;
+            }
+        else
+            {
+            R = m;
             }
-        }
-    else
-#endif
-        {
-        free(buf->data);
         }
 
-    gsd_util_zero_memory(buf, sizeof(struct gsd_index_buffer));
-    return GSD_SUCCESS;
+    return L;
     }
 
 /** @internal
-    @brief Add a new index entry and provide a pointer to it.
+    @brief Sort the names inserted into a name/id map into the directory
 
-    @param buf Buffer to add too.
-    @param entry [out] Pointer to set to the new entry.
+    @param map Map to update.
 
-    Double the size of the reserved space as needed to hold the new entry. Does not accept mapped
-    indices.
+    Inserts a few new names one at a time with a binary search, and sorts the whole directory when
+    many names are new (e.g. after reading the namelist of a file).
 
     @returns GSD_SUCCESS on success, GSD_* error codes on error.
 */
-inline static int gsd_index_buffer_add(struct gsd_index_buffer* buf, struct gsd_index_entry** entry)
+inline static int gsd_name_id_map_sort(struct gsd_name_id_map* map)
     {
-    if (buf == NULL || buf->mapped_data || entry == NULL || buf->reserved == 0)
+    if (map == NULL || map->v == NULL || map->size == 0)
         {
         return GSD_ERROR_INVALID_ARGUMENT;
         }
 
-    if (buf->size == buf->reserved)
+    size_t n_new = map->n_names - map->n_sorted;
+    if (n_new == 0)
         {
-        // grow the array
-        size_t new_reserved = buf->reserved * 2;
-        buf->data = realloc(buf->data, sizeof(struct gsd_index_entry) * new_reserved);
-        if (buf->data == NULL)
+        return GSD_SUCCESS;
+        }
+
+    if (n_new <= GSD_NAME_DIRECTORY_MAX_INSERT)
+        {
+        while (map->n_sorted < map->n_names)
             {
-            return GSD_ERROR_MEMORY_ALLOCATION_FAILED;
+            struct gsd_name_id_pair pair = map->sorted[map->n_sorted];
+            size_t position = gsd_name_id_map_lower_bound(map, map->names + pair.name);
+            memmove(map->sorted + position + 1,
+                    map->sorted + position,
+                    sizeof(struct gsd_name_id_pair) * (map->n_sorted - position));
+            map->sorted[position] = pair;
+            map->n_sorted++;
             }
 
-        // zero the new memory
-        gsd_util_zero_memory(buf->data + buf->reserved,
-                             sizeof(struct gsd_index_entry) * (new_reserved - buf->reserved));
-        buf->reserved = new_reserved;
+        return GSD_SUCCESS;
         }
 
-    size_t insert_pos = buf->size;
-    buf->size++;
-    *entry = buf->data + insert_pos;
-
-    return GSD_SUCCESS;
-    }
-
-inline static int gsd_cmp_index_entry(const struct gsd_index_entry* a,
-                                      const struct gsd_index_entry* b)
-    {
-    int result = 0;
-
-    if (a->frame < b->frame)
+    struct gsd_name_sort_item* items = malloc(sizeof(struct gsd_name_sort_item) * map->n_names);
+    if (items == NULL)
         {
-        result = -1;
+        return GSD_ERROR_MEMORY_ALLOCATION_FAILED;
         }
 
-    if (a->frame > b->frame)
+    size_t i;
+    for (i = 0; i < map->n_names; i++)
         {
-        result = 1;
+        items[i].name = map->names + map->sorted[i].name;
+        items[i].pair = map->sorted[i];
         }
-
-    if (a->frame == b->frame)
+    qsort(items, map->n_names, sizeof(struct gsd_name_sort_item), gsd_cmp_name_sort_item);
+    for (i = 0; i < map->n_names; i++)
         {
-        if (a->id < b->id)
-            {
-            result = -1;
-            }
-
-        if (a->id > b->id)
-            {
-            result = 1;
-            }
-
-        if (a->id == b->id)
-            {
-            result = 0;
-            }
+        map->sorted[i] = items[i].pair;
         }
+    map->n_sorted = map->n_names;
 
-    return result;
+    free(items);
+    return GSD_SUCCESS;
     }
 
 /** @internal
-    @brief Compute heap parent node.
-    @param i Node index.
+    @brief Header stored in front of the data of chunks with non-zero flags
+
+    The encoded data of *stored_size* bytes follows the header in the file.
 */
-inline static size_t gsd_heap_parent(size_t i)
+struct gsd_chunk_header
     {
-    return (i - 1) / 2;
-    }
+    /// Number of bytes of encoded data following the header.
+    uint64_t stored_size;
+
+    /// Number of bytes produced by decompressing the encoded data.
+    uint64_t data_size;
+    };
 
 /** @internal
-    @brief Compute heap left child.
-    @param i Node index.
+    @brief Header of the quantized encoding of a float chunk
+
+    *M* gsd_quantize_column entries follow the header, then the quantized values of all elements
+    in row major order packed least significant bit first.
 */
-inline static size_t gsd_heap_left_child(size_t i)
+struct gsd_quantize_header
     {
-    return 2 * i + 1;
-    }
+    /// Distance between adjacent quantized values.
+    double step;
+
+    /// Number of columns.
+    uint64_t M;
+    };
 
 /** @internal
-    @brief Swap the nodes *a* and *b* in the buffer
-    @param buf Buffer.
-    @param a First index to swap.
-    @param b Second index to swap.
+    @brief Quantization parameters of one column
 */
-inline static void gsd_heap_swap(struct gsd_index_buffer* buf, size_t a, size_t b)
+struct gsd_quantize_column
     {
-    struct gsd_index_entry tmp = buf->data[a];
-    buf->data[a] = buf->data[b];
-    buf->data[b] = tmp;
-    }
+    /// Value represented by the quantized value 0.
+    double origin;
+
+    /// Number of bits in each quantized value.
+    uint64_t bits;
+    };
 
 /** @internal
-    @brief Shift heap node downward
-    @param buf Buffer.
-    @param start First index of the valid heap in *buf*.
-    @param end Last index of the valid hep in *buf*.
+    @brief Compression codec
+
+    Codecs are registered in gsd_codecs and selected by the GSD_COMPRESSION_MASK bits of the chunk
+    flags.
 */
-inline static void gsd_heap_shift_down(struct gsd_index_buffer* buf, size_t start, size_t end)
+struct gsd_codec
     {
-    size_t root = start;
+    /** Compress *n* bytes from *src* into *dst*. Returns the number of bytes written to *dst*, or 0
+        when the compressed data does not fit in *capacity* bytes.
+    */
+    size_t (*compress)(char* dst, size_t capacity, const char* src, size_t n);
+
+    /** Decompress *n* bytes from *src* into exactly *dst_size* bytes of *dst*. Returns GSD_SUCCESS,
+        or GSD_ERROR_FILE_CORRUPT when *src* is malformed.
+    */
+    int (*decompress)(char* dst, size_t dst_size, const char* src, size_t n);
+    };
 
-    while (gsd_heap_left_child(root) <= end)
-        {
-        size_t child = gsd_heap_left_child(root);
-        size_t swap = root;
+/// Number of entries in the LZ4 compressor hash table (log 2)
+enum
+    {
+    GSD_LZ4_HASH_LOG = 12
+    };
 
-        if (gsd_cmp_index_entry(buf->data + swap, buf->data + child) < 0)
-            {
-            swap = child;
-            }
-        if (child + 1 <= end && gsd_cmp_index_entry(buf->data + swap, buf->data + child + 1) < 0)
-            {
-            swap = child + 1;
-            }
+/// Shortest match encoded by the LZ4 block format
+enum
+    {
+    GSD_LZ4_MIN_MATCH = 4
+    };
 
-        if (swap == root)
-            {
-            return;
-            }
+/// Largest match offset encoded by the LZ4 block format
+enum
+    {
+    GSD_LZ4_MAX_OFFSET = 65535
+    };
 
-        gsd_heap_swap(buf, root, swap);
-        root = swap;
+/// The last match in an LZ4 block must start at least this many bytes before the end
+enum
+    {
+    GSD_LZ4_MFLIMIT = 12
+    };
+
+/// The last bytes of an LZ4 block are always literals
+enum
+    {
+    GSD_LZ4_LAST_LITERALS = 5
+    };
+
+/** @internal
+    @brief Store data without compression
+
+    @param dst Output buffer.
+    @param capacity Number of bytes available in *dst*.
+    @param src Data to store.
+    @param n Number of bytes in *src*.
+
+    @returns The number of bytes written to *dst*, or 0 when *src* does not fit.
+*/
+static size_t gsd_none_compress(char* dst, size_t capacity, const char* src, size_t n)
+    {
+    if (n > capacity)
+        {
+        return 0;
         }
+    memcpy(dst, src, n);
+    return n;
     }
 
 /** @internal
-    @brief Convert unordered index buffer to a heap
-    @param buf Buffer.
+    @brief Read data stored without compression
+
+    @param dst Output buffer.
+    @param dst_size Number of bytes expected in *dst*.
+    @param src Stored data.
+    @param n Number of bytes in *src*.
+
+    @returns GSD_SUCCESS on success, GSD_ERROR_FILE_CORRUPT when the size does not match.
 */
-inline static void gsd_heapify(struct gsd_index_buffer* buf)
+static int gsd_none_decompress(char* dst, size_t dst_size, const char* src, size_t n)
     {
-    ssize_t start = gsd_heap_parent(buf->size - 1);
-
-    while (start >= 0)
+    if (n != dst_size)
         {
-        gsd_heap_shift_down(buf, start, buf->size - 1);
-        start--;
+        return GSD_ERROR_FILE_CORRUPT;
         }
+    memcpy(dst, src, n);
+    return GSD_SUCCESS;
     }
 
 /** @internal
-    @brief Sort the index buffer.
+    @brief Read an unaligned 32-bit value
 
-    @param buf Buffer to sort.
+    @param p Pointer to the value.
 
-    Sorts an in-memory index buffer. Does not accept mapped indices.
+    @returns The value.
+*/
+inline static uint32_t gsd_lz4_read32(const char* p)
+    {
+    uint32_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+    }
 
-    @returns GSD_SUCCESS on success, GSD_* error codes on error.
+/** @internal
+    @brief Hash 4 bytes for the LZ4 match finder
+
+    @param v Value to hash.
+
+    @returns Index into the hash table.
 */
-inline static int gsd_index_buffer_sort(struct gsd_index_buffer* buf)
+inline static size_t gsd_lz4_hash(uint32_t v)
     {
-    if (buf == NULL || buf->mapped_data || buf->reserved == 0)
-        {
-        return GSD_ERROR_INVALID_ARGUMENT;
-        }
+    return (size_t)((v * 2654435761U) >> (32 - GSD_LZ4_HASH_LOG));
+    }
 
-    // arrays of size 0 or 1 are already sorted
-    if (buf->size <= 1)
-        {
-        return GSD_SUCCESS;
-        }
+/** @internal
+    @brief Write the extension bytes of an LZ4 length
 
-    gsd_heapify(buf);
+    @param op Output position.
+    @param op_end End of the output buffer.
+    @param len Length remaining after the 4-bit token field.
 
-    size_t end = buf->size - 1;
-    while (end > 0)
+    @returns The new output position, or NULL when the output buffer is full.
+*/
+inline static char* gsd_lz4_write_length(char* op, const char* op_end, size_t len)
+    {
+    while (len >= 255)
         {
-        gsd_heap_swap(buf, end, 0);
-        end = end - 1;
-        gsd_heap_shift_down(buf, 0, end);
+        if (op >= op_end)
+            {
+            return NULL;
+            }
+        *op++ = (char)255;
+        len -= 255;
         }
 
-    return GSD_SUCCESS;
+    if (op >= op_end)
+        {
+        return NULL;
+        }
+    *op++ = (char)len;
+    return op;
     }
 
 /** @internal
-    @brief Utility function to expand the memory space for the index block in the file.
+    @brief Write one LZ4 sequence
 
-    @param handle Handle to the open gsd file.
-    @param size_required The new index must be able to hold at least this many elements.
+    @param op Output position.
+    @param op_end End of the output buffer.
+    @param literals Literal bytes.
+    @param n_literals Number of literal bytes.
+    @param offset Match offset (0 for the last sequence, which has no match).
+    @param match_length Match length.
 
-    @returns GSD_SUCCESS on success, GSD_* error codes on error.
+    @returns The new output position, or NULL when the output buffer is full.
 */
-inline static int gsd_expand_file_index(struct gsd_handle* handle, size_t size_required)
+inline static char* gsd_lz4_write_sequence(char* op,
+                                           const char* op_end,
+                                           const char* literals,
+                                           size_t n_literals,
+                                           size_t offset,
+                                           size_t match_length)
     {
-    if (handle->open_flags == GSD_OPEN_READONLY)
+    if (op >= op_end)
         {
-        return GSD_ERROR_FILE_MUST_BE_WRITABLE;
+        return NULL;
         }
 
-    // multiply the index size each time it grows
-    // this allows the index to grow rapidly to accommodate new frames
-    const int multiplication_factor = 2;
-
-    // save the old size and update the new size
-    size_t size_old = handle->header.index_allocated_entries;
-    size_t size_new = size_old * multiplication_factor;
+    size_t ml = match_length - GSD_LZ4_MIN_MATCH;
+    char* token = op++;
+    *token = (char)((n_literals < 15 ? n_literals : 15) << 4);
+    if (offset != 0)
+        {
+        *token |= (char)(ml < 15 ? ml : 15);
+        }
 
-    while (size_new <= size_required)
+    if (n_literals >= 15)
         {
-        size_new *= multiplication_factor;
+        op = gsd_lz4_write_length(op, op_end, n_literals - 15);
+        if (op == NULL)
+            {
+            return NULL;
+            }
         }
 
-    // Mac systems deadlock when writing from a mapped region into the tail end of that same region
-    // unmap the index first and copy it over by chunks
-    int retval = gsd_index_buffer_free(&handle->file_index);
-    if (retval != 0)
+    if ((size_t)(op_end - op) < n_literals)
         {
-        return retval;
+        return NULL;
         }
+    memcpy(op, literals, n_literals);
+    op += n_literals;
 
-    // allocate the copy buffer
-    char* buf = malloc(GSD_COPY_BUFFER_SIZE);
+    if (offset == 0)
+        {
+        return op;
+        }
 
-    // write the current index to the end of the file
-    int64_t new_index_location = lseek(handle->fd, 0, SEEK_END);
-    int64_t old_index_location = handle->header.index_location;
-    size_t total_bytes_written = 0;
-    size_t old_index_bytes = size_old * sizeof(struct gsd_index_entry);
-    while (total_bytes_written < old_index_bytes)
+    if (op_end - op < 2)
         {
-        size_t bytes_to_copy = GSD_COPY_BUFFER_SIZE;
-        if (old_index_bytes - total_bytes_written < GSD_COPY_BUFFER_SIZE)
-            {
-            bytes_to_copy = old_index_bytes - total_bytes_written;
-            }
+        return NULL;
+        }
+    *op++ = (char)(offset & 0xff);
+    *op++ = (char)(offset >> 8);
 
-        ssize_t bytes_read = gsd_io_pread_retry(handle->fd,
-                                                buf,
-                                                bytes_to_copy,
-                                                old_index_location + total_bytes_written);
+    if (ml >= 15)
+        {
+        op = gsd_lz4_write_length(op, op_end, ml - 15);
+        }
+    return op;
+    }
 
-        if (bytes_read == -1 || bytes_read != bytes_to_copy)
-            {
-            free(buf);
-            return GSD_ERROR_IO;
-            }
+/** @internal
+    @brief Compress data in the LZ4 block format
 
-        ssize_t bytes_written = gsd_io_pwrite_retry(handle->fd,
-                                                    buf,
-                                                    bytes_to_copy,
-                                                    new_index_location + total_bytes_written);
+    A greedy single pass match finder with a small hash table. The output can be decompressed by any
+    LZ4 block decoder.
 
-        if (bytes_written == -1 || bytes_written != bytes_to_copy)
-            {
-            free(buf);
-            return GSD_ERROR_IO;
-            }
+    @param dst Output buffer.
+    @param capacity Number of bytes available in *dst*.
+    @param src Data to compress.
+    @param n Number of bytes in *src*.
 
-        total_bytes_written += bytes_written;
-        }
+    @returns The number of bytes written to *dst*, or 0 when the compressed data does not fit.
+*/
+static size_t gsd_lz4_compress(char* dst, size_t capacity, const char* src, size_t n)
+    {
+    // hash table of positions + 1, 0 marks an empty slot
+    size_t table[1 << GSD_LZ4_HASH_LOG];
+    memset(table, 0, sizeof(table));
 
-    // fill the new index space with 0s
-    gsd_util_zero_memory(buf, GSD_COPY_BUFFER_SIZE);
+    char* op = dst;
+    const char* op_end = dst + capacity;
+    size_t ip = 0;
+    size_t anchor = 0;
 
-    size_t new_index_bytes = size_new * sizeof(struct gsd_index_entry);
-    while (total_bytes_written < new_index_bytes)
+    if (n > GSD_LZ4_MFLIMIT)
         {
-        size_t bytes_to_copy = GSD_COPY_BUFFER_SIZE;
-        if (new_index_bytes - total_bytes_written < GSD_COPY_BUFFER_SIZE)
-            {
-            bytes_to_copy = new_index_bytes - total_bytes_written;
-            }
-
-        ssize_t bytes_written = gsd_io_pwrite_retry(handle->fd,
-                                                    buf,
-                                                    bytes_to_copy,
-                                                    new_index_location + total_bytes_written);
+        size_t ip_limit = n - GSD_LZ4_MFLIMIT;
+        size_t match_limit = n - GSD_LZ4_LAST_LITERALS;
 
-        if (bytes_written == -1 || bytes_written != bytes_to_copy)
+        while (ip < ip_limit)
             {
-            free(buf);
-            return GSD_ERROR_IO;
-            }
+            uint32_t sequence = gsd_lz4_read32(src + ip);
+            size_t h = gsd_lz4_hash(sequence);
+            size_t ref = table[h];
+            table[h] = ip + 1;
 
-        total_bytes_written += bytes_written;
-        }
+            if (ref == 0 || ip - (ref - 1) > GSD_LZ4_MAX_OFFSET
+                || gsd_lz4_read32(src + ref - 1) != sequence)
+                {
+                // step faster through data that does not compress
+                ip += 1 + ((ip - anchor) >> 6);
+                continue;
+                }
+            ref--;
 
-    // sync the expanded index
-    retval = fsync(handle->fd);
-    if (retval != 0)
-        {
-        free(buf);
-        return GSD_ERROR_IO;
-        }
+            // extend the match backwards and forwards
+            while (ip > anchor && ref > 0 && src[ip - 1] == src[ref - 1])
+                {
+                ip--;
+                ref--;
+                }
 
-    // free the copy buffer
-    free(buf);
+            size_t length = GSD_LZ4_MIN_MATCH;
+            while (ip + length < match_limit && src[ip + length] == src[ref + length])
+                {
+                length++;
+                }
 
-    // update the header
-    handle->header.index_location = new_index_location;
-    handle->file_size = handle->header.index_location + total_bytes_written;
-    handle->header.index_allocated_entries = size_new;
+            op = gsd_lz4_write_sequence(op, op_end, src + anchor, ip - anchor, ip - ref, length);
+            if (op == NULL)
+                {
+                return 0;
+                }
 
-    // write the new header out
-    ssize_t bytes_written
-        = gsd_io_pwrite_retry(handle->fd, &(handle->header), sizeof(struct gsd_header), 0);
-    if (bytes_written != sizeof(struct gsd_header))
-        {
-        return GSD_ERROR_IO;
+            ip += length;
+            anchor = ip;
+            }
         }
 
-    // sync the updated header
-    retval = fsync(handle->fd);
-    if (retval != 0)
+    op = gsd_lz4_write_sequence(op, op_end, src + anchor, n - anchor, 0, GSD_LZ4_MIN_MATCH);
+    if (op == NULL)
         {
-        return GSD_ERROR_IO;
+        return 0;
         }
 
-    // remap the file index
-    retval = gsd_index_buffer_map(&handle->file_index, handle);
-    if (retval != 0)
+    return op - dst;
+    }
+
+/** @internal
+    @brief Read the extension bytes of an LZ4 length
+
+    @param length Length to extend (modified).
+    @param ip Input position (modified).
+    @param src Input buffer.
+    @param n Number of bytes in *src*.
+
+    @returns GSD_SUCCESS on success, GSD_ERROR_FILE_CORRUPT when the input ends early.
+*/
+inline static int gsd_lz4_read_length(size_t* length, size_t* ip, const char* src, size_t n)
+    {
+    unsigned char b;
+    do
         {
-        return retval;
-        }
+        if (*ip >= n)
+            {
+            return GSD_ERROR_FILE_CORRUPT;
+            }
+        b = (unsigned char)src[*ip];
+        (*ip)++;
+        *length += b;
+        } while (b == 255);
 
     return GSD_SUCCESS;
     }
 
 /** @internal
-    @brief Flush the write buffer.
+    @brief Decompress data in the LZ4 block format
 
-    gsd_write_frame() writes small data chunks into the write buffer. It adds index entries for
-    these chunks to gsd_handle::buffer_index with locations offset from the start of the write
-    buffer. gsd_flush_write_buffer() writes the buffer to the end of the file, moves the index
-    entries to gsd_handle::frame_index and updates the location to reference the beginning of the
-    file.
+    Validates every length and offset against the input and output buffers.
 
-    @param handle Handle to flush the write buffer.
-    @returns GSD_SUCCESS on success or GSD_* error codes on error
+    @param dst Output buffer.
+    @param dst_size Number of bytes expected in *dst*.
+    @param src Compressed data.
+    @param n Number of bytes in *src*.
+
+    @returns GSD_SUCCESS on success, GSD_ERROR_FILE_CORRUPT when *src* is malformed.
 */
-inline static int gsd_flush_write_buffer(struct gsd_handle* handle)
+static int gsd_lz4_decompress(char* dst, size_t dst_size, const char* src, size_t n)
     {
-    if (handle == NULL)
-        {
-        return GSD_ERROR_INVALID_ARGUMENT;
-        }
+    size_t ip = 0;
+    size_t op = 0;
 
-    if (handle->write_buffer.size == 0 && handle->buffer_index.size == 0)
+    while (ip < n)
         {
-        // nothing to do
-        return GSD_SUCCESS;
-        }
+        unsigned char token = (unsigned char)src[ip++];
 
-    if (handle->write_buffer.size > 0 && handle->buffer_index.size == 0)
-        {
-        // error: bytes in buffer, but no index for them
-        return GSD_ERROR_INVALID_ARGUMENT;
-        }
-
-    // write the buffer to the end of the file
-    uint64_t offset = handle->file_size;
-    ssize_t bytes_written = gsd_io_pwrite_retry(handle->fd,
-                                                handle->write_buffer.data,
-                                                handle->write_buffer.size,
-                                                offset);
-
-    if (bytes_written == -1 || bytes_written != handle->write_buffer.size)
-        {
-        return GSD_ERROR_IO;
-        }
+        size_t n_literals = token >> 4;
+        if (n_literals == 15 && gsd_lz4_read_length(&n_literals, &ip, src, n) != GSD_SUCCESS)
+            {
+            return GSD_ERROR_FILE_CORRUPT;
+            }
+        if (n_literals > n - ip || n_literals > dst_size - op)
+            {
+            return GSD_ERROR_FILE_CORRUPT;
+            }
+        memcpy(dst + op, src + ip, n_literals);
+        ip += n_literals;
+        op += n_literals;
 
-    handle->file_size += handle->write_buffer.size;
+        // the last sequence has no match
+        if (ip == n)
+            {
+            break;
+            }
 
-    // reset write_buffer for new data
-    handle->write_buffer.size = 0;
+        if (n - ip < 2)
+            {
+            return GSD_ERROR_FILE_CORRUPT;
+            }
+        size_t offset = (unsigned char)src[ip] | ((size_t)(unsigned char)src[ip + 1] << 8);
+        ip += 2;
+        if (offset == 0 || offset > op)
+            {
+            return GSD_ERROR_FILE_CORRUPT;
+            }
 
-    // move buffer_index entries to file_index
-    size_t i;
-    for (i = 0; i < handle->buffer_index.size; i++)
-        {
-        struct gsd_index_entry* new_index;
-        int retval = gsd_index_buffer_add(&handle->frame_index, &new_index);
-        if (retval != GSD_SUCCESS)
+        size_t length = token & 0x0f;
+        if (length == 15 && gsd_lz4_read_length(&length, &ip, src, n) != GSD_SUCCESS)
             {
-            return retval;
+            return GSD_ERROR_FILE_CORRUPT;
+            }
+        length += GSD_LZ4_MIN_MATCH;
+        if (length > dst_size - op)
+            {
+            return GSD_ERROR_FILE_CORRUPT;
             }
 
-        *new_index = handle->buffer_index.data[i];
-        new_index->location += offset;
+        if (offset >= length)
+            {
+            memcpy(dst + op, dst + op - offset, length);
+            }
+        else
+            {
+            // overlapping matches repeat the last *offset* bytes
+            size_t i;
+            for (i = 0; i < length; i++)
+                {
+                dst[op + i] = dst[op - offset + i];
+                }
+            }
+        op += length;
         }
 
-    // clear the buffer index for new entries
-    handle->buffer_index.size = 0;
+    if (op != dst_size)
+        {
+        return GSD_ERROR_FILE_CORRUPT;
+        }
 
     return GSD_SUCCESS;
     }
 
+/// Registered compression codecs, indexed by the GSD_COMPRESSION_MASK bits of the chunk flags
+static const struct gsd_codec gsd_codecs[] = {
+    {gsd_none_compress, gsd_none_decompress}, // GSD_COMPRESSION_NONE
+    {gsd_lz4_compress, gsd_lz4_decompress},   // GSD_COMPRESSION_LZ4
+};
+
+/// Number of registered compression codecs
+enum
+    {
+    GSD_N_CODECS = sizeof(gsd_codecs) / sizeof(gsd_codecs[0])
+    };
+
 /** @internal
-    @brief Flush the name buffer.
+    @brief Check that chunk flags select a known codec and filters
 
-    gsd_write_frame() adds new names to the frame_names buffer. gsd_flush_name_buffer() flushes
-    this buffer at the end of a frame write and commits the new names to the file. If necessary,
-    the namelist is written to a new location in the file.
+    @param flags Chunk flags.
 
-    @param handle Handle to flush the write buffer.
-    @returns GSD_SUCCESS on success or GSD_* error codes on error
+    @returns 1 if the flags are valid, 0 if they are not.
 */
-inline static int gsd_flush_name_buffer(struct gsd_handle* handle)
+inline static int gsd_is_flags_valid(uint8_t flags)
     {
-    if (handle == NULL)
+    if ((flags
+         & ~(GSD_COMPRESSION_MASK | GSD_FILTER_SHUFFLE | GSD_FILTER_BITSHUFFLE
+             | GSD_FILTER_QUANTIZE))
+        != 0)
         {
-        return GSD_ERROR_INVALID_ARGUMENT;
+        return 0;
         }
-
-    if (handle->frame_names.n_names == 0)
+    if ((flags & GSD_FILTER_SHUFFLE) && (flags & GSD_FILTER_BITSHUFFLE))
         {
-        // nothing to do
-        return GSD_SUCCESS;
+        return 0;
         }
-
-    if (handle->frame_names.data.size == 0)
+    if ((flags & GSD_FILTER_QUANTIZE) && (flags & (GSD_FILTER_SHUFFLE | GSD_FILTER_BITSHUFFLE)))
         {
-        // error: bytes in buffer, but no names for them
-        return GSD_ERROR_INVALID_ARGUMENT;
+        return 0;
         }
-
-    size_t old_reserved = handle->file_names.data.reserved;
-    size_t old_size = handle->file_names.data.size;
-
-    // add the new names to the file name list and zero the frame list
-    int retval = gsd_byte_buffer_append(&handle->file_names.data,
-                                        handle->frame_names.data.data,
-                                        handle->frame_names.data.size);
-    if (retval != GSD_SUCCESS)
+    if ((flags & GSD_COMPRESSION_MASK) >= GSD_N_CODECS)
         {
-        return retval;
+        return 0;
         }
+    return 1;
+    }
 
-    handle->file_names.n_names += handle->frame_names.n_names;
-    handle->frame_names.n_names = 0;
-    handle->frame_names.data.size = 0;
-    gsd_util_zero_memory(handle->frame_names.data.data, handle->frame_names.data.reserved);
+/** @internal
+    @brief Byte shuffle elements [start, count) of an array
 
-    // reserved space must be a multiple of the GSD name size
-    if (handle->file_names.data.reserved % GSD_NAME_SIZE != 0)
-        {
-        return GSD_ERROR_INVALID_ARGUMENT;
-        }
+    Stores the first byte of every element, then the second byte of every element, and so on.
 
-    if (handle->file_names.data.reserved > old_reserved)
+    @param dst Output buffer of `count * type_size` bytes.
+    @param src Array to shuffle.
+    @param count Number of elements in *src*.
+    @param type_size Size of one element in bytes.
+    @param start First element to shuffle.
+*/
+inline static void
+gsd_byte_shuffle_scalar(char* dst, const char* src, size_t count, size_t type_size, size_t start)
+    {
+    size_t i, j;
+    for (j = 0; j < type_size; j++)
         {
-        // write the new name list to the end of the file
-        uint64_t offset = handle->file_size;
-        ssize_t bytes_written = gsd_io_pwrite_retry(handle->fd,
-                                                    handle->file_names.data.data,
-                                                    handle->file_names.data.reserved,
-                                                    offset);
-
-        if (bytes_written == -1 || bytes_written != handle->file_names.data.reserved)
+        for (i = start; i < count; i++)
             {
-            return GSD_ERROR_IO;
+            dst[j * count + i] = src[i * type_size + j];
             }
+        }
+    }
 
-        // sync the updated name list
-        retval = fsync(handle->fd);
-        if (retval != 0)
+/** @internal
+    @brief Reverse gsd_byte_shuffle_scalar() for elements [start, count)
+
+    @param dst Output buffer of `count * type_size` bytes.
+    @param src Shuffled array.
+    @param count Number of elements in *src*.
+    @param type_size Size of one element in bytes.
+    @param start First element to unshuffle.
+*/
+inline static void
+gsd_byte_unshuffle_scalar(char* dst, const char* src, size_t count, size_t type_size, size_t start)
+    {
+    size_t i, j;
+    for (j = 0; j < type_size; j++)
+        {
+        for (i = start; i < count; i++)
             {
-            return GSD_ERROR_IO;
+            dst[i * type_size + j] = src[j * count + i];
             }
+        }
+    }
 
-        handle->file_size += handle->file_names.data.reserved;
-        handle->header.namelist_location = offset;
-        handle->header.namelist_allocated_entries
-            = handle->file_names.data.reserved / GSD_NAME_SIZE;
+#if GSD_USE_SSE2
+/** Pairing masks of the unpack rounds that byte shuffle a block of 16 elements, indexed by
+    log2(type_size) - 1. Each round interleaves register r with register r | mask.
+*/
+static const size_t gsd_shuffle_rounds[3][4] = {{1, 1, 1, 1}, {2, 1, 2, 1}, {4, 2, 1, 4}};
 
-        // write the new header out
-        bytes_written
-            = gsd_io_pwrite_retry(handle->fd, &(handle->header), sizeof(struct gsd_header), 0);
-        if (bytes_written != sizeof(struct gsd_header))
-            {
-            return GSD_ERROR_IO;
-            }
+/// Byte of the element held by each register after the shuffle rounds
+static const size_t gsd_shuffle_row[3][8] = {{0, 1}, {0, 1, 2, 3}, {0, 2, 4, 6, 1, 3, 5, 7}};
+
+/// Pairing masks of the unpack rounds that reverse the byte shuffle of a block of 16 elements
+static const size_t gsd_unshuffle_rounds[3][3] = {{1}, {2, 1}, {4, 2, 1}};
+
+/** @internal
+    @brief Index of a type size in the shuffle round tables
+
+    @param type_size Size of one element in bytes.
+
+    @returns log2(type_size) - 1 for 2, 4, and 8 byte types, or -1 when SIMD kernels do not support
+    the type size.
+*/
+inline static int gsd_shuffle_table_index(size_t type_size)
+    {
+    if (type_size == 2)
+        {
+        return 0;
         }
-    else
+    if (type_size == 4)
         {
-        // write the new name list to the old index location
-        uint64_t offset = handle->header.namelist_location;
-        ssize_t bytes_written = gsd_io_pwrite_retry(handle->fd,
-                                                    handle->file_names.data.data + old_size,
-                                                    handle->file_names.data.reserved - old_size,
-                                                    offset + old_size);
-        if (bytes_written != (handle->file_names.data.reserved - old_size))
+        return 1;
+        }
+    if (type_size == 8)
+        {
+        return 2;
+        }
+    return -1;
+    }
+
+/** @internal
+    @brief Interleave the bytes of pairs of registers
+
+    @param x Registers.
+    @param n_regs Number of registers.
+    @param mask Pairs register r with register r | mask.
+*/
+inline static void gsd_sse2_unpack_round(__m128i* x, size_t n_regs, size_t mask)
+    {
+    size_t r;
+    for (r = 0; r < n_regs; r++)
+        {
+        if ((r & mask) == 0)
             {
-            return GSD_ERROR_IO;
+            __m128i a = x[r];
+            __m128i b = x[r | mask];
+            x[r] = _mm_unpacklo_epi8(a, b);
+            x[r | mask] = _mm_unpackhi_epi8(a, b);
             }
         }
+    }
 
-    // sync the updated name list or header
-    retval = fsync(handle->fd);
-    if (retval != 0)
+/** @internal
+    @brief Byte shuffle blocks of 16 elements with SSE2
+
+    @param dst Output buffer of `count * type_size` bytes.
+    @param src Array to shuffle.
+    @param count Number of elements in *src*.
+    @param type_size Size of one element in bytes.
+    @param start First element to shuffle.
+
+    @returns The first element that was not shuffled.
+*/
+static size_t
+gsd_byte_shuffle_sse2(char* dst, const char* src, size_t count, size_t type_size, size_t start)
+    {
+    int t = gsd_shuffle_table_index(type_size);
+    if (t < 0)
         {
-        return GSD_ERROR_IO;
+        return start;
         }
 
-    return GSD_SUCCESS;
+    __m128i x[8];
+    size_t e, r, k;
+    for (e = start; e + 16 <= count; e += 16)
+        {
+        const char* block = src + e * type_size;
+        for (r = 0; r < type_size; r++)
+            {
+            x[r] = _mm_loadu_si128((const __m128i*)(block + 16 * r));
+            }
+        for (k = 0; k < 4; k++)
+            {
+            gsd_sse2_unpack_round(x, type_size, gsd_shuffle_rounds[t][k]);
+            }
+        for (r = 0; r < type_size; r++)
+            {
+            _mm_storeu_si128((__m128i*)(dst + gsd_shuffle_row[t][r] * count + e), x[r]);
+            }
+        }
+    return e;
     }
 
 /** @internal
-    @brief utility function to append a name to the namelist
-
-    @param id [out] ID of the new name
-    @param handle handle to the open gsd file
-    @param name string name
+    @brief Reverse the byte shuffle of blocks of 16 elements with SSE2
 
-    Append a name to the names in the current frame. gsd_end_frame() will add this list to the
-    file names.
+    @param dst Output buffer of `count * type_size` bytes.
+    @param src Shuffled array.
+    @param count Number of elements in *src*.
+    @param type_size Size of one element in bytes.
+    @param start First element to unshuffle.
 
-    @return
-      - GSD_SUCCESS (0) on success. Negative value on failure:
-      - GSD_ERROR_IO: IO error (check errno).
-      - GSD_ERROR_MEMORY_ALLOCATION_FAILED: Unable to allocate memory.
-      - GSD_ERROR_FILE_MUST_BE_WRITABLE: File must not be read only.
+    @returns The first element that was not unshuffled.
 */
-inline static int gsd_append_name(uint16_t* id, struct gsd_handle* handle, const char* name)
+static size_t
+gsd_byte_unshuffle_sse2(char* dst, const char* src, size_t count, size_t type_size, size_t start)
     {
-    if (handle->open_flags == GSD_OPEN_READONLY)
+    int t = gsd_shuffle_table_index(type_size);
+    if (t < 0)
         {
-        return GSD_ERROR_FILE_MUST_BE_WRITABLE;
+        return start;
         }
 
-    if (handle->file_names.n_names + handle->frame_names.n_names == UINT16_MAX)
+    __m128i x[8];
+    size_t e, r, k;
+    for (e = start; e + 16 <= count; e += 16)
         {
-        // no more names may be added
-        return GSD_ERROR_NAMELIST_FULL;
+        for (r = 0; r < type_size; r++)
+            {
+            x[r] = _mm_loadu_si128((const __m128i*)(src + r * count + e));
+            }
+        for (k = 0; k < (size_t)t + 1; k++)
+            {
+            gsd_sse2_unpack_round(x, type_size, gsd_unshuffle_rounds[t][k]);
+            }
+        char* block = dst + e * type_size;
+        for (r = 0; r < type_size; r++)
+            {
+            _mm_storeu_si128((__m128i*)(block + 16 * r), x[r]);
+            }
         }
+    return e;
+    }
 
-    // Provide the ID of the new name
-    *id = (uint16_t)(handle->file_names.n_names + handle->frame_names.n_names);
+/** @internal
+    @brief Transpose the bits of blocks of 16 bytes with SSE2
 
-    if (handle->header.gsd_version < gsd_make_version(2, 0))
-        {
-        // v1 files always allocate GSD_NAME_SIZE bytes for each name and put a NULL terminator
-        // at address 63
-        char name_v1[GSD_NAME_SIZE];
-        strncpy(name_v1, name, GSD_NAME_SIZE - 1);
-        name_v1[GSD_NAME_SIZE - 1] = 0;
-        gsd_byte_buffer_append(&handle->frame_names.data, name_v1, GSD_NAME_SIZE);
-        handle->frame_names.n_names++;
+    @param planes Output: 8 bit planes of `count / 8` bytes each.
+    @param row Bytes to transpose.
+    @param count Number of bytes in *row* (a multiple of 8).
+    @param start First byte to transpose (a multiple of 8).
 
-        // update the name/id mapping with the truncated name
-        int retval = gsd_name_id_map_insert(&handle->name_map, name_v1, *id);
-        if (retval != GSD_SUCCESS)
+    @returns The first byte that was not transposed.
+*/
+static size_t gsd_bit_transpose_sse2(char* planes, const char* row, size_t count, size_t start)
+    {
+    size_t stride = count / 8;
+    size_t b;
+    int k;
+    for (b = start; b + 16 <= count; b += 16)
+        {
+        __m128i x = _mm_loadu_si128((const __m128i*)(row + b));
+        for (k = 7; k >= 0; k--)
             {
-            return retval;
+            // gather the high bit of every byte, then move the next bit up
+            uint16_t bits = (uint16_t)_mm_movemask_epi8(x);
+            memcpy(planes + k * stride + b / 8, &bits, sizeof(bits));
+            x = _mm_add_epi8(x, x);
             }
         }
-    else
-        {
-        gsd_byte_buffer_append(&handle->frame_names.data, name, strlen(name) + 1);
-        handle->frame_names.n_names++;
+    return b;
+    }
 
-        // update the name/id mapping
-        int retval = gsd_name_id_map_insert(&handle->name_map, name, *id);
-        if (retval != GSD_SUCCESS)
+/** @internal
+    @brief Reverse the bit transpose of blocks of 16 bytes with SSE2
+
+    @param row Output bytes.
+    @param planes 8 bit planes of `count / 8` bytes each.
+    @param count Number of bytes in *row* (a multiple of 8).
+    @param start First byte to compute (a multiple of 8).
+
+    @returns The first byte that was not computed.
+*/
+static size_t gsd_bit_untranspose_sse2(char* row, const char* planes, size_t count, size_t start)
+    {
+    size_t stride = count / 8;
+    const __m128i low_bytes = _mm_set1_epi16(0x00ff);
+    size_t b;
+    int k;
+    for (b = start; b + 16 <= count; b += 16)
+        {
+        // load 2 bytes of every plane, then group the first and second bytes of the planes
+        uint16_t w[8];
+        for (k = 0; k < 8; k++)
             {
-            return retval;
+            memcpy(&w[k], planes + k * stride + b / 8, sizeof(uint16_t));
+            }
+        __m128i v = _mm_set_epi16((short)w[7],
+                                  (short)w[6],
+                                  (short)w[5],
+                                  (short)w[4],
+                                  (short)w[3],
+                                  (short)w[2],
+                                  (short)w[1],
+                                  (short)w[0]);
+        __m128i x
+            = _mm_packus_epi16(_mm_and_si128(v, low_bytes), _mm_srli_epi16(v, 8));
+
+        for (k = 7; k >= 0; k--)
+            {
+            uint16_t bits = (uint16_t)_mm_movemask_epi8(x);
+            row[b + k] = (char)(bits & 0xff);
+            row[b + 8 + k] = (char)(bits >> 8);
+            x = _mm_add_epi8(x, x);
             }
         }
+    return b;
+    }
+#endif
 
-    return GSD_SUCCESS;
+#if GSD_USE_AVX2
+/** @internal
+    @brief Check if the CPU supports AVX2
+
+    @returns 1 if AVX2 instructions are available, 0 if they are not.
+*/
+inline static int gsd_cpu_has_avx2(void)
+    {
+    return __builtin_cpu_supports("avx2") != 0;
     }
 
 /** @internal
-    @brief Truncate the file and write a new gsd header.
+    @brief Interleave the bytes of pairs of registers in each 128-bit lane
 
-    @param fd file descriptor to initialize
-    @param application Generating application name (truncated to 63 chars)
-    @param schema Schema name for data to be written in this GSD file (truncated to 63 chars)
-    @param schema_version Version of the scheme data to be written (make with gsd_make_version())
+    @param x Registers.
+    @param n_regs Number of registers.
+    @param mask Pairs register r with register r | mask.
 */
-inline static int
-gsd_initialize_file(int fd, const char* application, const char* schema, uint32_t schema_version)
+__attribute__((target("avx2"))) inline static void
+gsd_avx2_unpack_round(__m256i* x, size_t n_regs, size_t mask)
     {
-    // check if the file was created
-    if (fd == -1)
+    size_t r;
+    for (r = 0; r < n_regs; r++)
         {
-        return GSD_ERROR_IO;
+        if ((r & mask) == 0)
+            {
+            __m256i a = x[r];
+            __m256i b = x[r | mask];
+            x[r] = _mm256_unpacklo_epi8(a, b);
+            x[r | mask] = _mm256_unpackhi_epi8(a, b);
+            }
         }
+    }
 
-    int retval = ftruncate(fd, 0);
-    if (retval != 0)
+/** @internal
+    @brief Byte shuffle blocks of 32 elements with AVX2
+
+    Each 128-bit lane shuffles one block of 16 elements with the same rounds as the SSE2 kernel.
+
+    @param dst Output buffer of `count * type_size` bytes.
+    @param src Array to shuffle.
+    @param count Number of elements in *src*.
+    @param type_size Size of one element in bytes.
+    @param start First element to shuffle.
+
+    @returns The first element that was not shuffled.
+*/
+__attribute__((target("avx2"))) static size_t
+gsd_byte_shuffle_avx2(char* dst, const char* src, size_t count, size_t type_size, size_t start)
+    {
+    int t = gsd_shuffle_table_index(type_size);
+    if (t < 0)
         {
-        return GSD_ERROR_IO;
+        return start;
         }
 
-    // populate header fields
-    struct gsd_header header;
-    gsd_util_zero_memory(&header, sizeof(header));
-
-    header.magic = GSD_MAGIC_ID;
-    header.gsd_version = gsd_make_version(GSD_CURRENT_FILE_VERSION, 0);
-    strncpy(header.application, application, sizeof(header.application) - 1);
-    header.application[sizeof(header.application) - 1] = 0;
-    strncpy(header.schema, schema, sizeof(header.schema) - 1);
-    header.schema[sizeof(header.schema) - 1] = 0;
-    header.schema_version = schema_version;
-    header.index_location = sizeof(header);
-    header.index_allocated_entries = GSD_INITIAL_INDEX_SIZE;
-    header.namelist_location
-        = header.index_location + sizeof(struct gsd_index_entry) * header.index_allocated_entries;
-    header.namelist_allocated_entries = GSD_INITIAL_NAME_BUFFER_SIZE / GSD_NAME_SIZE;
-    gsd_util_zero_memory(header.reserved, sizeof(header.reserved));
-
-    // write the header out
-    ssize_t bytes_written = gsd_io_pwrite_retry(fd, &header, sizeof(header), 0);
-    if (bytes_written != sizeof(header))
+    __m256i x[8];
+    size_t e, r, k;
+    for (e = start; e + 32 <= count; e += 32)
         {
-        return GSD_ERROR_IO;
+        const char* block = src + e * type_size;
+        for (r = 0; r < type_size; r++)
+            {
+            __m128i lo = _mm_loadu_si128((const __m128i*)(block + 16 * r));
+            __m128i hi = _mm_loadu_si128((const __m128i*)(block + 16 * (type_size + r)));
+            x[r] = _mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1);
+            }
+        for (k = 0; k < 4; k++)
+            {
+            gsd_avx2_unpack_round(x, type_size, gsd_shuffle_rounds[t][k]);
+            }
+        for (r = 0; r < type_size; r++)
+            {
+            _mm256_storeu_si256((__m256i*)(dst + gsd_shuffle_row[t][r] * count + e), x[r]);
+            }
         }
+    return e;
+    }
 
-    // allocate and zero default index memory
-    struct gsd_index_entry index[GSD_INITIAL_INDEX_SIZE];
-    gsd_util_zero_memory(index, sizeof(index));
-
-    // write the empty index out
-    bytes_written = gsd_io_pwrite_retry(fd, index, sizeof(index), sizeof(header));
-    if (bytes_written != sizeof(index))
-        {
-        return GSD_ERROR_IO;
-        }
+/** @internal
+    @brief Reverse the byte shuffle of blocks of 32 elements with AVX2
 
-    // allocate and zero the namelist memory
-    char names[GSD_INITIAL_NAME_BUFFER_SIZE];
-    gsd_util_zero_memory(names, sizeof(char) * GSD_INITIAL_NAME_BUFFER_SIZE);
+    @param dst Output buffer of `count * type_size` bytes.
+    @param src Shuffled array.
+    @param count Number of elements in *src*.
+    @param type_size Size of one element in bytes.
+    @param start First element to unshuffle.
 
-    // write the namelist out
-    bytes_written = gsd_io_pwrite_retry(fd, names, sizeof(names), sizeof(header) + sizeof(index));
-    if (bytes_written != sizeof(names))
+    @returns The first element that was not unshuffled.
+*/
+__attribute__((target("avx2"))) static size_t
+gsd_byte_unshuffle_avx2(char* dst, const char* src, size_t count, size_t type_size, size_t start)
+    {
+    int t = gsd_shuffle_table_index(type_size);
+    if (t < 0)
         {
-        return GSD_ERROR_IO;
+        return start;
         }
 
-    // sync file
-    retval = fsync(fd);
-    if (retval != 0)
+    __m256i x[8];
+    size_t e, r, k;
+    for (e = start; e + 32 <= count; e += 32)
         {
-        return GSD_ERROR_IO;
+        for (r = 0; r < type_size; r++)
+            {
+            x[r] = _mm256_loadu_si256((const __m256i*)(src + r * count + e));
+            }
+        for (k = 0; k < (size_t)t + 1; k++)
+            {
+            gsd_avx2_unpack_round(x, type_size, gsd_unshuffle_rounds[t][k]);
+            }
+        char* block = dst + e * type_size;
+        for (r = 0; r < type_size; r++)
+            {
+            _mm_storeu_si128((__m128i*)(block + 16 * r), _mm256_castsi256_si128(x[r]));
+            _mm_storeu_si128((__m128i*)(block + 16 * (type_size + r)),
+                             _mm256_extracti128_si256(x[r], 1));
+            }
         }
-
-    return GSD_SUCCESS;
+    return e;
     }
 
 /** @internal
-    @brief Read in the file index and initialize the handle.
+    @brief Transpose the bits of blocks of 32 bytes with AVX2
 
-    @param handle Handle to read the header
+    @param planes Output: 8 bit planes of `count / 8` bytes each.
+    @param row Bytes to transpose.
+    @param count Number of bytes in *row* (a multiple of 8).
+    @param start First byte to transpose (a multiple of 8).
 
-    @pre handle->fd is an open file.
-    @pre handle->open_flags is set.
+    @returns The first byte that was not transposed.
 */
-inline static int gsd_initialize_handle(struct gsd_handle* handle)
+__attribute__((target("avx2"))) static size_t
+gsd_bit_transpose_avx2(char* planes, const char* row, size_t count, size_t start)
     {
-    // check if the file was created
-    if (handle->fd == -1)
+    size_t stride = count / 8;
+    size_t b;
+    int k;
+    for (b = start; b + 32 <= count; b += 32)
         {
-        return GSD_ERROR_IO;
+        __m256i x = _mm256_loadu_si256((const __m256i*)(row + b));
+        for (k = 7; k >= 0; k--)
+            {
+            uint32_t bits = (uint32_t)_mm256_movemask_epi8(x);
+            memcpy(planes + k * stride + b / 8, &bits, sizeof(bits));
+            x = _mm256_add_epi8(x, x);
+            }
         }
+    return b;
+    }
+#endif
 
-    // read the header
-    ssize_t bytes_read
-        = gsd_io_pread_retry(handle->fd, &handle->header, sizeof(struct gsd_header), 0);
-    if (bytes_read == -1)
-        {
-        return GSD_ERROR_IO;
-        }
-    if (bytes_read != sizeof(struct gsd_header))
-        {
-        return GSD_ERROR_NOT_A_GSD_FILE;
-        }
+/** @internal
+    @brief Byte shuffle an array
 
-    // validate the header
-    if (handle->header.magic != GSD_MAGIC_ID)
-        {
-        return GSD_ERROR_NOT_A_GSD_FILE;
-        }
+    Stores the first byte of every element, then the second byte of every element, and so on.
+    Uses the fastest kernel available for the type size and CPU.
 
-    if (handle->header.gsd_version < gsd_make_version(1, 0)
-        && handle->header.gsd_version != gsd_make_version(0, 3))
-        {
-        return GSD_ERROR_INVALID_GSD_FILE_VERSION;
-        }
+    @param dst Output buffer of *n* bytes.
+    @param src Array to shuffle.
+    @param n Number of bytes in *src*.
+    @param type_size Size of one element in bytes.
+*/
+inline static void gsd_byte_shuffle(char* dst, const char* src, size_t n, size_t type_size)
+    {
+    size_t count = n / type_size;
+    size_t start = 0;
 
-    if (handle->header.gsd_version >= gsd_make_version(3, 0))
+#if GSD_USE_AVX2
+    if (gsd_cpu_has_avx2())
         {
-        return GSD_ERROR_INVALID_GSD_FILE_VERSION;
+        start = gsd_byte_shuffle_avx2(dst, src, count, type_size, start);
         }
+#endif
+#if GSD_USE_SSE2
+    start = gsd_byte_shuffle_sse2(dst, src, count, type_size, start);
+#endif
 
-    // determine the file size
-    handle->file_size = lseek(handle->fd, 0, SEEK_END);
+    gsd_byte_shuffle_scalar(dst, src, count, type_size, start);
+    }
 
-    // validate that the namelist block exists inside the file
-    if (handle->header.namelist_location
-            + (GSD_NAME_SIZE * handle->header.namelist_allocated_entries)
-        > (uint64_t)handle->file_size)
-        {
-        return GSD_ERROR_FILE_CORRUPT;
-        }
+/** @internal
+    @brief Reverse gsd_byte_shuffle()
 
-    // allocate the hash map
-    int retval = gsd_name_id_map_allocate(&handle->name_map, GSD_NAME_MAP_SIZE);
-    if (retval != GSD_SUCCESS)
-        {
-        return retval;
-        }
+    @param dst Output buffer of *n* bytes.
+    @param src Shuffled array.
+    @param n Number of bytes in *src*.
+    @param type_size Size of one element in bytes.
+*/
+inline static void gsd_byte_unshuffle(char* dst, const char* src, size_t n, size_t type_size)
+    {
+    size_t count = n / type_size;
+    size_t start = 0;
 
-    // read the namelist block
-    size_t namelist_n_bytes = GSD_NAME_SIZE * handle->header.namelist_allocated_entries;
-    retval = gsd_byte_buffer_allocate(&handle->file_names.data, namelist_n_bytes);
-    if (retval != GSD_SUCCESS)
+#if GSD_USE_AVX2
+    if (gsd_cpu_has_avx2())
         {
-        return retval;
+        start = gsd_byte_unshuffle_avx2(dst, src, count, type_size, start);
         }
-    bytes_read = gsd_io_pread_retry(handle->fd,
-                                    handle->file_names.data.data,
-                                    namelist_n_bytes,
-                                    handle->header.namelist_location);
+#endif
+#if GSD_USE_SSE2
+    start = gsd_byte_unshuffle_sse2(dst, src, count, type_size, start);
+#endif
 
-    if (bytes_read == -1 || bytes_read != namelist_n_bytes)
-        {
-        return GSD_ERROR_IO;
-        }
+    gsd_byte_unshuffle_scalar(dst, src, count, type_size, start);
+    }
 
-    // The name buffer must end in a NULL terminator or else the file is corrupt
-    if (handle->file_names.data.data[handle->file_names.data.reserved - 1] != 0)
+/** @internal
+    @brief Transpose an 8x8 bit matrix
+
+    @param x Matrix with row r in byte r (bits 8r to 8r + 7).
+
+    @returns The transposed matrix.
+*/
+inline static uint64_t gsd_transpose_8x8(uint64_t x)
+    {
+    uint64_t t;
+    t = (x ^ (x >> 7)) & 0x00AA00AA00AA00AAULL;
+    x = x ^ t ^ (t << 7);
+    t = (x ^ (x >> 14)) & 0x0000CCCC0000CCCCULL;
+    x = x ^ t ^ (t << 14);
+    t = (x ^ (x >> 28)) & 0x00000000F0F0F0F0ULL;
+    x = x ^ t ^ (t << 28);
+    return x;
+    }
+
+/** @internal
+    @brief Transpose the bits of a row of bytes into 8 bit planes
+
+    Bit k of byte b is stored in bit b % 8 of byte b / 8 of plane k.
+
+    @param planes Output: 8 bit planes of `count / 8` bytes each.
+    @param row Bytes to transpose.
+    @param count Number of bytes in *row* (a multiple of 8).
+*/
+inline static void gsd_bit_transpose(char* planes, const char* row, size_t count)
+    {
+    size_t stride = count / 8;
+    size_t b = 0;
+
+#if GSD_USE_AVX2
+    if (gsd_cpu_has_avx2())
         {
-        return GSD_ERROR_FILE_CORRUPT;
+        b = gsd_bit_transpose_avx2(planes, row, count, b);
         }
+#endif
+#if GSD_USE_SSE2
+    b = gsd_bit_transpose_sse2(planes, row, count, b);
+#endif
 
-    // Add the names to the hash map. Also determine the number of used bytes in the namelist.
-    size_t name_start = 0;
-    handle->file_names.n_names = 0;
-    while (name_start < handle->file_names.data.reserved)
+    for (; b < count; b += 8)
         {
-        char* name = handle->file_names.data.data + name_start;
-
-        // an empty name notes the end of the list
-        if (name[0] == 0)
+        uint64_t x = 0;
+        int k;
+        for (k = 0; k < 8; k++)
             {
-            break;
+            x |= (uint64_t)(unsigned char)row[b + k] << (8 * k);
             }
-
-        retval
-            = gsd_name_id_map_insert(&handle->name_map, name, (uint16_t)handle->file_names.n_names);
-        if (retval != GSD_SUCCESS)
+        x = gsd_transpose_8x8(x);
+        for (k = 0; k < 8; k++)
             {
-            return retval;
+            planes[k * stride + b / 8] = (char)((x >> (8 * k)) & 0xff);
             }
-        handle->file_names.n_names++;
+        }
+    }
 
-        if (handle->header.gsd_version < gsd_make_version(2, 0))
+/** @internal
+    @brief Reverse gsd_bit_transpose()
+
+    @param row Output bytes.
+    @param planes 8 bit planes of `count / 8` bytes each.
+    @param count Number of bytes in *row* (a multiple of 8).
+*/
+inline static void gsd_bit_untranspose(char* row, const char* planes, size_t count)
+    {
+    size_t stride = count / 8;
+    size_t b = 0;
+
+#if GSD_USE_SSE2
+    b = gsd_bit_untranspose_sse2(row, planes, count, b);
+#endif
+
+    for (; b < count; b += 8)
+        {
+        uint64_t x = 0;
+        int k;
+        for (k = 0; k < 8; k++)
             {
-            // gsd v1 stores names in fixed 64 byte segments
-            name_start += GSD_NAME_SIZE;
+            x |= (uint64_t)(unsigned char)planes[k * stride + b / 8] << (8 * k);
             }
-        else
+        x = gsd_transpose_8x8(x);
+        for (k = 0; k < 8; k++)
             {
-            size_t len = strnlen(name, handle->file_names.data.reserved - name_start);
-            name_start += len + 1;
+            row[b + k] = (char)((x >> (8 * k)) & 0xff);
             }
         }
+    }
 
-    handle->file_names.data.size = name_start;
+/** @internal
+    @brief Bit shuffle an array
 
-    // read in the file index
-    retval = gsd_index_buffer_map(&handle->file_index, handle);
-    if (retval != GSD_SUCCESS)
-        {
-        return retval;
-        }
+    Byte shuffles the elements, then transposes the bits of each byte row so that bit k of byte j of
+    every element is stored together in bit plane 8 * j + k. Elements are shuffled in multiples of
+    8, the remaining elements are copied unchanged to the end of the output.
 
-    // determine the current frame counter
-    if (handle->file_index.size == 0)
+    @param dst Output buffer of *n* bytes.
+    @param src Array to shuffle.
+    @param n Number of bytes in *src*.
+    @param type_size Size of one element in bytes.
+    @param tmp Scratch buffer of *n* bytes.
+*/
+inline static void
+gsd_bit_shuffle(char* dst, const char* src, size_t n, size_t type_size, char* tmp)
+    {
+    size_t count = n / type_size;
+    size_t count8 = count - count % 8;
+    size_t j;
+
+    gsd_byte_shuffle(tmp, src, count8 * type_size, type_size);
+    for (j = 0; j < type_size; j++)
         {
-        handle->cur_frame = 0;
+        gsd_bit_transpose(dst + j * count8, tmp + j * count8, count8);
         }
-    else
+
+    memcpy(dst + count8 * type_size, src + count8 * type_size, (count - count8) * type_size);
+    }
+
+/** @internal
+    @brief Reverse gsd_bit_shuffle()
+
+    @param dst Output buffer of *n* bytes.
+    @param src Shuffled array.
+    @param n Number of bytes in *src*.
+    @param type_size Size of one element in bytes.
+    @param tmp Scratch buffer of *n* bytes.
+*/
+inline static void
+gsd_bit_unshuffle(char* dst, const char* src, size_t n, size_t type_size, char* tmp)
+    {
+    size_t count = n / type_size;
+    size_t count8 = count - count % 8;
+    size_t j;
+
+    for (j = 0; j < type_size; j++)
         {
-        handle->cur_frame = handle->file_index.data[handle->file_index.size - 1].frame + 1;
+        gsd_bit_untranspose(tmp + j * count8, src + j * count8, count8);
         }
+    gsd_byte_unshuffle(dst, tmp, count8 * type_size, type_size);
 
-    // if this is a write mode, allocate the initial frame index and the name buffer
-    if (handle->open_flags != GSD_OPEN_READONLY)
+    memcpy(dst + count8 * type_size, src + count8 * type_size, (count - count8) * type_size);
+    }
+
+/** @internal
+    @brief Check if chunk flags select a filter that changes the data
+
+    @param flags Chunk flags.
+    @param type_size Size of one element in bytes.
+
+    @returns 1 if the data must be filtered, 0 if it is stored as is.
+*/
+inline static int gsd_is_filtered(uint8_t flags, size_t type_size)
+    {
+    return (flags & GSD_FILTER_BITSHUFFLE) || ((flags & GSD_FILTER_SHUFFLE) && type_size > 1);
+    }
+
+/** @internal
+    @brief Apply the shuffle filter selected by the chunk flags
+
+    @param dst Output buffer of *n* bytes.
+    @param src Data to filter.
+    @param n Number of bytes in *src*.
+    @param flags Chunk flags.
+    @param type_size Size of one element in bytes.
+
+    @returns GSD_SUCCESS on success, GSD_ERROR_MEMORY_ALLOCATION_FAILED when allocation fails.
+*/
+inline static int
+gsd_filter(char* dst, const char* src, size_t n, uint8_t flags, size_t type_size)
+    {
+    if (flags & GSD_FILTER_BITSHUFFLE)
         {
-        retval = gsd_index_buffer_allocate(&handle->frame_index, GSD_INITIAL_FRAME_INDEX_SIZE);
-        if (retval != GSD_SUCCESS)
+        char* tmp = malloc(n);
+        if (tmp == NULL)
             {
-            return retval;
+            return GSD_ERROR_MEMORY_ALLOCATION_FAILED;
             }
+        gsd_bit_shuffle(dst, src, n, type_size, tmp);
+        free(tmp);
+        }
+    else
+        {
+        gsd_byte_shuffle(dst, src, n, type_size);
+        }
+    return GSD_SUCCESS;
+    }
 
-        retval = gsd_index_buffer_allocate(&handle->buffer_index, GSD_INITIAL_FRAME_INDEX_SIZE);
-        if (retval != GSD_SUCCESS)
-            {
-            return retval;
-            }
+/** @internal
+    @brief Reverse the shuffle filter selected by the chunk flags
 
-        retval = gsd_byte_buffer_allocate(&handle->write_buffer, GSD_WRITE_BUFFER_SIZE);
-        if (retval != GSD_SUCCESS)
-            {
-            return retval;
-            }
+    @param dst Output buffer of *n* bytes.
+    @param src Filtered data.
+    @param n Number of bytes in *src*.
+    @param flags Chunk flags.
+    @param type_size Size of one element in bytes.
 
-        handle->frame_names.n_names = 0;
-        retval = gsd_byte_buffer_allocate(&handle->frame_names.data, GSD_NAME_SIZE);
-        if (retval != GSD_SUCCESS)
+    @returns GSD_SUCCESS on success, GSD_ERROR_MEMORY_ALLOCATION_FAILED when allocation fails.
+*/
+inline static int
+gsd_unfilter(char* dst, const char* src, size_t n, uint8_t flags, size_t type_size)
+    {
+    if (flags & GSD_FILTER_BITSHUFFLE)
+        {
+        char* tmp = malloc(n);
+        if (tmp == NULL)
             {
-            return retval;
+            return GSD_ERROR_MEMORY_ALLOCATION_FAILED;
             }
+        gsd_bit_unshuffle(dst, src, n, type_size, tmp);
+        free(tmp);
+        }
+    else
+        {
+        gsd_byte_unshuffle(dst, src, n, type_size);
         }
-
     return GSD_SUCCESS;
     }
 
-uint32_t gsd_make_version(unsigned int major, unsigned int minor)
+/** @internal
+    @brief Quantize float data to fixed point values
+
+    Each column is quantized relative to the smallest value in that column, or to -extent/2 when
+    that is smaller. Values are rounded to the nearest multiple of *step*.
+
+    @param[out] out Set to a newly allocated buffer that holds space for a gsd_chunk_header
+    followed by the quantized encoding.
+    @param[out] out_size Set to the number of bytes of the quantized encoding (excluding the
+    space for the chunk header).
+    @param data Data to quantize.
+    @param N Number of rows in *data*.
+    @param M Number of columns in *data*.
+    @param step Distance between adjacent quantized values.
+    @param extent Array of *M* minimum column extents, or NULL.
+
+    @returns GSD_SUCCESS on success, GSD_ERROR_INVALID_ARGUMENT when a value is not finite or a
+    column needs more than GSD_QUANTIZE_MAX_BITS bits, or GSD_ERROR_MEMORY_ALLOCATION_FAILED when
+    allocation fails.
+*/
+inline static int gsd_quantize(char** out,
+                               size_t* out_size,
+                               const float* data,
+                               uint64_t N,
+                               uint32_t M,
+                               double step,
+                               const float* extent)
+    {
+    *out = NULL;
+    *out_size = 0;
+
+    size_t prefix_size = sizeof(struct gsd_chunk_header) + sizeof(struct gsd_quantize_header)
+                         + M * sizeof(struct gsd_quantize_column);
+    struct gsd_quantize_column* columns = malloc(M * sizeof(struct gsd_quantize_column));
+    double* hi = malloc(M * sizeof(double));
+    if (columns == NULL || hi == NULL)
+        {
+        free(columns);
+        free(hi);
+        return GSD_ERROR_MEMORY_ALLOCATION_FAILED;
+        }
+
+    // find the range of each column
+    for (uint32_t c = 0; c < M; c++)
+        {
+        columns[c].origin = data[c];
+        hi[c] = data[c];
+        if (extent != NULL)
+            {
+            if (-0.5 * extent[c] < columns[c].origin)
+                {
+                columns[c].origin = -0.5 * extent[c];
+                }
+            if (0.5 * extent[c] > hi[c])
+                {
+                hi[c] = 0.5 * extent[c];
+                }
+            }
+        }
+
+    for (uint64_t i = 0; i < N; i++)
+        {
+        for (uint32_t c = 0; c < M; c++)
+            {
+            double x = data[i * M + c];
+            if (!(x >= -FLT_MAX && x <= FLT_MAX))
+                {
+                free(columns);
+                free(hi);
+                return GSD_ERROR_INVALID_ARGUMENT;
+                }
+            if (x < columns[c].origin)
+                {
+                columns[c].origin = x;
+                }
+            if (x > hi[c])
+                {
+                hi[c] = x;
+                }
+            }
+        }
+
+    // choose the number of bits needed to represent the range of each column
+    uint64_t row_bits = 0;
+    for (uint32_t c = 0; c < M; c++)
+        {
+        double q_max = (hi[c] - columns[c].origin) / step + 0.5;
+        if (!(q_max < (double)UINT32_MAX))
+            {
+            free(columns);
+            free(hi);
+            return GSD_ERROR_INVALID_ARGUMENT;
+            }
+
+        columns[c].bits = 0;
+        while (((uint64_t)q_max >> columns[c].bits) != 0)
+            {
+            columns[c].bits++;
+            }
+        row_bits += columns[c].bits;
+        }
+    free(hi);
+
+    size_t packed_size = (N * row_bits + 7) / 8;
+    char* buf = malloc(prefix_size + packed_size);
+    if (buf == NULL)
+        {
+        free(columns);
+        return GSD_ERROR_MEMORY_ALLOCATION_FAILED;
+        }
+
+    struct gsd_quantize_header header;
+    header.step = step;
+    header.M = M;
+    memcpy(buf + sizeof(struct gsd_chunk_header), &header, sizeof(struct gsd_quantize_header));
+    memcpy(buf + sizeof(struct gsd_chunk_header) + sizeof(struct gsd_quantize_header),
+           columns,
+           M * sizeof(struct gsd_quantize_column));
+
+    // pack the quantized values
+    char* p = buf + prefix_size;
+    uint64_t acc = 0;
+    unsigned int n_acc = 0;
+    for (uint64_t i = 0; i < N; i++)
+        {
+        for (uint32_t c = 0; c < M; c++)
+            {
+            unsigned int bits = (unsigned int)columns[c].bits;
+            if (bits == 0)
+                {
+                continue;
+                }
+
+            uint64_t mask = ((uint64_t)1 << bits) - 1;
+            uint64_t q = (uint64_t)((data[i * M + c] - columns[c].origin) / step + 0.5);
+            if (q > mask)
+                {
+                q = mask;
+                }
+
+            acc |= q << n_acc;
+            n_acc += bits;
+            if (n_acc >= 32)
+                {
+                uint32_t word = (uint32_t)acc;
+                memcpy(p, &word, sizeof(uint32_t));
+                p += sizeof(uint32_t);
+                acc >>= 32;
+                n_acc -= 32;
+                }
+            }
+        }
+
+    while (n_acc > 0)
+        {
+        *p++ = (char)(acc & 0xff);
+        acc >>= 8;
+        n_acc = n_acc > 8 ? n_acc - 8 : 0;
+        }
+
+    free(columns);
+    *out = buf;
+    *out_size = prefix_size - sizeof(struct gsd_chunk_header) + packed_size;
+    return GSD_SUCCESS;
+    }
+
+/** @internal
+    @brief Convert quantized values back to floats
+
+    @param data Output buffer.
+    @param size Number of bytes in *data*.
+    @param encoded Quantized encoding produced by gsd_quantize().
+    @param encoded_size Number of bytes in *encoded*.
+
+    @returns GSD_SUCCESS on success, GSD_ERROR_FILE_CORRUPT when the encoding is malformed, or
+    GSD_ERROR_MEMORY_ALLOCATION_FAILED when allocation fails.
+*/
+inline static int
+gsd_dequantize(float* data, size_t size, const char* encoded, size_t encoded_size)
+    {
+    struct gsd_quantize_header header;
+    if (encoded_size < sizeof(struct gsd_quantize_header))
+        {
+        return GSD_ERROR_FILE_CORRUPT;
+        }
+    memcpy(&header, encoded, sizeof(struct gsd_quantize_header));
+    encoded += sizeof(struct gsd_quantize_header);
+    encoded_size -= sizeof(struct gsd_quantize_header);
+
+    if (header.M == 0 || header.M > encoded_size / sizeof(struct gsd_quantize_column)
+        || size % (header.M * sizeof(float)) != 0)
+        {
+        return GSD_ERROR_FILE_CORRUPT;
+        }
+    size_t M = header.M;
+    size_t N = size / (M * sizeof(float));
+
+    struct gsd_quantize_column* columns = malloc(M * sizeof(struct gsd_quantize_column));
+    if (columns == NULL)
+        {
+        return GSD_ERROR_MEMORY_ALLOCATION_FAILED;
+        }
+    memcpy(columns, encoded, M * sizeof(struct gsd_quantize_column));
+    encoded += M * sizeof(struct gsd_quantize_column);
+    encoded_size -= M * sizeof(struct gsd_quantize_column);
+
+    uint64_t row_bits = 0;
+    for (size_t c = 0; c < M; c++)
+        {
+        if (columns[c].bits > GSD_QUANTIZE_MAX_BITS)
+            {
+            free(columns);
+            return GSD_ERROR_FILE_CORRUPT;
+            }
+        row_bits += columns[c].bits;
+        }
+    if ((N * row_bits + 7) / 8 != encoded_size)
+        {
+        free(columns);
+        return GSD_ERROR_FILE_CORRUPT;
+        }
+
+    const unsigned char* p = (const unsigned char*)encoded;
+    const unsigned char* end = p + encoded_size;
+    uint64_t acc = 0;
+    unsigned int n_acc = 0;
+    for (size_t i = 0; i < N; i++)
+        {
+        for (size_t c = 0; c < M; c++)
+            {
+            unsigned int bits = (unsigned int)columns[c].bits;
+            uint64_t q = 0;
+            if (bits > 0)
+                {
+                if (n_acc < bits && end - p >= (ptrdiff_t)sizeof(uint32_t))
+                    {
+                    uint32_t word;
+                    memcpy(&word, p, sizeof(uint32_t));
+                    p += sizeof(uint32_t);
+                    acc |= (uint64_t)word << n_acc;
+                    n_acc += 32;
+                    }
+                while (n_acc < bits)
+                    {
+                    acc |= (uint64_t)(*p++) << n_acc;
+                    n_acc += 8;
+                    }
+
+                q = acc & (((uint64_t)1 << bits) - 1);
+                acc >>= bits;
+                n_acc -= bits;
+                }
+
+            data[i * M + c] = (float)(columns[c].origin + (double)q * header.step);
+            }
+        }
+
+    free(columns);
+    return GSD_SUCCESS;
+    }
+
+/** @internal
+    @brief Compress chunk data
+
+    @param[out] out Set to a newly allocated buffer holding the chunk header and the encoded data,
+    or NULL when compression does not reduce the size of the data.
+    @param[out] out_size Set to the number of bytes in *out*.
+    @param data Data to compress.
+    @param size Number of bytes in *data*.
+    @param flags Chunk flags that select the codec and filters.
+    @param type_size Size of one element of *data* in bytes.
+
+    @returns GSD_SUCCESS on success, GSD_ERROR_MEMORY_ALLOCATION_FAILED when allocation fails.
+*/
+inline static int gsd_encode_chunk(char** out,
+                                   size_t* out_size,
+                                   const char* data,
+                                   size_t size,
+                                   uint8_t flags,
+                                   size_t type_size)
+    {
+    *out = NULL;
+    *out_size = 0;
+
+    if (size <= sizeof(struct gsd_chunk_header))
+        {
+        return GSD_SUCCESS;
+        }
+
+    char* filtered = NULL;
+    const char* input = data;
+    if (gsd_is_filtered(flags, type_size))
+        {
+        filtered = malloc(size);
+        if (filtered == NULL)
+            {
+            return GSD_ERROR_MEMORY_ALLOCATION_FAILED;
+            }
+        int retval = gsd_filter(filtered, data, size, flags, type_size);
+        if (retval != GSD_SUCCESS)
+            {
+            free(filtered);
+            return retval;
+            }
+        input = filtered;
+        }
+
+    // only keep the compressed data when it is smaller than the raw data
+    size_t capacity = size - sizeof(struct gsd_chunk_header) - 1;
+    char* buf = malloc(sizeof(struct gsd_chunk_header) + capacity);
+    if (buf == NULL)
+        {
+        free(filtered);
+        return GSD_ERROR_MEMORY_ALLOCATION_FAILED;
+        }
+
+    const struct gsd_codec* codec = &gsd_codecs[flags & GSD_COMPRESSION_MASK];
+    size_t stored_size
+        = codec->compress(buf + sizeof(struct gsd_chunk_header), capacity, input, size);
+    free(filtered);
+
+    if (stored_size == 0)
+        {
+        free(buf);
+        return GSD_SUCCESS;
+        }
+
+    struct gsd_chunk_header header;
+    header.stored_size = stored_size;
+    header.data_size = size;
+    memcpy(buf, &header, sizeof(struct gsd_chunk_header));
+
+    *out = buf;
+    *out_size = sizeof(struct gsd_chunk_header) + stored_size;
+    return GSD_SUCCESS;
+    }
+
+/** @internal
+    @brief Decompress chunk data
+
+    @param data Output buffer.
+    @param size Number of bytes in *data*.
+    @param encoded Encoded data that follows the chunk header.
+    @param header Chunk header.
+    @param flags Chunk flags that select the codec and filters.
+    @param type_size Size of one element of *data* in bytes.
+
+    @returns GSD_SUCCESS on success, GSD_ERROR_FILE_CORRUPT when the encoded data is malformed, or
+    GSD_ERROR_MEMORY_ALLOCATION_FAILED when allocation fails.
+*/
+inline static int gsd_decode_chunk(char* data,
+                                   size_t size,
+                                   const char* encoded,
+                                   const struct gsd_chunk_header* header,
+                                   uint8_t flags,
+                                   size_t type_size)
+    {
+    if (!gsd_is_flags_valid(flags))
+        {
+        return GSD_ERROR_FILE_CORRUPT;
+        }
+
+    const struct gsd_codec* codec = &gsd_codecs[flags & GSD_COMPRESSION_MASK];
+    if (flags & GSD_FILTER_QUANTIZE)
+        {
+        // quantized values take at most 32 bits and each column adds one column header
+        if (type_size != sizeof(float)
+            || header->data_size > sizeof(struct gsd_quantize_header) + size * 5)
+            {
+            return GSD_ERROR_FILE_CORRUPT;
+            }
+
+        char* quantized = malloc(header->data_size > 0 ? header->data_size : 1);
+        if (quantized == NULL)
+            {
+            return GSD_ERROR_MEMORY_ALLOCATION_FAILED;
+            }
+
+        int retval
+            = codec->decompress(quantized, header->data_size, encoded, header->stored_size);
+        if (retval == GSD_SUCCESS)
+            {
+            retval = gsd_dequantize((float*)data, size, quantized, header->data_size);
+            }
+
+        free(quantized);
+        return retval;
+        }
+
+    if (header->data_size != size)
+        {
+        return GSD_ERROR_FILE_CORRUPT;
+        }
+
+    if (!gsd_is_filtered(flags, type_size))
+        {
+        return codec->decompress(data, size, encoded, header->stored_size);
+        }
+
+    char* filtered = malloc(size);
+    if (filtered == NULL)
+        {
+        return GSD_ERROR_MEMORY_ALLOCATION_FAILED;
+        }
+
+    int retval = codec->decompress(filtered, size, encoded, header->stored_size);
+    if (retval == GSD_SUCCESS)
+        {
+        retval = gsd_unfilter(data, filtered, size, flags, type_size);
+        }
+
+    free(filtered);
+    return retval;
+    }
+
+/** @internal
+    @brief Read and decompress a chunk with non-zero flags
+
+    @param handle Handle to the open gsd file.
+    @param data Output buffer.
+    @param size Number of bytes in *data*.
+    @param chunk Chunk to read.
+
+    @returns GSD_SUCCESS on success or an error code on failure.
+*/
+inline static int gsd_read_encoded_chunk(struct gsd_handle* handle,
+                                         void* data,
+                                         size_t size,
+                                         const struct gsd_index_entry* chunk)
+    {
+    struct gsd_chunk_header header;
+    if ((chunk->location + sizeof(struct gsd_chunk_header)) > (uint64_t)handle->file_size)
+        {
+        return GSD_ERROR_FILE_CORRUPT;
+        }
+
+    ssize_t bytes_read
+        = gsd_io_pread_retry(handle->fd, &header, sizeof(struct gsd_chunk_header), chunk->location);
+    if (bytes_read == -1 || bytes_read != sizeof(struct gsd_chunk_header))
+        {
+        return GSD_ERROR_IO;
+        }
+
+    int64_t encoded_location = chunk->location + sizeof(struct gsd_chunk_header);
+    if (header.stored_size > (uint64_t)(handle->file_size - encoded_location))
+        {
+        return GSD_ERROR_FILE_CORRUPT;
+        }
+
+    char* encoded = malloc(header.stored_size > 0 ? header.stored_size : 1);
+    if (encoded == NULL)
+        {
+        return GSD_ERROR_MEMORY_ALLOCATION_FAILED;
+        }
+
+    bytes_read = gsd_io_pread_retry(handle->fd, encoded, header.stored_size, encoded_location);
+    if (bytes_read == -1 || (uint64_t)bytes_read != header.stored_size)
+        {
+        free(encoded);
+        return GSD_ERROR_IO;
+        }
+
+    int retval = gsd_decode_chunk(data,
+                                  size,
+                                  encoded,
+                                  &header,
+                                  chunk->flags,
+                                  gsd_sizeof_type((enum gsd_type)chunk->type));
+    free(encoded);
+    return retval;
+    }
+
+/** @internal
+    @brief Utility function to validate index entry
+    @param handle handle to the open gsd file
+    @param idx index of entry to validate
+
+    @returns 1 if the entry is valid, 0 if it is not
+*/
+inline static int gsd_is_entry_valid(struct gsd_handle* handle, size_t idx)
+    {
+    const struct gsd_index_entry entry = handle->file_index.data[idx];
+
+    // check for valid type
+    if (gsd_sizeof_type((enum gsd_type)entry.type) == 0)
+        {
+        return 0;
+        }
+
+    // check for valid flags
+    if (!gsd_is_flags_valid(entry.flags))
+        {
+        return 0;
+        }
+
+    // only float chunks may be quantized
+    if ((entry.flags & GSD_FILTER_QUANTIZE) && entry.type != GSD_TYPE_FLOAT)
+        {
+        return 0;
+        }
+
+    // validate that we don't read past the end of the file (compressed chunks are checked on read)
+    size_t size = entry.N * entry.M * gsd_sizeof_type((enum gsd_type)entry.type);
+    if (entry.flags != 0)
+        {
+        size = sizeof(struct gsd_chunk_header);
+        }
+    if ((entry.location + size) > (uint64_t)handle->file_size)
+        {
+        return 0;
+        }
+
+    // check for valid frame (frame cannot be more than the number of index entries)
+    if (entry.frame >= handle->header.index_allocated_entries)
+        {
+        return 0;
+        }
+
+    // check for valid id, entries in the file index only refer to names written to the file (the
+    // background writer may call this while the caller adds names to frame_names)
+    if (entry.id >= handle->file_names.n_names)
+        {
+        return 0;
+        }
+
+    return 1;
+    }
+
+/** @internal
+    @brief Allocate a write buffer
+
+    @param buf Buffer to allocate.
+    @param reserve Number of bytes to allocate.
+
+    @returns GSD_SUCCESS on success, GSD_* error codes on error.
+*/
+inline static int gsd_byte_buffer_allocate(struct gsd_byte_buffer* buf, size_t reserve)
+    {
+    if (buf == NULL || buf->data || reserve == 0 || buf->reserved != 0 || buf->size != 0)
+        {
+        return GSD_ERROR_INVALID_ARGUMENT;
+        }
+
+    buf->data = calloc(reserve, sizeof(char));
+    if (buf->data == NULL)
+        {
+        return GSD_ERROR_MEMORY_ALLOCATION_FAILED;
+        }
+
+    buf->size = 0;
+    buf->reserved = reserve;
+
+    return GSD_SUCCESS;
+    }
+
+/** @internal
+    @brief Append bytes to a byte buffer
+
+    @param buf Buffer to append to.
+    @param data Data to append.
+    @param size Number of bytes in *data*.
+
+    @returns GSD_SUCCESS on success, GSD_* error codes on error.
+*/
+inline static int gsd_byte_buffer_append(struct gsd_byte_buffer* buf, const char* data, size_t size)
+    {
+    if (buf == NULL || buf->data == NULL || size == 0 || buf->reserved == 0)
+        {
+        return GSD_ERROR_INVALID_ARGUMENT;
+        }
+
+    if (buf->size + size > buf->reserved)
+        {
+        // reallocate by doubling
+        size_t new_reserved = buf->reserved * 2;
+        while (buf->size + size >= new_reserved)
+            {
+            new_reserved = new_reserved * 2;
+            }
+
+        char* old_data = buf->data;
+        buf->data = realloc(buf->data, sizeof(char) * new_reserved);
+        if (buf->data == NULL)
+            {
+            // this free should not be necessary, but clang-tidy disagrees
+            free(old_data);
+            return GSD_ERROR_MEMORY_ALLOCATION_FAILED;
+            }
+
+        // zero the new memory, but only the portion after the end of the new section to be appended
+        gsd_util_zero_memory(buf->data + (buf->size + size),
+                             sizeof(char) * (new_reserved - (buf->size + size)));
+        buf->reserved = new_reserved;
+        }
+
+    memcpy(buf->data + buf->size, data, size);
+    buf->size += size;
+
+    return GSD_SUCCESS;
+    }
+
+/** @internal
+    @brief Free the memory allocated by the write buffer or unmap the mapped memory.
+
+    @param buf Buffer to free.
+
+    @returns GSD_SUCCESS on success, GSD_* error codes on error.
+*/
+inline static int gsd_byte_buffer_free(struct gsd_byte_buffer* buf)
+    {
+    if (buf == NULL || buf->data == NULL)
+        {
+        return GSD_ERROR_INVALID_ARGUMENT;
+        }
+
+    free(buf->data);
+
+    gsd_util_zero_memory(buf, sizeof(struct gsd_byte_buffer));
+    return GSD_SUCCESS;
+    }
+
+/** @internal
+    @brief Allocate a buffer of index entries
+
+    @param buf Buffer to allocate.
+    @param reserve Number of entries to allocate.
+
+    @post The buffer's data element has *reserve* elements allocated in memory.
+
+    @returns GSD_SUCCESS on success, GSD_* error codes on error.
+*/
+inline static int gsd_index_buffer_allocate(struct gsd_index_buffer* buf, size_t reserve)
+    {
+    if (buf == NULL || buf->mapped_data || buf->data || reserve == 0 || buf->reserved != 0
+        || buf->size != 0)
+        {
+        return GSD_ERROR_INVALID_ARGUMENT;
+        }
+
+    buf->data = calloc(reserve, sizeof(struct gsd_index_entry));
+    if (buf->data == NULL)
+        {
+        return GSD_ERROR_MEMORY_ALLOCATION_FAILED;
+        }
+
+    buf->size = 0;
+    buf->reserved = reserve;
+    buf->mapped_data = NULL;
+    buf->mapped_len = 0;
+
+    return GSD_SUCCESS;
+    }
+
+/** @internal
+    @brief Map index entries from the file
+
+    @param buf Buffer to map.
+    @param handle GSD file handle to map.
+
+    @post The buffer's data element contains the index data from the file.
+
+    On some systems, this will use mmap to efficiently access the file. On others, it may result in
+    an allocation and read of the entire index from the file.
+
+    @returns GSD_SUCCESS on success, GSD_* error codes on error.
+*/
+inline static int gsd_index_buffer_map(struct gsd_index_buffer* buf, struct gsd_handle* handle)
+    {
+    if (buf == NULL || buf->mapped_data || buf->data || buf->reserved != 0 || buf->size != 0)
+        {
+        return GSD_ERROR_INVALID_ARGUMENT;
+        }
+
+    // validate that the index block exists inside the file
+    if (handle->header.index_location
+            + sizeof(struct gsd_index_entry) * handle->header.index_allocated_entries
+        > (uint64_t)handle->file_size)
+        {
+        return GSD_ERROR_FILE_CORRUPT;
+        }
+
+#if GSD_USE_MMAP
+    // map the index in read only mode
+    size_t page_size = getpagesize();
+    size_t index_size = sizeof(struct gsd_index_entry) * handle->header.index_allocated_entries;
+    size_t offset = (handle->header.index_location / page_size) * page_size;
+    buf->mapped_data = mmap(NULL,
+                            index_size + (handle->header.index_location - offset),
+                            PROT_READ,
+                            MAP_SHARED,
+                            handle->fd,
+                            offset);
+
+    if (buf->mapped_data == MAP_FAILED)
+        {
+        return GSD_ERROR_IO;
+        }
+
+    buf->data = (struct gsd_index_entry*)(((char*)buf->mapped_data)
+                                          + (handle->header.index_location - offset));
+
+    buf->mapped_len = index_size + (handle->header.index_location - offset);
+    buf->reserved = handle->header.index_allocated_entries;
+#else
+    // mmap not supported, read the data from the disk
+    int retval = gsd_index_buffer_allocate(buf, handle->header.index_allocated_entries);
+    if (retval != GSD_SUCCESS)
+        {
+        return retval;
+        }
+
+    ssize_t bytes_read = gsd_io_pread_retry(handle->fd,
+                                            buf->data,
+                                            sizeof(struct gsd_index_entry)
+                                                * handle->header.index_allocated_entries,
+                                            handle->header.index_location);
+
+    if (bytes_read == -1
+        || bytes_read != sizeof(struct gsd_index_entry) * handle->header.index_allocated_entries)
+        {
+        return GSD_ERROR_IO;
+        }
+#endif
+
+    // determine the number of index entries in the list
+    // file is corrupt if first index entry is invalid
+    if (buf->data[0].location != 0 && !gsd_is_entry_valid(handle, 0))
+        {
+        return GSD_ERROR_FILE_CORRUPT;
+        }
+
+    if (buf->data[0].location == 0)
+        {
+        buf->size = 0;
+        }
+    else
+        {
+        // determine the number of index entries (marked by location = 0)
+        // binary search for the first index entry with location 0
+        size_t L = 0;
+        size_t R = buf->reserved;
+
+        // progressively narrow the search window by halves
+        do
+            {
+            size_t m = (L + R) / 2;
+
+            // file is corrupt if any index entry is invalid or frame does not increase
+            // monotonically
+            if (buf->data[m].location != 0
+                && (!gsd_is_entry_valid(handle, m) || buf->data[m].frame < buf->data[L].frame))
+                {
+                return GSD_ERROR_FILE_CORRUPT;
+                }
+
+            if (buf->data[m].location != 0)
+                {
+                L = m;
+                }
+            else
+                {
+                R = m;
+                }
+            } while ((R - L) > 1);
+
+        // this finds R = the first index entry with location = 0
+        buf->size = R;
+        }
+
+    return GSD_SUCCESS;
+    }
+
+/** @internal
+    @brief Free the memory allocated by the index buffer or unmap the mapped memory.
+
+    @param buf Buffer to free.
+
+    @returns GSD_SUCCESS on success, GSD_* error codes on error.
+*/
+inline static int gsd_index_buffer_free(struct gsd_index_buffer* buf)
+    {
+    if (buf == NULL || buf->data == NULL)
+        {
+        return GSD_ERROR_INVALID_ARGUMENT;
+        }
+
+#if GSD_USE_MMAP
+    if (buf->mapped_data)
+        {
+        int retval = munmap(buf->mapped_data, buf->mapped_len);
+
+        if (retval != 0)
+            {
+            return GSD_ERROR_IO;
+            }
+        }
+    else
+#endif
+        {
+        free(buf->data);
+        }
+
+    gsd_util_zero_memory(buf, sizeof(struct gsd_index_buffer));
+    return GSD_SUCCESS;
+    }
+
+/** @internal
+    @brief Free the frame table
+
+    @param table Table to free.
+*/
+inline static void gsd_frame_table_free(struct gsd_frame_table* table)
+    {
+    free(table->start);
+    table->start = NULL;
+    table->reserved = 0;
+    }
+
+/** @internal
+    @brief Find the first index entry at or after a frame
+
+    @param index Index sorted by frame.
+    @param frame Frame to search for.
+    @param L Position to start the search at.
+
+    @returns The position of the first entry in *index* after *L* with a frame of at least *frame*,
+    or the size of the index when there is no such entry.
+*/
+inline static size_t
+gsd_index_lower_bound(const struct gsd_index_buffer* index, uint64_t frame, size_t L)
+    {
+    size_t R = index->size;
+    while (L < R)
+        {
+        size_t m = L + (R - L) / 2;
+        if (index->data[m].frame < frame)
+            {
+            L = m + 1;
+            }
+        else
+            {
+            R = m;
+            }
+        }
+    return L;
+    }
+
+/** @internal
+    @brief Free the search tree
+
+    @param tree Tree to free.
+*/
+inline static void gsd_search_tree_free(struct gsd_search_tree* tree)
+    {
+    free(tree->frame);
+    free(tree->position);
+    gsd_util_zero_memory(tree, sizeof(struct gsd_search_tree));
+    }
+
+/** @internal
+    @brief Fill a subtree of the search tree with samples of the file index
+
+    Visits the subtree in order, so consecutive samples are read from increasing positions.
+
+    @param tree Tree to fill.
+    @param index File index to sample.
+    @param k Root of the subtree.
+    @param i Number of the next sample.
+
+    @returns The number of the sample after the last sample in the subtree.
+*/
+static size_t gsd_search_tree_fill(struct gsd_search_tree* tree,
+                                   const struct gsd_index_buffer* index,
+                                   size_t k,
+                                   size_t i)
+    {
+    if (k <= tree->size)
+        {
+        i = gsd_search_tree_fill(tree, index, 2 * k, i);
+        tree->position[k] = (uint64_t)i * GSD_SEARCH_TREE_STRIDE;
+        tree->frame[k] = index->data[tree->position[k]].frame;
+        i = gsd_search_tree_fill(tree, index, 2 * k + 1, i + 1);
+        }
+    return i;
+    }
+
+/** @internal
+    @brief Find the first index entry at or after a frame
+
+    Uses the search tree to narrow the search to the entries between two samples when the tree
+    has been built.
+
+    @param handle Handle to the open gsd file.
+    @param frame Frame to search for.
+    @param L Position to start the search at.
+
+    @returns The position of the first entry in the file index after *L* with a frame of at least
+    *frame*, or the size of the index when there is no such entry.
+*/
+inline static size_t gsd_frame_lower_bound(struct gsd_handle* handle, uint64_t frame, size_t L)
+    {
+    const struct gsd_search_tree* tree = &handle->search_tree;
+    if (tree->frame == NULL)
+        {
+        return gsd_index_lower_bound(&handle->file_index, frame, L);
+        }
+
+    // descend the tree, prefetching the 16 descendants 4 levels below the current node
+    size_t k = 1;
+    while (k <= tree->size)
+        {
+        GSD_PREFETCH((uintptr_t)tree->frame + 16 * sizeof(uint64_t) * k);
+        GSD_PREFETCH((uintptr_t)tree->frame + 16 * sizeof(uint64_t) * k + 64);
+        k = 2 * k + (tree->frame[k] < frame);
+        }
+
+    // undo the right turns after the last left turn to find the first sample at or after frame
+    while (k & 1)
+        {
+        k >>= 1;
+        }
+    k >>= 1;
+
+    // the lower bound is after the preceding sample and at or before this one
+    size_t sample_L;
+    size_t sample_R;
+    if (k == 0)
+        {
+        sample_L = (tree->size - 1) * GSD_SEARCH_TREE_STRIDE + 1;
+        sample_R = handle->file_index.size;
+        }
+    else
+        {
+        sample_R = tree->position[k];
+        sample_L = sample_R >= GSD_SEARCH_TREE_STRIDE ? sample_R - GSD_SEARCH_TREE_STRIDE + 1 : 0;
+        }
+
+    if (L < sample_L)
+        {
+        L = sample_L;
+        }
+    while (L < sample_R)
+        {
+        size_t m = L + (sample_R - L) / 2;
+        if (handle->file_index.data[m].frame < frame)
+            {
+            L = m + 1;
+            }
+        else
+            {
+            sample_R = m;
+            }
+        }
+    return L;
+    }
+
+/** @internal
+    @brief Find the range of index entries of a frame
+
+    Looks up the positions of the frame in the frame table and fills in unknown positions by
+    searching the file index. The positions remain valid when frames are appended to the index.
+
+    @param handle Handle to the open gsd file.
+    @param frame Frame to find (must be less than the number of frames in the file index).
+    @param begin [out] Position of the first entry of the frame.
+    @param end [out] Position after the last entry of the frame.
+*/
+inline static void
+gsd_find_frame(struct gsd_handle* handle, uint64_t frame, size_t* begin, size_t* end)
+    {
+    struct gsd_frame_table* table = &handle->frame_table;
+
+    if (frame + 2 > table->reserved)
+        {
+        size_t new_reserved = table->reserved * 2;
+        if (new_reserved < gsd_get_nframes(handle) + 1)
+            {
+            new_reserved = gsd_get_nframes(handle) + 1;
+            }
+        if (new_reserved < frame + 2)
+            {
+            new_reserved = frame + 2;
+            }
+
+        uint64_t* new_start = realloc(table->start, sizeof(uint64_t) * new_reserved);
+        if (new_start == NULL)
+            {
+            // search without the table
+            *begin = gsd_frame_lower_bound(handle, frame, 0);
+            *end = gsd_frame_lower_bound(handle, frame + 1, *begin);
+            return;
+            }
+
+        size_t i;
+        for (i = table->reserved; i < new_reserved; i++)
+            {
+            new_start[i] = UINT64_MAX;
+            }
+        table->start = new_start;
+        table->reserved = new_reserved;
+        }
+
+    if (table->start[frame] == UINT64_MAX)
+        {
+        table->start[frame] = gsd_frame_lower_bound(handle, frame, 0);
+        }
+    if (table->start[frame + 1] == UINT64_MAX)
+        {
+        table->start[frame + 1]
+            = gsd_frame_lower_bound(handle, frame + 1, table->start[frame]);
+        }
+
+    *begin = table->start[frame];
+    *end = table->start[frame + 1];
+    }
+
+/** @internal
+    @brief Free the chunk history
+
+    @param history History to free.
+*/
+inline static void gsd_chunk_history_free(struct gsd_chunk_history* history)
+    {
+    size_t i;
+    for (i = 0; i < history->n_lists; i++)
+        {
+        free(history->lists[i].position);
+        }
+    free(history->lists);
+    gsd_util_zero_memory(history, sizeof(struct gsd_chunk_history));
+    }
+
+/** @internal
+    @brief Add the entries of the file index that are not yet in the chunk history
+
+    @param handle Handle to the open gsd file.
+
+    Frames are only appended to the file index, so the lists remain sorted by frame.
+
+    @returns GSD_SUCCESS on success, GSD_* error codes on error.
+*/
+inline static int gsd_chunk_history_update(struct gsd_handle* handle)
+    {
+    struct gsd_chunk_history* history = &handle->chunk_history;
+    const struct gsd_index_buffer* index = &handle->file_index;
+
+    for (; history->n_indexed < index->size; history->n_indexed++)
+        {
+        uint16_t id = index->data[history->n_indexed].id;
+
+        if (id >= history->n_lists)
+            {
+            size_t new_n_lists = (size_t)id + 1;
+            if (new_n_lists < handle->file_names.n_names)
+                {
+                new_n_lists = handle->file_names.n_names;
+                }
+
+            struct gsd_chunk_list* new_lists
+                = realloc(history->lists, sizeof(struct gsd_chunk_list) * new_n_lists);
+            if (new_lists == NULL)
+                {
+                return GSD_ERROR_MEMORY_ALLOCATION_FAILED;
+                }
+            gsd_util_zero_memory(new_lists + history->n_lists,
+                                 sizeof(struct gsd_chunk_list) * (new_n_lists - history->n_lists));
+            history->lists = new_lists;
+            history->n_lists = new_n_lists;
+            }
+
+        struct gsd_chunk_list* list = &history->lists[id];
+        if (list->size == list->reserved)
+            {
+            size_t new_reserved = list->reserved * 2;
+            if (new_reserved == 0)
+                {
+                new_reserved = 16;
+                }
+
+            uint64_t* new_position = realloc(list->position, sizeof(uint64_t) * new_reserved);
+            if (new_position == NULL)
+                {
+                return GSD_ERROR_MEMORY_ALLOCATION_FAILED;
+                }
+            list->position = new_position;
+            list->reserved = new_reserved;
+            }
+
+        list->position[list->size] = history->n_indexed;
+        list->size++;
+        }
+
+    return GSD_SUCCESS;
+    }
+
+/** @internal
+    @brief Add a new index entry and provide a pointer to it.
+
+    @param buf Buffer to add too.
+    @param entry [out] Pointer to set to the new entry.
+
+    Double the size of the reserved space as needed to hold the new entry. Does not accept mapped
+    indices.
+
+    @returns GSD_SUCCESS on success, GSD_* error codes on error.
+*/
+inline static int gsd_index_buffer_add(struct gsd_index_buffer* buf, struct gsd_index_entry** entry)
+    {
+    if (buf == NULL || buf->mapped_data || entry == NULL || buf->reserved == 0)
+        {
+        return GSD_ERROR_INVALID_ARGUMENT;
+        }
+
+    if (buf->size == buf->reserved)
+        {
+        // grow the array
+        size_t new_reserved = buf->reserved * 2;
+        buf->data = realloc(buf->data, sizeof(struct gsd_index_entry) * new_reserved);
+        if (buf->data == NULL)
+            {
+            return GSD_ERROR_MEMORY_ALLOCATION_FAILED;
+            }
+
+        // zero the new memory
+        gsd_util_zero_memory(buf->data + buf->reserved,
+                             sizeof(struct gsd_index_entry) * (new_reserved - buf->reserved));
+        buf->reserved = new_reserved;
+        }
+
+    size_t insert_pos = buf->size;
+    buf->size++;
+    *entry = buf->data + insert_pos;
+
+    return GSD_SUCCESS;
+    }
+
+inline static int gsd_cmp_index_entry(const struct gsd_index_entry* a,
+                                      const struct gsd_index_entry* b)
+    {
+    int result = 0;
+
+    if (a->frame < b->frame)
+        {
+        result = -1;
+        }
+
+    if (a->frame > b->frame)
+        {
+        result = 1;
+        }
+
+    if (a->frame == b->frame)
+        {
+        if (a->id < b->id)
+            {
+            result = -1;
+            }
+
+        if (a->id > b->id)
+            {
+            result = 1;
+            }
+
+        if (a->id == b->id)
+            {
+            result = 0;
+            }
+        }
+
+    return result;
+    }
+
+/** @internal
+    @brief Compute heap parent node.
+    @param i Node index.
+*/
+inline static size_t gsd_heap_parent(size_t i)
+    {
+    return (i - 1) / 2;
+    }
+
+/** @internal
+    @brief Compute heap left child.
+    @param i Node index.
+*/
+inline static size_t gsd_heap_left_child(size_t i)
+    {
+    return 2 * i + 1;
+    }
+
+/** @internal
+    @brief Swap the nodes *a* and *b* in the buffer
+    @param buf Buffer.
+    @param a First index to swap.
+    @param b Second index to swap.
+*/
+inline static void gsd_heap_swap(struct gsd_index_buffer* buf, size_t a, size_t b)
+    {
+    struct gsd_index_entry tmp = buf->data[a];
+    buf->data[a] = buf->data[b];
+    buf->data[b] = tmp;
+    }
+
+/** @internal
+    @brief Shift heap node downward
+    @param buf Buffer.
+    @param start First index of the valid heap in *buf*.
+    @param end Last index of the valid hep in *buf*.
+*/
+inline static void gsd_heap_shift_down(struct gsd_index_buffer* buf, size_t start, size_t end)
+    {
+    size_t root = start;
+
+    while (gsd_heap_left_child(root) <= end)
+        {
+        size_t child = gsd_heap_left_child(root);
+        size_t swap = root;
+
+        if (gsd_cmp_index_entry(buf->data + swap, buf->data + child) < 0)
+            {
+            swap = child;
+            }
+        if (child + 1 <= end && gsd_cmp_index_entry(buf->data + swap, buf->data + child + 1) < 0)
+            {
+            swap = child + 1;
+            }
+
+        if (swap == root)
+            {
+            return;
+            }
+
+        gsd_heap_swap(buf, root, swap);
+        root = swap;
+        }
+    }
+
+/** @internal
+    @brief Convert unordered index buffer to a heap
+    @param buf Buffer.
+*/
+inline static void gsd_heapify(struct gsd_index_buffer* buf)
+    {
+    ssize_t start = gsd_heap_parent(buf->size - 1);
+
+    while (start >= 0)
+        {
+        gsd_heap_shift_down(buf, start, buf->size - 1);
+        start--;
+        }
+    }
+
+/** @internal
+    @brief Sort the index buffer.
+
+    @param buf Buffer to sort.
+
+    Sorts an in-memory index buffer. Does not accept mapped indices.
+
+    @returns GSD_SUCCESS on success, GSD_* error codes on error.
+*/
+inline static int gsd_index_buffer_sort(struct gsd_index_buffer* buf)
+    {
+    if (buf == NULL || buf->mapped_data || buf->reserved == 0)
+        {
+        return GSD_ERROR_INVALID_ARGUMENT;
+        }
+
+    // arrays of size 0 or 1 are already sorted
+    if (buf->size <= 1)
+        {
+        return GSD_SUCCESS;
+        }
+
+    gsd_heapify(buf);
+
+    size_t end = buf->size - 1;
+    while (end > 0)
+        {
+        gsd_heap_swap(buf, end, 0);
+        end = end - 1;
+        gsd_heap_shift_down(buf, 0, end);
+        }
+
+    return GSD_SUCCESS;
+    }
+
+/** @internal
+    @brief Compare the file locations of the chunks in two chunk requests.
+
+    @param a Pointer to the first `struct gsd_chunk_request*`.
+    @param b Pointer to the second `struct gsd_chunk_request*`.
+
+    Comparison function for qsort().
+*/
+static int gsd_cmp_chunk_request_location(const void* a, const void* b)
+    {
+    const struct gsd_chunk_request* request_a = *(const struct gsd_chunk_request* const*)a;
+    const struct gsd_chunk_request* request_b = *(const struct gsd_chunk_request* const*)b;
+
+    if (request_a->chunk->location < request_b->chunk->location)
+        {
+        return -1;
+        }
+    if (request_a->chunk->location > request_b->chunk->location)
+        {
+        return 1;
+        }
+    return 0;
+    }
+
+/** @internal
+    @brief Name id requested from gsd_find_chunks()
+*/
+struct gsd_id_request
+    {
+    /// Id of the requested name
+    uint16_t id;
+
+    /// Position of the name in the request
+    size_t position;
+    };
+
+/** @internal
+    @brief Compare the ids of two id requests.
+
+    @param a Pointer to the first `struct gsd_id_request`.
+    @param b Pointer to the second `struct gsd_id_request`.
+
+    Comparison function for qsort().
+*/
+static int gsd_cmp_id_request(const void* a, const void* b)
+    {
+    const struct gsd_id_request* request_a = (const struct gsd_id_request*)a;
+    const struct gsd_id_request* request_b = (const struct gsd_id_request*)b;
+
+    if (request_a->id < request_b->id)
+        {
+        return -1;
+        }
+    if (request_a->id > request_b->id)
+        {
+        return 1;
+        }
+    return 0;
+    }
+
+/** @internal
+    @brief Move the index block to the end of the file with a new size
+
+    @param handle Handle to the open gsd file.
+    @param size_new Number of entries in the new index (must be larger than the current size).
+
+    @returns GSD_SUCCESS on success, GSD_* error codes on error.
+*/
+inline static int gsd_resize_file_index(struct gsd_handle* handle, size_t size_new)
+    {
+    if (handle->open_flags == GSD_OPEN_READONLY)
+        {
+        return GSD_ERROR_FILE_MUST_BE_WRITABLE;
+        }
+
+    size_t size_old = handle->header.index_allocated_entries;
+    if (size_new <= size_old)
+        {
+        return GSD_ERROR_INVALID_ARGUMENT;
+        }
+
+    // Mac systems deadlock when writing from a mapped region into the tail end of that same region
+    // unmap the index first and copy it over by chunks
+    int retval = gsd_index_buffer_free(&handle->file_index);
+    if (retval != 0)
+        {
+        return retval;
+        }
+
+    // allocate the copy buffer
+    char* buf = malloc(GSD_COPY_BUFFER_SIZE);
+
+    // write the current index to the end of the file
+    int64_t new_index_location = lseek(handle->fd, 0, SEEK_END);
+    int64_t old_index_location = handle->header.index_location;
+    size_t total_bytes_written = 0;
+    size_t old_index_bytes = size_old * sizeof(struct gsd_index_entry);
+    while (total_bytes_written < old_index_bytes)
+        {
+        size_t bytes_to_copy = GSD_COPY_BUFFER_SIZE;
+        if (old_index_bytes - total_bytes_written < GSD_COPY_BUFFER_SIZE)
+            {
+            bytes_to_copy = old_index_bytes - total_bytes_written;
+            }
+
+        ssize_t bytes_read = gsd_io_pread_retry(handle->fd,
+                                                buf,
+                                                bytes_to_copy,
+                                                old_index_location + total_bytes_written);
+
+        if (bytes_read == -1 || bytes_read != bytes_to_copy)
+            {
+            free(buf);
+            return GSD_ERROR_IO;
+            }
+
+        ssize_t bytes_written = gsd_io_pwrite_retry(handle->fd,
+                                                    buf,
+                                                    bytes_to_copy,
+                                                    new_index_location + total_bytes_written);
+
+        if (bytes_written == -1 || bytes_written != bytes_to_copy)
+            {
+            free(buf);
+            return GSD_ERROR_IO;
+            }
+
+        total_bytes_written += bytes_written;
+        }
+
+    // fill the new index space with 0s, allocating it without writing where possible
+    size_t new_index_bytes = size_new * sizeof(struct gsd_index_entry);
+    if (gsd_io_allocate(handle->fd,
+                        new_index_location + total_bytes_written,
+                        new_index_bytes - total_bytes_written)
+        == GSD_SUCCESS)
+        {
+        total_bytes_written = new_index_bytes;
+        }
+
+    gsd_util_zero_memory(buf, GSD_COPY_BUFFER_SIZE);
+    while (total_bytes_written < new_index_bytes)
+        {
+        size_t bytes_to_copy = GSD_COPY_BUFFER_SIZE;
+        if (new_index_bytes - total_bytes_written < GSD_COPY_BUFFER_SIZE)
+            {
+            bytes_to_copy = new_index_bytes - total_bytes_written;
+            }
+
+        ssize_t bytes_written = gsd_io_pwrite_retry(handle->fd,
+                                                    buf,
+                                                    bytes_to_copy,
+                                                    new_index_location + total_bytes_written);
+
+        if (bytes_written == -1 || bytes_written != bytes_to_copy)
+            {
+            free(buf);
+            return GSD_ERROR_IO;
+            }
+
+        total_bytes_written += bytes_written;
+        }
+
+    // sync the expanded index
+    retval = gsd_sync_header_update(handle);
+    if (retval != GSD_SUCCESS)
+        {
+        free(buf);
+        return retval;
+        }
+
+    // free the copy buffer
+    free(buf);
+
+    // update the header
+    handle->header.index_location = new_index_location;
+    handle->file_size = handle->header.index_location + total_bytes_written;
+    handle->header.index_allocated_entries = size_new;
+
+    // write the new header out
+    ssize_t bytes_written
+        = gsd_io_pwrite_retry(handle->fd, &(handle->header), sizeof(struct gsd_header), 0);
+    if (bytes_written != sizeof(struct gsd_header))
+        {
+        return GSD_ERROR_IO;
+        }
+
+    // sync the updated header
+    retval = gsd_sync_header_update(handle);
+    if (retval != GSD_SUCCESS)
+        {
+        return retval;
+        }
+
+    // remap the file index
+    retval = gsd_index_buffer_map(&handle->file_index, handle);
+    if (retval != 0)
+        {
+        return retval;
+        }
+
+    return GSD_SUCCESS;
+    }
+
+/** @internal
+    @brief Utility function to expand the memory space for the index block in the file.
+
+    @param handle Handle to the open gsd file.
+    @param size_required The new index must be able to hold at least this many elements.
+
+    @returns GSD_SUCCESS on success, GSD_* error codes on error.
+*/
+inline static int gsd_expand_file_index(struct gsd_handle* handle, size_t size_required)
+    {
+    // multiply the index size each time it grows
+    // this allows the index to grow rapidly to accommodate new frames
+    const int multiplication_factor = 2;
+
+    size_t size_new = handle->header.index_allocated_entries * multiplication_factor;
+    while (size_new <= size_required)
+        {
+        size_new *= multiplication_factor;
+        }
+
+    return gsd_resize_file_index(handle, size_new);
+    }
+
+/** @internal
+    @brief Flush the write buffer.
+
+    gsd_write_frame() writes small data chunks into the write buffer. It adds index entries for
+    these chunks to gsd_handle::buffer_index with locations offset from the start of the write
+    buffer. gsd_flush_write_buffer() writes the buffer to the end of the file, moves the index
+    entries to gsd_handle::frame_index and updates the location to reference the beginning of the
+    file.
+
+    @param handle Handle to flush the write buffer.
+    @param write_buffer Buffered chunk data to write.
+    @param buffer_index Index entries of the chunks in *write_buffer*.
+    @returns GSD_SUCCESS on success or GSD_* error codes on error
+*/
+inline static int gsd_flush_write_buffer(struct gsd_handle* handle,
+                                         struct gsd_byte_buffer* write_buffer,
+                                         struct gsd_index_buffer* buffer_index)
+    {
+    if (handle == NULL)
+        {
+        return GSD_ERROR_INVALID_ARGUMENT;
+        }
+
+    if (write_buffer->size == 0 && buffer_index->size == 0)
+        {
+        // nothing to do
+        return GSD_SUCCESS;
+        }
+
+    if (write_buffer->size > 0 && buffer_index->size == 0)
+        {
+        // error: bytes in buffer, but no index for them
+        return GSD_ERROR_INVALID_ARGUMENT;
+        }
+
+    // write the buffer to the end of the file
+    uint64_t offset = handle->file_size;
+    ssize_t bytes_written
+        = gsd_io_pwrite_retry(handle->fd, write_buffer->data, write_buffer->size, offset);
+
+    if (bytes_written == -1 || bytes_written != write_buffer->size)
+        {
+        return GSD_ERROR_IO;
+        }
+
+    handle->file_size += write_buffer->size;
+
+    // reset write_buffer for new data
+    write_buffer->size = 0;
+
+    // move buffer_index entries to file_index
+    size_t i;
+    for (i = 0; i < buffer_index->size; i++)
+        {
+        struct gsd_index_entry* new_index;
+        int retval = gsd_index_buffer_add(&handle->frame_index, &new_index);
+        if (retval != GSD_SUCCESS)
+            {
+            return retval;
+            }
+
+        *new_index = buffer_index->data[i];
+        new_index->location += offset;
+        }
+
+    // clear the buffer index for new entries
+    buffer_index->size = 0;
+
+    return GSD_SUCCESS;
+    }
+
+/** @internal
+    @brief Flush the name buffer.
+
+    gsd_write_frame() adds new names to the frame_names buffer. gsd_flush_name_buffer() flushes
+    this buffer at the end of a frame write and commits the new names to the file. If necessary,
+    the namelist is written to a new location in the file.
+
+    @param handle Handle to flush the write buffer.
+    @param frame_names Names added in the frame.
+    @returns GSD_SUCCESS on success or GSD_* error codes on error
+*/
+inline static int gsd_flush_name_buffer(struct gsd_handle* handle,
+                                        struct gsd_name_buffer* frame_names)
+    {
+    if (handle == NULL)
+        {
+        return GSD_ERROR_INVALID_ARGUMENT;
+        }
+
+    if (frame_names->n_names == 0)
+        {
+        // nothing to do
+        return GSD_SUCCESS;
+        }
+
+    if (frame_names->data.size == 0)
+        {
+        // error: bytes in buffer, but no names for them
+        return GSD_ERROR_INVALID_ARGUMENT;
+        }
+
+    size_t old_reserved = handle->file_names.data.reserved;
+    size_t old_size = handle->file_names.data.size;
+
+    // add the new names to the file name list and zero the frame list
+    int retval = gsd_byte_buffer_append(&handle->file_names.data,
+                                        frame_names->data.data,
+                                        frame_names->data.size);
+    if (retval != GSD_SUCCESS)
+        {
+        return retval;
+        }
+
+    handle->file_names.n_names += frame_names->n_names;
+    frame_names->n_names = 0;
+    frame_names->data.size = 0;
+    gsd_util_zero_memory(frame_names->data.data, frame_names->data.reserved);
+
+    // reserved space must be a multiple of the GSD name size
+    if (handle->file_names.data.reserved % GSD_NAME_SIZE != 0)
+        {
+        return GSD_ERROR_INVALID_ARGUMENT;
+        }
+
+    if (handle->file_names.data.reserved > old_reserved)
+        {
+        // write the new name list to the end of the file
+        uint64_t offset = handle->file_size;
+        ssize_t bytes_written = gsd_io_pwrite_retry(handle->fd,
+                                                    handle->file_names.data.data,
+                                                    handle->file_names.data.reserved,
+                                                    offset);
+
+        if (bytes_written == -1 || bytes_written != handle->file_names.data.reserved)
+            {
+            return GSD_ERROR_IO;
+            }
+
+        // sync the updated name list
+        retval = gsd_sync_header_update(handle);
+        if (retval != GSD_SUCCESS)
+            {
+            return retval;
+            }
+
+        handle->file_size += handle->file_names.data.reserved;
+        handle->header.namelist_location = offset;
+        handle->header.namelist_allocated_entries
+            = handle->file_names.data.reserved / GSD_NAME_SIZE;
+
+        // write the new header out
+        bytes_written
+            = gsd_io_pwrite_retry(handle->fd, &(handle->header), sizeof(struct gsd_header), 0);
+        if (bytes_written != sizeof(struct gsd_header))
+            {
+            return GSD_ERROR_IO;
+            }
+        }
+    else
+        {
+        // write the new name list to the old index location
+        uint64_t offset = handle->header.namelist_location;
+        ssize_t bytes_written = gsd_io_pwrite_retry(handle->fd,
+                                                    handle->file_names.data.data + old_size,
+                                                    handle->file_names.data.reserved - old_size,
+                                                    offset + old_size);
+        if (bytes_written != (handle->file_names.data.reserved - old_size))
+            {
+            return GSD_ERROR_IO;
+            }
+        }
+
+    // sync the updated name list or header
+    return gsd_sync_header_update(handle);
+    }
+
+/** @internal
+    @brief Chunk whose data the caller lends to the background writer
+
+    gsd_write_chunk_lent() records the chunk instead of copying it into the write buffer. The
+    writer thread writes the data straight from the caller's buffer and then calls *release*.
+*/
+struct gsd_lent_chunk
+    {
+    /// Index entry of the chunk (the location is set when the chunk is written).
+    struct gsd_index_entry entry;
+
+    /// Chunk data.
+    const void* data;
+
+    /// Number of bytes of data.
+    size_t size;
+
+    /// Function to call when GSD no longer needs *data* (may be NULL).
+    void (*release)(void* user_data);
+
+    /// Argument to pass to *release*.
+    void* user_data;
+    };
+
+/** @internal
+    @brief Array of lent chunks
+*/
+struct gsd_lent_buffer
+    {
+    /// Lent chunks.
+    struct gsd_lent_chunk* data;
+
+    /// Number of lent chunks in the array.
+    size_t size;
+
+    /// Number of lent chunks allocated.
+    size_t reserved;
+    };
+
+/** @internal
+    @brief Add a chunk to a lent buffer
+
+    @param buf Buffer to add to.
+    @param chunk Chunk to add.
+
+    @returns GSD_SUCCESS on success, GSD_ERROR_MEMORY_ALLOCATION_FAILED on failure.
+*/
+inline static int gsd_lent_buffer_add(struct gsd_lent_buffer* buf,
+                                      const struct gsd_lent_chunk* chunk)
+    {
+    if (buf->size == buf->reserved)
+        {
+        size_t new_reserved = buf->reserved == 0 ? GSD_INITIAL_FRAME_INDEX_SIZE : buf->reserved * 2;
+        struct gsd_lent_chunk* new_data
+            = realloc(buf->data, sizeof(struct gsd_lent_chunk) * new_reserved);
+        if (new_data == NULL)
+            {
+            return GSD_ERROR_MEMORY_ALLOCATION_FAILED;
+            }
+        buf->data = new_data;
+        buf->reserved = new_reserved;
+        }
+
+    buf->data[buf->size] = *chunk;
+    buf->size++;
+    return GSD_SUCCESS;
+    }
+
+/** @internal
+    @brief Return all lent chunks to the caller and empty the buffer
+
+    @param buf Buffer to release.
+*/
+inline static void gsd_lent_buffer_release(struct gsd_lent_buffer* buf)
+    {
+    size_t i;
+    for (i = 0; i < buf->size; i++)
+        {
+        if (buf->data[i].release != NULL)
+            {
+            buf->data[i].release(buf->data[i].user_data);
+            }
+        }
+    buf->size = 0;
+    }
+
+/** @internal
+    @brief Return all lent chunks to the caller and free the buffer
+
+    @param buf Buffer to free.
+*/
+inline static void gsd_lent_buffer_free(struct gsd_lent_buffer* buf)
+    {
+    gsd_lent_buffer_release(buf);
+    free(buf->data);
+    buf->data = NULL;
+    buf->reserved = 0;
+    }
+
+/** @internal
+    @brief Write lent chunks to the end of the file
+
+    Writes the data straight from the caller's buffers and adds the index entries of the chunks to
+    gsd_handle::frame_index.
+
+    @param handle Handle to the open gsd file.
+    @param lent Chunks to write (may be NULL).
+
+    @returns GSD_SUCCESS on success or GSD_* error codes on error
+*/
+inline static int gsd_flush_lent_chunks(struct gsd_handle* handle,
+                                        const struct gsd_lent_buffer* lent)
+    {
+    if (lent == NULL)
+        {
+        return GSD_SUCCESS;
+        }
+
+    size_t i;
+    for (i = 0; i < lent->size; i++)
+        {
+        const struct gsd_lent_chunk* chunk = &lent->data[i];
+
+        struct gsd_index_entry* index_entry;
+        int retval = gsd_index_buffer_add(&handle->frame_index, &index_entry);
+        if (retval != GSD_SUCCESS)
+            {
+            return retval;
+            }
+        *index_entry = chunk->entry;
+        index_entry->location = handle->file_size;
+
+        ssize_t bytes_written
+            = gsd_io_pwrite_retry(handle->fd, chunk->data, chunk->size, handle->file_size);
+        if (bytes_written == -1 || bytes_written != chunk->size)
+            {
+            return GSD_ERROR_IO;
+            }
+        handle->file_size += chunk->size;
+        }
+
+    return GSD_SUCCESS;
+    }
+
+/** @internal
+    @brief Write the names, chunk data, and index entries of a completed frame to the file
+
+    @param handle Handle to the open gsd file.
+    @param frame_names Names added in the frame.
+    @param write_buffer Buffered chunk data of the frame.
+    @param buffer_index Index entries of the chunks in *write_buffer*.
+    @param lent Chunks of the frame lent by the caller (may be NULL).
+
+    @returns GSD_SUCCESS on success or GSD_* error codes on error
+*/
+inline static int gsd_commit_frame(struct gsd_handle* handle,
+                                   struct gsd_name_buffer* frame_names,
+                                   struct gsd_byte_buffer* write_buffer,
+                                   struct gsd_index_buffer* buffer_index,
+                                   const struct gsd_lent_buffer* lent)
+    {
+    // flush the namelist buffer
+    int retval = gsd_flush_name_buffer(handle, frame_names);
+    if (retval != GSD_SUCCESS)
+        {
+        return retval;
+        }
+
+    // flush the write buffer
+    retval = gsd_flush_write_buffer(handle, write_buffer, buffer_index);
+    if (retval != GSD_SUCCESS)
+        {
+        return retval;
+        }
+
+    // write lent chunks straight from the caller's buffers
+    retval = gsd_flush_lent_chunks(handle, lent);
+    if (retval != GSD_SUCCESS)
+        {
+        return retval;
+        }
+
+    // write the frame index to the file
+    if (handle->frame_index.size > 0)
+        {
+        // ensure there is enough space in the index
+        if ((handle->file_index.size + handle->frame_index.size) > handle->file_index.reserved)
+            {
+            gsd_expand_file_index(handle, handle->file_index.size + handle->frame_index.size);
+            }
+
+        // sort the index before writing
+        retval = gsd_index_buffer_sort(&handle->frame_index);
+        if (retval != 0)
+            {
+            return retval;
+            }
+
+        // write the frame index entries to the file
+        int64_t write_pos = handle->header.index_location
+                            + sizeof(struct gsd_index_entry) * handle->file_index.size;
+
+        size_t bytes_to_write = sizeof(struct gsd_index_entry) * handle->frame_index.size;
+        ssize_t bytes_written
+            = gsd_io_pwrite_retry(handle->fd, handle->frame_index.data, bytes_to_write, write_pos);
+
+        if (bytes_written == -1 || bytes_written != bytes_to_write)
+            {
+            return GSD_ERROR_IO;
+            }
+
+#if !GSD_USE_MMAP
+        // add the entries to the file index
+        memcpy(handle->file_index.data + handle->file_index.size,
+               handle->frame_index.data,
+               sizeof(struct gsd_index_entry) * handle->frame_index.size);
+#endif
+
+        // update size of file index
+        handle->file_index.size += handle->frame_index.size;
+
+        // clear the frame index
+        handle->frame_index.size = 0;
+        }
+
+    return gsd_sync_frame(handle);
+    }
+
+/** @internal
+    @brief Background thread that writes frames to the file
+
+    gsd_end_frame() hands a completed frame to the writer by swapping the handle's write_buffer,
+    buffer_index, and frame_names with the (empty) buffers of the writer. The writer thread then
+    commits the frame with gsd_commit_frame() while the caller fills the next frame. While the
+    writer is active, the writer thread owns the file descriptor, file_size, header, file_index,
+    frame_index, and file_names members of the handle.
+*/
+struct gsd_writer
+    {
+#if GSD_USE_THREADS
+    /// The writer thread
+    pthread_t thread;
+
+    /// Protects the members below
+    pthread_mutex_t mutex;
+
+    /// Signals changes to pending and stop
+    pthread_cond_t cond;
+#endif
+
+    /// Buffered chunk data of the frame being written
+    struct gsd_byte_buffer write_buffer;
+
+    /// Index entries of the frame being written
+    struct gsd_index_buffer buffer_index;
+
+    /// Names added in the frame being written
+    struct gsd_name_buffer frame_names;
+
+    /// Chunks lent for the frame being written
+    struct gsd_lent_buffer lent;
+
+    /// Chunks lent for the frame that the caller is filling
+    struct gsd_lent_buffer next_lent;
+
+    /// Number of names in the file once all frames handed to the writer are written
+    size_t n_names;
+
+    /// Set when a frame is waiting to be written
+    int pending;
+
+    /// Set to request that the writer thread exits
+    int stop;
+
+    /// First error encountered while writing frames
+    int error;
+    };
+
+/** @internal
+    @brief Number of names in the file, including names added in frames handed to the writer
+
+    @param handle Handle to the open gsd file.
+*/
+inline static size_t gsd_committed_name_count(struct gsd_handle* handle)
+    {
+    if (handle->writer != NULL)
+        {
+        return handle->writer->n_names;
+        }
+    return handle->file_names.n_names;
+    }
+
+/** @internal
+    @brief Discard the contents of frame buffers
+
+    @param frame_names Names added in the frame.
+    @param write_buffer Buffered chunk data of the frame.
+    @param buffer_index Index entries of the chunks in *write_buffer*.
+*/
+inline static void gsd_clear_frame_buffers(struct gsd_name_buffer* frame_names,
+                                           struct gsd_byte_buffer* write_buffer,
+                                           struct gsd_index_buffer* buffer_index)
+    {
+    frame_names->n_names = 0;
+    frame_names->data.size = 0;
+    gsd_util_zero_memory(frame_names->data.data, frame_names->data.reserved);
+    write_buffer->size = 0;
+    buffer_index->size = 0;
+    }
+
+#if GSD_USE_THREADS
+/** @internal
+    @brief Entry point of the writer thread
+
+    @param arg Handle to the open gsd file.
+*/
+static void* gsd_writer_main(void* arg)
+    {
+    struct gsd_handle* handle = (struct gsd_handle*)arg;
+    struct gsd_writer* writer = handle->writer;
+
+    pthread_mutex_lock(&writer->mutex);
+    while (1)
+        {
+        while (!writer->pending && !writer->stop)
+            {
+            pthread_cond_wait(&writer->cond, &writer->mutex);
+            }
+        if (!writer->pending)
+            {
+            break;
+            }
+
+        // write the frame without holding the lock
+        int error = writer->error;
+        pthread_mutex_unlock(&writer->mutex);
+
+        int retval = GSD_SUCCESS;
+        if (error == GSD_SUCCESS)
+            {
+            retval = gsd_commit_frame(handle,
+                                      &writer->frame_names,
+                                      &writer->write_buffer,
+                                      &writer->buffer_index,
+                                      &writer->lent);
+            }
+        gsd_clear_frame_buffers(&writer->frame_names,
+                                &writer->write_buffer,
+                                &writer->buffer_index);
+        gsd_lent_buffer_release(&writer->lent);
+
+        pthread_mutex_lock(&writer->mutex);
+        if (writer->error == GSD_SUCCESS)
+            {
+            writer->error = retval;
+            }
+        writer->pending = 0;
+        pthread_cond_broadcast(&writer->cond);
+        }
+    pthread_mutex_unlock(&writer->mutex);
+
+    return NULL;
+    }
+#endif
+
+/** @internal
+    @brief Wait for the writer to write all frames handed to it
+
+    @param handle Handle to the open gsd file.
+
+    @returns GSD_SUCCESS when there is no writer or it has written all frames successfully,
+    otherwise the first error that the writer encountered.
+*/
+inline static int gsd_writer_wait(struct gsd_handle* handle)
+    {
+    struct gsd_writer* writer = handle->writer;
+    if (writer == NULL)
+        {
+        return GSD_SUCCESS;
+        }
+
+#if GSD_USE_THREADS
+    pthread_mutex_lock(&writer->mutex);
+    while (writer->pending)
+        {
+        pthread_cond_wait(&writer->cond, &writer->mutex);
+        }
+    int retval = writer->error;
+    pthread_mutex_unlock(&writer->mutex);
+    return retval;
+#else
+    return writer->error;
+#endif
+    }
+
+/** @internal
+    @brief Hand the current frame to the writer
+
+    Waits for the writer to finish the previous frame first. When the writer has encountered an
+    error, the current frame is discarded.
+
+    @param handle Handle to the open gsd file.
+
+    @returns GSD_SUCCESS on success, otherwise the first error that the writer encountered.
+*/
+inline static int gsd_writer_submit(struct gsd_handle* handle)
+    {
+    struct gsd_writer* writer = handle->writer;
+    if (handle->buffer_index.size == 0 && handle->frame_names.n_names == 0
+        && writer->next_lent.size == 0)
+        {
+        // nothing to write
+        return gsd_writer_wait(handle);
+        }
+
+    int retval = gsd_writer_wait(handle);
+    if (retval != GSD_SUCCESS)
+        {
+        gsd_clear_frame_buffers(&handle->frame_names,
+                                &handle->write_buffer,
+                                &handle->buffer_index);
+        gsd_lent_buffer_release(&writer->next_lent);
+        return retval;
+        }
+
+#if GSD_USE_THREADS
+    pthread_mutex_lock(&writer->mutex);
+#endif
+    struct gsd_byte_buffer write_buffer = writer->write_buffer;
+    writer->write_buffer = handle->write_buffer;
+    handle->write_buffer = write_buffer;
+
+    struct gsd_index_buffer buffer_index = writer->buffer_index;
+    writer->buffer_index = handle->buffer_index;
+    handle->buffer_index = buffer_index;
+
+    struct gsd_name_buffer frame_names = writer->frame_names;
+    writer->frame_names = handle->frame_names;
+    handle->frame_names = frame_names;
+
+    struct gsd_lent_buffer lent = writer->lent;
+    writer->lent = writer->next_lent;
+    writer->next_lent = lent;
+
+    writer->n_names += writer->frame_names.n_names;
+    writer->pending = 1;
+#if GSD_USE_THREADS
+    pthread_cond_broadcast(&writer->cond);
+    pthread_mutex_unlock(&writer->mutex);
+#endif
+
+    return GSD_SUCCESS;
+    }
+
+/** @internal
+    @brief Free the buffers of a writer and the writer itself
+
+    @param writer Writer to free.
+*/
+inline static void gsd_writer_free(struct gsd_writer* writer)
+    {
+    if (writer->write_buffer.reserved > 0)
+        {
+        gsd_byte_buffer_free(&writer->write_buffer);
+        }
+    if (writer->buffer_index.reserved > 0)
+        {
+        gsd_index_buffer_free(&writer->buffer_index);
+        }
+    if (writer->frame_names.data.reserved > 0)
+        {
+        gsd_byte_buffer_free(&writer->frame_names.data);
+        }
+    gsd_lent_buffer_free(&writer->lent);
+    gsd_lent_buffer_free(&writer->next_lent);
+    free(writer);
+    }
+
+/** @internal
+    @brief Start the writer thread
+
+    @param handle Handle to the open gsd file.
+
+    @returns GSD_SUCCESS on success or GSD_* error codes on error
+*/
+inline static int gsd_writer_start(struct gsd_handle* handle)
+    {
+#if GSD_USE_THREADS
+    struct gsd_writer* writer = calloc(1, sizeof(struct gsd_writer));
+    if (writer == NULL)
+        {
+        return GSD_ERROR_MEMORY_ALLOCATION_FAILED;
+        }
+
+    int retval = gsd_byte_buffer_allocate(&writer->write_buffer, GSD_WRITE_BUFFER_SIZE);
+    if (retval == GSD_SUCCESS)
+        {
+        retval = gsd_index_buffer_allocate(&writer->buffer_index, GSD_INITIAL_FRAME_INDEX_SIZE);
+        }
+    if (retval == GSD_SUCCESS)
+        {
+        retval = gsd_byte_buffer_allocate(&writer->frame_names.data, GSD_NAME_SIZE);
+        }
+    if (retval != GSD_SUCCESS)
+        {
+        gsd_writer_free(writer);
+        return retval;
+        }
+
+    writer->n_names = handle->file_names.n_names;
+    writer->error = GSD_SUCCESS;
+
+    if (pthread_mutex_init(&writer->mutex, NULL) != 0)
+        {
+        gsd_writer_free(writer);
+        return GSD_ERROR_MEMORY_ALLOCATION_FAILED;
+        }
+    if (pthread_cond_init(&writer->cond, NULL) != 0)
+        {
+        pthread_mutex_destroy(&writer->mutex);
+        gsd_writer_free(writer);
+        return GSD_ERROR_MEMORY_ALLOCATION_FAILED;
+        }
+
+    handle->writer = writer;
+    if (pthread_create(&writer->thread, NULL, gsd_writer_main, handle) != 0)
+        {
+        handle->writer = NULL;
+        pthread_cond_destroy(&writer->cond);
+        pthread_mutex_destroy(&writer->mutex);
+        gsd_writer_free(writer);
+        return GSD_ERROR_MEMORY_ALLOCATION_FAILED;
+        }
+
+    return GSD_SUCCESS;
+#else
+    (void)handle;
+    return GSD_ERROR_INVALID_ARGUMENT;
+#endif
+    }
+
+/** @internal
+    @brief Write all frames handed to the writer and stop the writer thread
+
+    @param handle Handle to the open gsd file.
+
+    @returns GSD_SUCCESS on success, otherwise the first error that the writer encountered.
+*/
+inline static int gsd_writer_stop(struct gsd_handle* handle)
+    {
+    struct gsd_writer* writer = handle->writer;
+    if (writer == NULL)
+        {
+        return GSD_SUCCESS;
+        }
+
+#if GSD_USE_THREADS
+    pthread_mutex_lock(&writer->mutex);
+    writer->stop = 1;
+    pthread_cond_broadcast(&writer->cond);
+    pthread_mutex_unlock(&writer->mutex);
+
+    pthread_join(writer->thread, NULL);
+    pthread_cond_destroy(&writer->cond);
+    pthread_mutex_destroy(&writer->mutex);
+#endif
+
+    int retval = writer->error;
+
+    // keep the chunks lent for the current frame by copying them into the write buffer
+    size_t i;
+    for (i = 0; i < writer->next_lent.size; i++)
+        {
+        const struct gsd_lent_chunk* chunk = &writer->next_lent.data[i];
+        struct gsd_index_entry* index_entry;
+        int copy_retval = gsd_index_buffer_add(&handle->buffer_index, &index_entry);
+        if (copy_retval == GSD_SUCCESS)
+            {
+            *index_entry = chunk->entry;
+            index_entry->location = handle->write_buffer.size;
+            if (chunk->size > 0)
+                {
+                copy_retval = gsd_byte_buffer_append(&handle->write_buffer,
+                                                     (const char*)chunk->data,
+                                                     chunk->size);
+                }
+            }
+        if (retval == GSD_SUCCESS)
+            {
+            retval = copy_retval;
+            }
+        }
+
+    handle->writer = NULL;
+    gsd_writer_free(writer);
+    return retval;
+    }
+
+/** @internal
+    @brief utility function to append a name to the namelist
+
+    @param id [out] ID of the new name
+    @param handle handle to the open gsd file
+    @param name string name
+
+    Append a name to the names in the current frame. gsd_end_frame() will add this list to the
+    file names.
+
+    @return
+      - GSD_SUCCESS (0) on success. Negative value on failure:
+      - GSD_ERROR_IO: IO error (check errno).
+      - GSD_ERROR_MEMORY_ALLOCATION_FAILED: Unable to allocate memory.
+      - GSD_ERROR_FILE_MUST_BE_WRITABLE: File must not be read only.
+*/
+inline static int gsd_append_name(uint16_t* id, struct gsd_handle* handle, const char* name)
+    {
+    if (handle->open_flags == GSD_OPEN_READONLY)
+        {
+        return GSD_ERROR_FILE_MUST_BE_WRITABLE;
+        }
+
+    size_t n_names = gsd_committed_name_count(handle) + handle->frame_names.n_names;
+    if (n_names == UINT16_MAX)
+        {
+        // no more names may be added
+        return GSD_ERROR_NAMELIST_FULL;
+        }
+
+    // Provide the ID of the new name
+    *id = (uint16_t)n_names;
+
+    if (handle->header.gsd_version < gsd_make_version(2, 0))
+        {
+        // v1 files always allocate GSD_NAME_SIZE bytes for each name and put a NULL terminator
+        // at address 63
+        char name_v1[GSD_NAME_SIZE];
+        strncpy(name_v1, name, GSD_NAME_SIZE - 1);
+        name_v1[GSD_NAME_SIZE - 1] = 0;
+        gsd_byte_buffer_append(&handle->frame_names.data, name_v1, GSD_NAME_SIZE);
+        handle->frame_names.n_names++;
+
+        // update the name/id mapping with the truncated name
+        int retval = gsd_name_id_map_insert(&handle->name_map, name_v1, *id);
+        if (retval != GSD_SUCCESS)
+            {
+            return retval;
+            }
+        }
+    else
+        {
+        gsd_byte_buffer_append(&handle->frame_names.data, name, strlen(name) + 1);
+        handle->frame_names.n_names++;
+
+        // update the name/id mapping
+        int retval = gsd_name_id_map_insert(&handle->name_map, name, *id);
+        if (retval != GSD_SUCCESS)
+            {
+            return retval;
+            }
+        }
+
+    // keep the name directory sorted
+    return gsd_name_id_map_sort(&handle->name_map);
+    }
+
+/** @internal
+    @brief Truncate the file and write a new gsd header.
+
+    @param fd file descriptor to initialize
+    @param application Generating application name (truncated to 63 chars)
+    @param schema Schema name for data to be written in this GSD file (truncated to 63 chars)
+    @param schema_version Version of the scheme data to be written (make with gsd_make_version())
+*/
+inline static int
+gsd_initialize_file(int fd, const char* application, const char* schema, uint32_t schema_version)
+    {
+    // check if the file was created
+    if (fd == -1)
+        {
+        return GSD_ERROR_IO;
+        }
+
+    int retval = ftruncate(fd, 0);
+    if (retval != 0)
+        {
+        return GSD_ERROR_IO;
+        }
+
+    // populate header fields
+    struct gsd_header header;
+    gsd_util_zero_memory(&header, sizeof(header));
+
+    header.magic = GSD_MAGIC_ID;
+    header.gsd_version = gsd_make_version(GSD_CURRENT_FILE_VERSION, 0);
+    strncpy(header.application, application, sizeof(header.application) - 1);
+    header.application[sizeof(header.application) - 1] = 0;
+    strncpy(header.schema, schema, sizeof(header.schema) - 1);
+    header.schema[sizeof(header.schema) - 1] = 0;
+    header.schema_version = schema_version;
+    header.index_location = sizeof(header);
+    header.index_allocated_entries = GSD_INITIAL_INDEX_SIZE;
+    header.namelist_location
+        = header.index_location + sizeof(struct gsd_index_entry) * header.index_allocated_entries;
+    header.namelist_allocated_entries = GSD_INITIAL_NAME_BUFFER_SIZE / GSD_NAME_SIZE;
+    gsd_util_zero_memory(header.reserved, sizeof(header.reserved));
+
+    // write the header out
+    ssize_t bytes_written = gsd_io_pwrite_retry(fd, &header, sizeof(header), 0);
+    if (bytes_written != sizeof(header))
+        {
+        return GSD_ERROR_IO;
+        }
+
+    // allocate and zero default index memory
+    struct gsd_index_entry index[GSD_INITIAL_INDEX_SIZE];
+    gsd_util_zero_memory(index, sizeof(index));
+
+    // write the empty index out
+    bytes_written = gsd_io_pwrite_retry(fd, index, sizeof(index), sizeof(header));
+    if (bytes_written != sizeof(index))
+        {
+        return GSD_ERROR_IO;
+        }
+
+    // allocate and zero the namelist memory
+    char names[GSD_INITIAL_NAME_BUFFER_SIZE];
+    gsd_util_zero_memory(names, sizeof(char) * GSD_INITIAL_NAME_BUFFER_SIZE);
+
+    // write the namelist out
+    bytes_written = gsd_io_pwrite_retry(fd, names, sizeof(names), sizeof(header) + sizeof(index));
+    if (bytes_written != sizeof(names))
+        {
+        return GSD_ERROR_IO;
+        }
+
+    // sync file
+    return gsd_io_sync(fd);
+    }
+
+/** @internal
+    @brief Read in the file index and initialize the handle.
+
+    @param handle Handle to read the header
+
+    @pre handle->fd is an open file.
+    @pre handle->open_flags is set.
+*/
+inline static int gsd_initialize_handle(struct gsd_handle* handle)
+    {
+    // check if the file was created
+    if (handle->fd == -1)
+        {
+        return GSD_ERROR_IO;
+        }
+
+    // read the header
+    ssize_t bytes_read
+        = gsd_io_pread_retry(handle->fd, &handle->header, sizeof(struct gsd_header), 0);
+    if (bytes_read == -1)
+        {
+        return GSD_ERROR_IO;
+        }
+    if (bytes_read != sizeof(struct gsd_header))
+        {
+        return GSD_ERROR_NOT_A_GSD_FILE;
+        }
+
+    // validate the header
+    if (handle->header.magic != GSD_MAGIC_ID)
+        {
+        return GSD_ERROR_NOT_A_GSD_FILE;
+        }
+
+    if (handle->header.gsd_version < gsd_make_version(1, 0)
+        && handle->header.gsd_version != gsd_make_version(0, 3))
+        {
+        return GSD_ERROR_INVALID_GSD_FILE_VERSION;
+        }
+
+    if (handle->header.gsd_version >= gsd_make_version(3, 0))
+        {
+        return GSD_ERROR_INVALID_GSD_FILE_VERSION;
+        }
+
+    // determine the file size
+    handle->file_size = lseek(handle->fd, 0, SEEK_END);
+
+    // validate that the namelist block exists inside the file
+    if (handle->header.namelist_location
+            + (GSD_NAME_SIZE * handle->header.namelist_allocated_entries)
+        > (uint64_t)handle->file_size)
+        {
+        return GSD_ERROR_FILE_CORRUPT;
+        }
+
+    // allocate the hash map
+    int retval
+        = gsd_name_id_map_allocate(&handle->name_map, handle->header.namelist_allocated_entries);
+    if (retval != GSD_SUCCESS)
+        {
+        return retval;
+        }
+
+    // read the namelist block
+    size_t namelist_n_bytes = GSD_NAME_SIZE * handle->header.namelist_allocated_entries;
+    retval = gsd_byte_buffer_allocate(&handle->file_names.data, namelist_n_bytes);
+    if (retval != GSD_SUCCESS)
+        {
+        return retval;
+        }
+    bytes_read = gsd_io_pread_retry(handle->fd,
+                                    handle->file_names.data.data,
+                                    namelist_n_bytes,
+                                    handle->header.namelist_location);
+
+    if (bytes_read == -1 || bytes_read != namelist_n_bytes)
+        {
+        return GSD_ERROR_IO;
+        }
+
+    // The name buffer must end in a NULL terminator or else the file is corrupt
+    if (handle->file_names.data.data[handle->file_names.data.reserved - 1] != 0)
+        {
+        return GSD_ERROR_FILE_CORRUPT;
+        }
+
+    // Add the names to the hash map. Also determine the number of used bytes in the namelist.
+    size_t name_start = 0;
+    handle->file_names.n_names = 0;
+    while (name_start < handle->file_names.data.reserved)
+        {
+        char* name = handle->file_names.data.data + name_start;
+
+        // an empty name notes the end of the list
+        if (name[0] == 0)
+            {
+            break;
+            }
+
+        retval
+            = gsd_name_id_map_insert(&handle->name_map, name, (uint16_t)handle->file_names.n_names);
+        if (retval != GSD_SUCCESS)
+            {
+            return retval;
+            }
+        handle->file_names.n_names++;
+
+        if (handle->header.gsd_version < gsd_make_version(2, 0))
+            {
+            // gsd v1 stores names in fixed 64 byte segments
+            name_start += GSD_NAME_SIZE;
+            }
+        else
+            {
+            size_t len = strnlen(name, handle->file_names.data.reserved - name_start);
+            name_start += len + 1;
+            }
+        }
+
+    handle->file_names.data.size = name_start;
+
+    // sort the name directory
+    retval = gsd_name_id_map_sort(&handle->name_map);
+    if (retval != GSD_SUCCESS)
+        {
+        return retval;
+        }
+
+    // read in the file index
+    retval = gsd_index_buffer_map(&handle->file_index, handle);
+    if (retval != GSD_SUCCESS)
+        {
+        return retval;
+        }
+
+    // determine the current frame counter
+    if (handle->file_index.size == 0)
+        {
+        handle->cur_frame = 0;
+        }
+    else
+        {
+        handle->cur_frame = handle->file_index.data[handle->file_index.size - 1].frame + 1;
+        }
+
+    // if this is a write mode, allocate the initial frame index and the name buffer
+    if (handle->open_flags != GSD_OPEN_READONLY)
+        {
+        retval = gsd_index_buffer_allocate(&handle->frame_index, GSD_INITIAL_FRAME_INDEX_SIZE);
+        if (retval != GSD_SUCCESS)
+            {
+            return retval;
+            }
+
+        retval = gsd_index_buffer_allocate(&handle->buffer_index, GSD_INITIAL_FRAME_INDEX_SIZE);
+        if (retval != GSD_SUCCESS)
+            {
+            return retval;
+            }
+
+        retval = gsd_byte_buffer_allocate(&handle->write_buffer, GSD_WRITE_BUFFER_SIZE);
+        if (retval != GSD_SUCCESS)
+            {
+            return retval;
+            }
+
+        handle->frame_names.n_names = 0;
+        retval = gsd_byte_buffer_allocate(&handle->frame_names.data, GSD_NAME_SIZE);
+        if (retval != GSD_SUCCESS)
+            {
+            return retval;
+            }
+        }
+
+    return GSD_SUCCESS;
+    }
+
+uint32_t gsd_make_version(unsigned int major, unsigned int minor)
     {
     return major << (sizeof(uint32_t) * 4) | minor;
     }
 
-int gsd_create(const char* fname,
-               const char* application,
-               const char* schema,
-               uint32_t schema_version)
+int gsd_create(const char* fname,
+               const char* application,
+               const char* schema,
+               uint32_t schema_version)
+    {
+    int extra_flags = 0;
+#ifdef _WIN32
+    extra_flags = _O_BINARY;
+#endif
+
+    // create the file
+    int fd = open(fname,
+                  O_RDWR | O_CREAT | O_TRUNC | extra_flags,
+                  S_IRUSR | S_IWUSR | S_IRGRP | S_IWGRP);
+    int retval = gsd_initialize_file(fd, application, schema, schema_version);
+    close(fd);
+    return retval;
+    }
+
+int gsd_create_and_open(struct gsd_handle* handle,
+                        const char* fname,
+                        const char* application,
+                        const char* schema,
+                        uint32_t schema_version,
+                        const enum gsd_open_flag flags,
+                        int exclusive_create)
+    {
+    // zero the handle
+    gsd_util_zero_memory(handle, sizeof(struct gsd_handle));
+
+    int extra_flags = 0;
+#ifdef _WIN32
+    extra_flags = _O_BINARY;
+#endif
+
+    // set the open flags in the handle
+    if (flags == GSD_OPEN_READWRITE)
+        {
+        handle->open_flags = GSD_OPEN_READWRITE;
+        }
+    else if (flags == GSD_OPEN_READONLY)
+        {
+        return GSD_ERROR_FILE_MUST_BE_WRITABLE;
+        }
+    else if (flags == GSD_OPEN_APPEND)
+        {
+        handle->open_flags = GSD_OPEN_APPEND;
+        }
+
+    // set the exclusive create bit
+    if (exclusive_create)
+        {
+        extra_flags |= O_EXCL;
+        }
+
+    // create the file
+    handle->fd = open(fname,
+                      O_RDWR | O_CREAT | O_TRUNC | extra_flags,
+                      S_IRUSR | S_IWUSR | S_IRGRP | S_IWGRP);
+    int retval = gsd_initialize_file(handle->fd, application, schema, schema_version);
+    if (retval != 0)
+        {
+        close(handle->fd);
+        return retval;
+        }
+
+    retval = gsd_initialize_handle(handle);
+    if (retval != 0)
+        {
+        close(handle->fd);
+        }
+    return retval;
+    }
+
+int gsd_open(struct gsd_handle* handle, const char* fname, const enum gsd_open_flag flags)
+    {
+    // zero the handle
+    gsd_util_zero_memory(handle, sizeof(struct gsd_handle));
+
+    int extra_flags = 0;
+#ifdef _WIN32
+    extra_flags = _O_BINARY;
+#endif
+
+    // open the file
+    if (flags == GSD_OPEN_READWRITE)
+        {
+        handle->fd = open(fname, O_RDWR | extra_flags);
+        handle->open_flags = GSD_OPEN_READWRITE;
+        }
+    else if (flags == GSD_OPEN_READONLY)
+        {
+        handle->fd = open(fname, O_RDONLY | extra_flags);
+        handle->open_flags = GSD_OPEN_READONLY;
+        }
+    else if (flags == GSD_OPEN_APPEND)
+        {
+        handle->fd = open(fname, O_RDWR | extra_flags);
+        handle->open_flags = GSD_OPEN_APPEND;
+        }
+
+    int retval = gsd_initialize_handle(handle);
+    if (retval != 0)
+        {
+        close(handle->fd);
+        }
+    return retval;
+    }
+
+int gsd_truncate(struct gsd_handle* handle)
+    {
+    if (handle == NULL)
+        {
+        return GSD_ERROR_INVALID_ARGUMENT;
+        }
+    if (handle->open_flags == GSD_OPEN_READONLY)
+        {
+        return GSD_ERROR_FILE_MUST_BE_WRITABLE;
+        }
+
+    // frames still in the writer are removed with the rest of the file
+    gsd_writer_wait(handle);
+    if (handle->writer != NULL)
+        {
+        gsd_lent_buffer_release(&handle->writer->next_lent);
+        }
+
+    int retval = 0;
+
+    // deallocate indices
+    if (handle->frame_names.data.reserved > 0)
+        {
+        retval = gsd_byte_buffer_free(&handle->frame_names.data);
+        if (retval != GSD_SUCCESS)
+            {
+            return retval;
+            }
+        }
+
+    if (handle->file_names.data.reserved > 0)
+        {
+        retval = gsd_byte_buffer_free(&handle->file_names.data);
+        if (retval != GSD_SUCCESS)
+            {
+            return retval;
+            }
+        }
+
+    retval = gsd_name_id_map_free(&handle->name_map);
+    if (retval != GSD_SUCCESS)
+        {
+        return retval;
+        }
+
+    retval = gsd_index_buffer_free(&handle->file_index);
+    if (retval != GSD_SUCCESS)
+        {
+        return retval;
+        }
+    gsd_frame_table_free(&handle->frame_table);
+    gsd_search_tree_free(&handle->search_tree);
+    gsd_chunk_history_free(&handle->chunk_history);
+
+    if (handle->frame_index.reserved > 0)
+        {
+        retval = gsd_index_buffer_free(&handle->frame_index);
+        if (retval != GSD_SUCCESS)
+            {
+            return retval;
+            }
+        }
+
+    if (handle->buffer_index.reserved > 0)
+        {
+        retval = gsd_index_buffer_free(&handle->buffer_index);
+        if (retval != GSD_SUCCESS)
+            {
+            return retval;
+            }
+        }
+
+    if (handle->write_buffer.reserved > 0)
+        {
+        retval = gsd_byte_buffer_free(&handle->write_buffer);
+        if (retval != GSD_SUCCESS)
+            {
+            return retval;
+            }
+        }
+
+    // keep a copy of the old header
+    struct gsd_header old_header = handle->header;
+    retval = gsd_initialize_file(handle->fd,
+                                 old_header.application,
+                                 old_header.schema,
+                                 old_header.schema_version);
+
+    if (retval != GSD_SUCCESS)
+        {
+        return retval;
+        }
+
+    retval = gsd_initialize_handle(handle);
+    if (retval == GSD_SUCCESS && handle->writer != NULL)
+        {
+        handle->writer->n_names = handle->file_names.n_names;
+        handle->writer->error = GSD_SUCCESS;
+        }
+    return retval;
+    }
+
+int gsd_close(struct gsd_handle* handle)
+    {
+    if (handle == NULL)
+        {
+        return GSD_ERROR_INVALID_ARGUMENT;
+        }
+
+    // save the fd so we can use it after freeing the handle
+    int fd = handle->fd;
+
+    // write all ended frames before closing the file
+    int writer_retval = gsd_writer_stop(handle);
+    if (writer_retval == GSD_SUCCESS && handle->open_flags != GSD_OPEN_READONLY
+        && handle->durability != GSD_DURABILITY_NEVER)
+        {
+        writer_retval = gsd_io_sync(fd);
+        }
+
+    int retval;
+#if GSD_USE_MMAP
+    if (handle->file_map != NULL)
+        {
+        retval = munmap(handle->file_map, handle->file_map_len);
+        if (retval != 0)
+            {
+            return GSD_ERROR_IO;
+            }
+        handle->file_map = NULL;
+        handle->file_map_len = 0;
+        }
+#endif
+
+    retval = gsd_index_buffer_free(&handle->file_index);
+    if (retval != GSD_SUCCESS)
+        {
+        return retval;
+        }
+    gsd_frame_table_free(&handle->frame_table);
+    gsd_search_tree_free(&handle->search_tree);
+    gsd_chunk_history_free(&handle->chunk_history);
+
+    if (handle->frame_index.reserved > 0)
+        {
+        retval = gsd_index_buffer_free(&handle->frame_index);
+        if (retval != GSD_SUCCESS)
+            {
+            return retval;
+            }
+        }
+
+    if (handle->buffer_index.reserved > 0)
+        {
+        retval = gsd_index_buffer_free(&handle->buffer_index);
+        if (retval != GSD_SUCCESS)
+            {
+            return retval;
+            }
+        }
+
+    if (handle->write_buffer.reserved > 0)
+        {
+        retval = gsd_byte_buffer_free(&handle->write_buffer);
+        if (retval != GSD_SUCCESS)
+            {
+            return retval;
+            }
+        }
+
+    retval = gsd_name_id_map_free(&handle->name_map);
+    if (retval != GSD_SUCCESS)
+        {
+        return retval;
+        }
+
+    if (handle->frame_names.data.reserved > 0)
+        {
+        handle->frame_names.n_names = 0;
+        retval = gsd_byte_buffer_free(&handle->frame_names.data);
+        if (retval != GSD_SUCCESS)
+            {
+            return retval;
+            }
+        }
+
+    if (handle->file_names.data.reserved > 0)
+        {
+        handle->file_names.n_names = 0;
+        retval = gsd_byte_buffer_free(&handle->file_names.data);
+        if (retval != GSD_SUCCESS)
+            {
+            return retval;
+            }
+        }
+
+    // close the file
+    retval = close(fd);
+    if (retval != 0)
+        {
+        return GSD_ERROR_IO;
+        }
+
+    return writer_retval;
+    }
+
+int gsd_end_frame(struct gsd_handle* handle)
+    {
+    if (handle == NULL)
+        {
+        return GSD_ERROR_INVALID_ARGUMENT;
+        }
+    if (handle->open_flags == GSD_OPEN_READONLY)
+        {
+        return GSD_ERROR_FILE_MUST_BE_WRITABLE;
+        }
+
+    // increment the frame counter
+    handle->cur_frame++;
+
+    if (handle->writer != NULL)
+        {
+        return gsd_writer_submit(handle);
+        }
+
+    return gsd_commit_frame(handle,
+                            &handle->frame_names,
+                            &handle->write_buffer,
+                            &handle->buffer_index,
+                            NULL);
+    }
+
+int gsd_set_async(struct gsd_handle* handle, int enable)
+    {
+    if (handle == NULL)
+        {
+        return GSD_ERROR_INVALID_ARGUMENT;
+        }
+    if (handle->open_flags == GSD_OPEN_READONLY)
+        {
+        return GSD_ERROR_FILE_MUST_BE_WRITABLE;
+        }
+
+    if (enable && handle->writer == NULL)
+        {
+        return gsd_writer_start(handle);
+        }
+    if (!enable && handle->writer != NULL)
+        {
+        return gsd_writer_stop(handle);
+        }
+
+    return GSD_SUCCESS;
+    }
+
+int gsd_flush(struct gsd_handle* handle)
+    {
+    if (handle == NULL)
+        {
+        return GSD_ERROR_INVALID_ARGUMENT;
+        }
+    if (handle->open_flags == GSD_OPEN_READONLY)
+        {
+        return GSD_ERROR_FILE_MUST_BE_WRITABLE;
+        }
+
+    int retval = gsd_writer_wait(handle);
+    if (retval != GSD_SUCCESS)
+        {
+        return retval;
+        }
+
+    handle->unsynced_frames = 0;
+    return gsd_io_sync(handle->fd);
+    }
+
+int gsd_reserve(struct gsd_handle* handle,
+                uint64_t n_frames,
+                uint64_t entries_per_frame,
+                uint64_t bytes)
+    {
+    if (handle == NULL)
+        {
+        return GSD_ERROR_INVALID_ARGUMENT;
+        }
+    if (handle->open_flags == GSD_OPEN_READONLY)
+        {
+        return GSD_ERROR_FILE_MUST_BE_WRITABLE;
+        }
+    if (entries_per_frame != 0 && n_frames > SIZE_MAX / entries_per_frame)
+        {
+        return GSD_ERROR_INVALID_ARGUMENT;
+        }
+
+    // the writer thread owns the index and the file size
+    int retval = gsd_writer_wait(handle);
+    if (retval != GSD_SUCCESS)
+        {
+        return retval;
+        }
+
+    // size the index for the entries in the file, the current frame, and the future frames
+    size_t n_entries = n_frames * entries_per_frame;
+    size_t n_current = handle->file_index.size + handle->frame_index.size
+                       + handle->buffer_index.size;
+    if (n_entries > SIZE_MAX - n_current)
+        {
+        return GSD_ERROR_INVALID_ARGUMENT;
+        }
+    n_entries += n_current;
+
+    if (n_entries > handle->header.index_allocated_entries)
+        {
+        retval = gsd_resize_file_index(handle, n_entries);
+        if (retval != GSD_SUCCESS)
+            {
+            return retval;
+            }
+        }
+
+#if GSD_USE_FALLOCATE
+    // allocate space for the chunk data without changing the file size, so that unused space does
+    // not remain in the file
+    if (bytes > 0
+        && fallocate(handle->fd, FALLOC_FL_KEEP_SIZE, handle->file_size, (off_t)bytes) != 0
+        && errno != EOPNOTSUPP)
+        {
+        return GSD_ERROR_IO;
+        }
+#else
+    (void)bytes;
+#endif
+
+    return GSD_SUCCESS;
+    }
+
+int gsd_set_durability(struct gsd_handle* handle,
+                       enum gsd_durability durability,
+                       uint64_t sync_interval)
+    {
+    if (handle == NULL)
+        {
+        return GSD_ERROR_INVALID_ARGUMENT;
+        }
+    if (durability != GSD_DURABILITY_ALWAYS && durability != GSD_DURABILITY_FRAMES
+        && durability != GSD_DURABILITY_CLOSE && durability != GSD_DURABILITY_NEVER)
+        {
+        return GSD_ERROR_INVALID_ARGUMENT;
+        }
+    if (durability == GSD_DURABILITY_FRAMES && sync_interval == 0)
+        {
+        return GSD_ERROR_INVALID_ARGUMENT;
+        }
+    if (handle->open_flags == GSD_OPEN_READONLY)
+        {
+        return GSD_ERROR_FILE_MUST_BE_WRITABLE;
+        }
+
+    // the writer thread applies the policy to the frames it writes
+    gsd_writer_wait(handle);
+
+    handle->durability = durability;
+    handle->sync_interval = sync_interval;
+    handle->unsynced_frames = 0;
+    return GSD_SUCCESS;
+    }
+
+/** @internal
+    @brief Write a chunk's data and add its entry to the index
+
+    Small chunks are added to the write buffer, large ones are written directly to the end of the
+    file.
+
+    @param handle Handle to the open gsd file.
+    @param entry Index entry of the chunk (the location is determined by this function).
+    @param data Chunk data as stored in the file.
+    @param size Number of bytes in *data*.
+
+    @returns GSD_SUCCESS on success or an error code on failure.
+*/
+inline static int gsd_write_entry_data(struct gsd_handle* handle,
+                                       struct gsd_index_entry entry,
+                                       const void* data,
+                                       size_t size)
+    {
+    // decide whether to write this chunk to the buffer or straight to disk
+    // the writer thread owns the file, so buffer all chunks when it is active
+    if (handle->writer != NULL || size < handle->write_buffer.reserved / 2)
+        {
+        // flush the buffer if this entry won't fit
+        if (handle->writer == NULL
+            && size > (handle->write_buffer.reserved - handle->write_buffer.size))
+            {
+            gsd_flush_write_buffer(handle, &handle->write_buffer, &handle->buffer_index);
+            }
+
+        entry.location = handle->write_buffer.size;
+
+        // add an entry to the buffer index
+        struct gsd_index_entry* index_entry;
+
+        int retval = gsd_index_buffer_add(&handle->buffer_index, &index_entry);
+        if (retval != GSD_SUCCESS)
+            {
+            return retval;
+            }
+        *index_entry = entry;
+
+        // add the data to the write buffer
+        if (size > 0)
+            {
+            retval = gsd_byte_buffer_append(&handle->write_buffer, data, size);
+            if (retval != GSD_SUCCESS)
+                {
+                return retval;
+                }
+            }
+        }
+    else
+        {
+        // add an entry to the frame index
+        struct gsd_index_entry* index_entry;
+
+        int retval = gsd_index_buffer_add(&handle->frame_index, &index_entry);
+        if (retval != GSD_SUCCESS)
+            {
+            return retval;
+            }
+        *index_entry = entry;
+
+        // find the location at the end of the file for the chunk
+        index_entry->location = handle->file_size;
+
+        // write the data
+        ssize_t bytes_written = gsd_io_pwrite_retry(handle->fd, data, size, index_entry->location);
+        if (bytes_written == -1 || bytes_written != size)
+            {
+            return GSD_ERROR_IO;
+            }
+
+        // update the file_size in the handle
+        handle->file_size += bytes_written;
+        }
+
+    return GSD_SUCCESS;
+    }
+
+/** @internal
+    @brief Initialize the index entry of a chunk in the current frame
+
+    @param handle Handle to the open gsd file.
+    @param[out] entry Entry to initialize.
+    @param id Id of the chunk name.
+    @param type Type of the chunk data.
+    @param N Number of rows in the chunk.
+    @param M Number of columns in the chunk.
+
+    @returns GSD_SUCCESS on success or an error code on failure.
+*/
+inline static int gsd_init_entry(struct gsd_handle* handle,
+                                 struct gsd_index_entry* entry,
+                                 uint16_t id,
+                                 enum gsd_type type,
+                                 uint64_t N,
+                                 uint32_t M)
+    {
+    if (id >= gsd_committed_name_count(handle) + handle->frame_names.n_names)
+        {
+        return GSD_ERROR_INVALID_ARGUMENT;
+        }
+
+    // populate fields in the entry's data
+    gsd_util_zero_memory(entry, sizeof(struct gsd_index_entry));
+    entry->frame = handle->cur_frame;
+    entry->id = id;
+    entry->type = (uint8_t)type;
+    entry->N = N;
+    entry->M = M;
+    return GSD_SUCCESS;
+    }
+
+int gsd_intern_name(struct gsd_handle* handle, const char* name, uint16_t* id)
+    {
+    if (handle == NULL || name == NULL || id == NULL)
+        {
+        return GSD_ERROR_INVALID_ARGUMENT;
+        }
+
+    *id = gsd_name_id_map_find(&handle->name_map, name);
+    if (*id != UINT16_MAX)
+        {
+        return GSD_SUCCESS;
+        }
+
+    // not found, append to the index
+    int retval = gsd_append_name(id, handle, name);
+    if (retval != GSD_SUCCESS)
+        {
+        *id = UINT16_MAX;
+        return retval;
+        }
+
+    if (*id == UINT16_MAX)
+        {
+        // this should never happen
+        return GSD_ERROR_NAMELIST_FULL;
+        }
+
+    return GSD_SUCCESS;
+    }
+
+int gsd_write_chunk(struct gsd_handle* handle,
+                    const char* name,
+                    enum gsd_type type,
+                    uint64_t N,
+                    uint32_t M,
+                    uint8_t flags,
+                    const void* data)
     {
-    int extra_flags = 0;
-#ifdef _WIN32
-    extra_flags = _O_BINARY;
-#endif
+    // validate input before adding the name
+    if (handle == NULL || M == 0 || (N > 0 && data == NULL))
+        {
+        return GSD_ERROR_INVALID_ARGUMENT;
+        }
+    if (handle->open_flags == GSD_OPEN_READONLY)
+        {
+        return GSD_ERROR_FILE_MUST_BE_WRITABLE;
+        }
+    if (!gsd_is_flags_valid(flags) || (flags & GSD_FILTER_QUANTIZE))
+        {
+        return GSD_ERROR_INVALID_ARGUMENT;
+        }
 
-    // create the file
-    int fd = open(fname,
-                  O_RDWR | O_CREAT | O_TRUNC | extra_flags,
-                  S_IRUSR | S_IWUSR | S_IRGRP | S_IWGRP);
-    int retval = gsd_initialize_file(fd, application, schema, schema_version);
-    close(fd);
+    uint16_t id;
+    int retval = gsd_intern_name(handle, name, &id);
+    if (retval != GSD_SUCCESS)
+        {
+        return retval;
+        }
+
+    return gsd_write_chunk_id(handle, id, type, N, M, flags, data);
+    }
+
+int gsd_write_chunk_id(struct gsd_handle* handle,
+                       uint16_t id,
+                       enum gsd_type type,
+                       uint64_t N,
+                       uint32_t M,
+                       uint8_t flags,
+                       const void* data)
+    {
+    // validate input
+    if (handle == NULL)
+        {
+        return GSD_ERROR_INVALID_ARGUMENT;
+        }
+    if (N > 0 && data == NULL)
+        {
+        return GSD_ERROR_INVALID_ARGUMENT;
+        }
+    if (M == 0)
+        {
+        return GSD_ERROR_INVALID_ARGUMENT;
+        }
+    if (handle->open_flags == GSD_OPEN_READONLY)
+        {
+        return GSD_ERROR_FILE_MUST_BE_WRITABLE;
+        }
+    if (!gsd_is_flags_valid(flags) || (flags & GSD_FILTER_QUANTIZE))
+        {
+        return GSD_ERROR_INVALID_ARGUMENT;
+        }
+
+    struct gsd_index_entry entry;
+    int retval = gsd_init_entry(handle, &entry, id, type, N, M);
+    if (retval != GSD_SUCCESS)
+        {
+        return retval;
+        }
+    size_t size = N * M * gsd_sizeof_type(type);
+
+    // compress the data, keeping it uncompressed when that is smaller
+    char* encoded = NULL;
+    if (flags != 0 && size > 0)
+        {
+        size_t encoded_size = 0;
+        retval
+            = gsd_encode_chunk(&encoded, &encoded_size, data, size, flags, gsd_sizeof_type(type));
+        if (retval != GSD_SUCCESS)
+            {
+            return retval;
+            }
+
+        if (encoded != NULL)
+            {
+            entry.flags = flags;
+            data = encoded;
+            size = encoded_size;
+            }
+        }
+
+    retval = gsd_write_entry_data(handle, entry, data, size);
+    free(encoded);
     return retval;
     }
 
-int gsd_create_and_open(struct gsd_handle* handle,
-                        const char* fname,
-                        const char* application,
-                        const char* schema,
-                        uint32_t schema_version,
-                        const enum gsd_open_flag flags,
-                        int exclusive_create)
+int gsd_write_chunk_lent(struct gsd_handle* handle,
+                         const char* name,
+                         enum gsd_type type,
+                         uint64_t N,
+                         uint32_t M,
+                         uint8_t flags,
+                         const void* data,
+                         void (*release)(void* user_data),
+                         void* user_data)
     {
-    // zero the handle
-    gsd_util_zero_memory(handle, sizeof(struct gsd_handle));
+    if (handle == NULL || handle->writer == NULL || flags != 0)
+        {
+        // without the background writer, or when encoding copies the data anyway, write it now
+        int retval = GSD_ERROR_INVALID_ARGUMENT;
+        if (handle != NULL)
+            {
+            retval = gsd_write_chunk(handle, name, type, N, M, flags, data);
+            }
+        if (release != NULL)
+            {
+            release(user_data);
+            }
+        return retval;
+        }
 
-    int extra_flags = 0;
-#ifdef _WIN32
-    extra_flags = _O_BINARY;
-#endif
+    struct gsd_lent_chunk chunk;
+    chunk.data = data;
+    chunk.size = N * M * gsd_sizeof_type(type);
+    chunk.release = release;
+    chunk.user_data = user_data;
 
-    // set the open flags in the handle
-    if (flags == GSD_OPEN_READWRITE)
+    int retval = GSD_ERROR_INVALID_ARGUMENT;
+    if (M != 0 && (N == 0 || data != NULL))
         {
-        handle->open_flags = GSD_OPEN_READWRITE;
+        uint16_t id;
+        retval = gsd_intern_name(handle, name, &id);
+        if (retval == GSD_SUCCESS)
+            {
+            retval = gsd_init_entry(handle, &chunk.entry, id, type, N, M);
+            }
         }
-    else if (flags == GSD_OPEN_READONLY)
+    if (retval == GSD_SUCCESS)
+        {
+        retval = gsd_lent_buffer_add(&handle->writer->next_lent, &chunk);
+        }
+
+    if (retval != GSD_SUCCESS && release != NULL)
+        {
+        release(user_data);
+        }
+    return retval;
+    }
+
+int gsd_write_quantized_chunk(struct gsd_handle* handle,
+                              const char* name,
+                              uint64_t N,
+                              uint32_t M,
+                              uint8_t flags,
+                              const float* data,
+                              double precision,
+                              const float* extent)
+    {
+    // validate input
+    if (handle == NULL || M == 0 || (N > 0 && data == NULL))
+        {
+        return GSD_ERROR_INVALID_ARGUMENT;
+        }
+    if (!(precision > 0 && precision <= DBL_MAX))
+        {
+        return GSD_ERROR_INVALID_ARGUMENT;
+        }
+    if (!gsd_is_flags_valid(flags) || (flags & ~GSD_COMPRESSION_MASK) != 0)
+        {
+        return GSD_ERROR_INVALID_ARGUMENT;
+        }
+    if (handle->open_flags == GSD_OPEN_READONLY)
         {
         return GSD_ERROR_FILE_MUST_BE_WRITABLE;
         }
-    else if (flags == GSD_OPEN_APPEND)
+    if (N == 0)
         {
-        handle->open_flags = GSD_OPEN_APPEND;
+        return gsd_write_chunk(handle, name, GSD_TYPE_FLOAT, N, M, 0, data);
         }
 
-    // set the exclusive create bit
-    if (exclusive_create)
+    char* quantized = NULL;
+    size_t quantized_size = 0;
+    int retval = gsd_quantize(&quantized, &quantized_size, data, N, M, precision, extent);
+    if (retval != GSD_SUCCESS)
         {
-        extra_flags |= O_EXCL;
+        return retval;
         }
 
-    // create the file
-    handle->fd = open(fname,
-                      O_RDWR | O_CREAT | O_TRUNC | extra_flags,
-                      S_IRUSR | S_IWUSR | S_IRGRP | S_IWGRP);
-    int retval = gsd_initialize_file(handle->fd, application, schema, schema_version);
-    if (retval != 0)
+    uint16_t id;
+    retval = gsd_intern_name(handle, name, &id);
+    struct gsd_index_entry entry;
+    if (retval == GSD_SUCCESS)
         {
-        close(handle->fd);
+        retval = gsd_init_entry(handle, &entry, id, GSD_TYPE_FLOAT, N, M);
+        }
+    if (retval != GSD_SUCCESS)
+        {
+        free(quantized);
+        return retval;
+        }
+    entry.flags = GSD_FILTER_QUANTIZE | flags;
+
+    // compress the quantized values, keeping them uncompressed when that is smaller
+    char* encoded = NULL;
+    size_t encoded_size = 0;
+    retval = gsd_encode_chunk(&encoded,
+                              &encoded_size,
+                              quantized + sizeof(struct gsd_chunk_header),
+                              quantized_size,
+                              flags,
+                              1);
+    if (retval != GSD_SUCCESS)
+        {
+        free(quantized);
         return retval;
         }
 
-    retval = gsd_initialize_handle(handle);
-    if (retval != 0)
+    if (encoded == NULL)
         {
-        close(handle->fd);
+        struct gsd_chunk_header header;
+        header.stored_size = quantized_size;
+        header.data_size = quantized_size;
+        memcpy(quantized, &header, sizeof(struct gsd_chunk_header));
+
+        entry.flags = GSD_FILTER_QUANTIZE;
+        encoded = quantized;
+        encoded_size = sizeof(struct gsd_chunk_header) + quantized_size;
+        quantized = NULL;
+        }
+    free(quantized);
+
+    // very small chunks are smaller when stored as is
+    size_t size = N * M * sizeof(float);
+    if (encoded_size >= size)
+        {
+        entry.flags = 0;
+        retval = gsd_write_entry_data(handle, entry, data, size);
         }
+    else
+        {
+        retval = gsd_write_entry_data(handle, entry, encoded, encoded_size);
+        }
+
+    free(encoded);
     return retval;
     }
 
-int gsd_open(struct gsd_handle* handle, const char* fname, const enum gsd_open_flag flags)
+uint64_t gsd_get_nframes(struct gsd_handle* handle)
     {
-    // zero the handle
-    gsd_util_zero_memory(handle, sizeof(struct gsd_handle));
+    if (handle == NULL)
+        {
+        return 0;
+        }
+    return handle->cur_frame;
+    }
 
-    int extra_flags = 0;
-#ifdef _WIN32
-    extra_flags = _O_BINARY;
-#endif
+const struct gsd_index_entry*
+gsd_find_chunk(struct gsd_handle* handle, uint64_t frame, const char* name)
+    {
+    if (handle == NULL)
+        {
+        return NULL;
+        }
+    if (name == NULL)
+        {
+        return NULL;
+        }
 
-    // open the file
-    if (flags == GSD_OPEN_READWRITE)
+    // find the id for the given name
+    uint16_t match_id = gsd_name_id_map_find(&handle->name_map, name);
+    if (match_id == UINT16_MAX)
         {
-        handle->fd = open(fname, O_RDWR | extra_flags);
-        handle->open_flags = GSD_OPEN_READWRITE;
+        return NULL;
         }
-    else if (flags == GSD_OPEN_READONLY)
+
+    return gsd_find_chunk_id(handle, frame, match_id);
+    }
+
+const struct gsd_index_entry*
+gsd_find_chunk_id(struct gsd_handle* handle, uint64_t frame, uint16_t match_id)
+    {
+    if (handle == NULL)
         {
-        handle->fd = open(fname, O_RDONLY | extra_flags);
-        handle->open_flags = GSD_OPEN_READONLY;
+        return NULL;
         }
-    else if (flags == GSD_OPEN_APPEND)
+    if (frame >= gsd_get_nframes(handle))
         {
-        handle->fd = open(fname, O_RDWR | extra_flags);
-        handle->open_flags = GSD_OPEN_APPEND;
+        return NULL;
+        }
+    if (handle->open_flags == GSD_OPEN_APPEND)
+        {
+        return NULL;
         }
 
-    int retval = gsd_initialize_handle(handle);
-    if (retval != 0)
+    // the index is up to date once the writer has written all frames
+    gsd_writer_wait(handle);
+
+    // search only the entries of the frame
+    size_t begin;
+    size_t end;
+    gsd_find_frame(handle, frame, &begin, &end);
+
+    if (handle->header.gsd_version >= gsd_make_version(2, 0))
+        {
+        // gsd 2.0 files sort the entire index
+        // binary search for the index entry
+        ssize_t L = begin;
+        ssize_t R = (ssize_t)end - 1;
+        struct gsd_index_entry T;
+        T.frame = frame;
+        T.id = match_id;
+
+        while (L <= R)
+            {
+            size_t m = (L + R) / 2;
+            int cmp = gsd_cmp_index_entry(handle->file_index.data + m, &T);
+            if (cmp == -1)
+                {
+                L = m + 1;
+                }
+            else if (cmp == 1)
+                {
+                R = m - 1;
+                }
+            else
+                {
+                return &(handle->file_index.data[m]);
+                }
+            }
+        }
+    else
         {
-        close(handle->fd);
+        // gsd 1.0 file: search all index entries of the frame
+        size_t cur_index;
+        for (cur_index = end; cur_index > begin; cur_index--)
+            {
+            if (match_id == handle->file_index.data[cur_index - 1].id)
+                {
+                return &(handle->file_index.data[cur_index - 1]);
+                }
+            }
         }
-    return retval;
+
+    // if we got here, we didn't find the specified chunk
+    return NULL;
     }
 
-int gsd_truncate(struct gsd_handle* handle)
+const struct gsd_index_entry*
+gsd_find_chunk_at_or_before(struct gsd_handle* handle, uint64_t frame, const char* name)
     {
     if (handle == NULL)
         {
-        return GSD_ERROR_INVALID_ARGUMENT;
+        return NULL;
         }
-    if (handle->open_flags == GSD_OPEN_READONLY)
+    if (name == NULL)
         {
-        return GSD_ERROR_FILE_MUST_BE_WRITABLE;
+        return NULL;
         }
-
-    int retval = 0;
-
-    // deallocate indices
-    if (handle->frame_names.data.reserved > 0)
+    if (handle->open_flags == GSD_OPEN_APPEND)
         {
-        retval = gsd_byte_buffer_free(&handle->frame_names.data);
-        if (retval != GSD_SUCCESS)
-            {
-            return retval;
-            }
+        return NULL;
         }
 
-    if (handle->file_names.data.reserved > 0)
-        {
-        retval = gsd_byte_buffer_free(&handle->file_names.data);
-        if (retval != GSD_SUCCESS)
-            {
-            return retval;
-            }
-        }
+    // the index is up to date once the writer has written all frames
+    gsd_writer_wait(handle);
 
-    retval = gsd_name_id_map_free(&handle->name_map);
-    if (retval != GSD_SUCCESS)
+    uint16_t match_id = gsd_name_id_map_find(&handle->name_map, name);
+    if (match_id == UINT16_MAX)
         {
-        return retval;
+        return NULL;
         }
 
-    retval = gsd_index_buffer_free(&handle->file_index);
-    if (retval != GSD_SUCCESS)
+    if (gsd_chunk_history_update(handle) != GSD_SUCCESS)
         {
-        return retval;
+        return NULL;
         }
-
-    if (handle->frame_index.reserved > 0)
+    if (match_id >= handle->chunk_history.n_lists)
         {
-        retval = gsd_index_buffer_free(&handle->frame_index);
-        if (retval != GSD_SUCCESS)
-            {
-            return retval;
-            }
+        return NULL;
         }
 
-    if (handle->buffer_index.reserved > 0)
+    // binary search for the last chunk in a frame before or at the given frame
+    const struct gsd_chunk_list* list = &handle->chunk_history.lists[match_id];
+    size_t L = 0;
+    size_t R = list->size;
+    while (L < R)
         {
-        retval = gsd_index_buffer_free(&handle->buffer_index);
-        if (retval != GSD_SUCCESS)
+        size_t m = L + (R - L) / 2;
+        if (handle->file_index.data[list->position[m]].frame <= frame)
             {
-            return retval;
+            L = m + 1;
             }
-        }
-
-    if (handle->write_buffer.reserved > 0)
-        {
-        retval = gsd_byte_buffer_free(&handle->write_buffer);
-        if (retval != GSD_SUCCESS)
+        else
             {
-            return retval;
+            R = m;
             }
         }
 
-    // keep a copy of the old header
-    struct gsd_header old_header = handle->header;
-    retval = gsd_initialize_file(handle->fd,
-                                 old_header.application,
-                                 old_header.schema,
-                                 old_header.schema_version);
-
-    if (retval != GSD_SUCCESS)
+    if (L == 0)
         {
-        return retval;
+        return NULL;
         }
-
-    return gsd_initialize_handle(handle);
+    return &(handle->file_index.data[list->position[L - 1]]);
     }
 
-int gsd_close(struct gsd_handle* handle)
+int gsd_find_chunks(struct gsd_handle* handle,
+                    uint64_t frame,
+                    const char* const* names,
+                    size_t n_names,
+                    const struct gsd_index_entry** chunks)
     {
     if (handle == NULL)
         {
         return GSD_ERROR_INVALID_ARGUMENT;
         }
-
-    // save the fd so we can use it after freeing the handle
-    int fd = handle->fd;
-
-    int retval = gsd_index_buffer_free(&handle->file_index);
-    if (retval != GSD_SUCCESS)
+    if (n_names > 0 && (names == NULL || chunks == NULL))
         {
-        return retval;
+        return GSD_ERROR_INVALID_ARGUMENT;
         }
 
-    if (handle->frame_index.reserved > 0)
+    size_t i;
+    for (i = 0; i < n_names; i++)
         {
-        retval = gsd_index_buffer_free(&handle->frame_index);
-        if (retval != GSD_SUCCESS)
-            {
-            return retval;
-            }
+        chunks[i] = NULL;
+        }
+    if (n_names == 0 || frame >= gsd_get_nframes(handle)
+        || handle->open_flags == GSD_OPEN_APPEND)
+        {
+        return GSD_SUCCESS;
         }
 
-    if (handle->buffer_index.reserved > 0)
+    // sort the ids of the names that are in the file
+    struct gsd_id_request* requests
+        = (struct gsd_id_request*)malloc(sizeof(struct gsd_id_request) * n_names);
+    if (requests == NULL)
         {
-        retval = gsd_index_buffer_free(&handle->buffer_index);
-        if (retval != GSD_SUCCESS)
-            {
-            return retval;
-            }
+        return GSD_ERROR_MEMORY_ALLOCATION_FAILED;
         }
 
-    if (handle->write_buffer.reserved > 0)
+    size_t n_requests = 0;
+    for (i = 0; i < n_names; i++)
         {
-        retval = gsd_byte_buffer_free(&handle->write_buffer);
-        if (retval != GSD_SUCCESS)
+        if (names[i] == NULL)
             {
-            return retval;
+            continue;
+            }
+        uint16_t id = gsd_name_id_map_find(&handle->name_map, names[i]);
+        if (id != UINT16_MAX)
+            {
+            requests[n_requests].id = id;
+            requests[n_requests].position = i;
+            n_requests++;
             }
         }
+    qsort(requests, n_requests, sizeof(struct gsd_id_request), gsd_cmp_id_request);
 
-    retval = gsd_name_id_map_free(&handle->name_map);
-    if (retval != GSD_SUCCESS)
-        {
-        return retval;
-        }
+    // the index is up to date once the writer has written all frames
+    gsd_writer_wait(handle);
 
-    if (handle->frame_names.data.reserved > 0)
+    // match each entry of the frame with the requests for its id, later entries replace earlier
+    // ones like in gsd_find_chunk()
+    size_t begin;
+    size_t end;
+    gsd_find_frame(handle, frame, &begin, &end);
+
+    size_t cur_index;
+    for (cur_index = begin; cur_index < end; cur_index++)
         {
-        handle->frame_names.n_names = 0;
-        retval = gsd_byte_buffer_free(&handle->frame_names.data);
-        if (retval != GSD_SUCCESS)
+        const struct gsd_index_entry* entry = &handle->file_index.data[cur_index];
+        size_t L = 0;
+        size_t R = n_requests;
+        while (L < R)
             {
-            return retval;
+            size_t m = L + (R - L) / 2;
+            if (requests[m].id < entry->id)
+                {
+                L = m + 1;
+                }
+            else
+                {
+                R = m;
+                }
             }
-        }
 
-    if (handle->file_names.data.reserved > 0)
-        {
-        handle->file_names.n_names = 0;
-        retval = gsd_byte_buffer_free(&handle->file_names.data);
-        if (retval != GSD_SUCCESS)
+        for (; L < n_requests && requests[L].id == entry->id; L++)
             {
-            return retval;
+            chunks[requests[L].position] = entry;
             }
         }
 
-    // close the file
-    retval = close(fd);
-    if (retval != 0)
-        {
-        return GSD_ERROR_IO;
-        }
-
+    free(requests);
     return GSD_SUCCESS;
     }
 
-int gsd_end_frame(struct gsd_handle* handle)
+int gsd_read_chunk(struct gsd_handle* handle, void* data, const struct gsd_index_entry* chunk)
     {
     if (handle == NULL)
         {
         return GSD_ERROR_INVALID_ARGUMENT;
         }
-    if (handle->open_flags == GSD_OPEN_READONLY)
+    if (data == NULL)
         {
-        return GSD_ERROR_FILE_MUST_BE_WRITABLE;
+        return GSD_ERROR_INVALID_ARGUMENT;
+        }
+    if (chunk == NULL)
+        {
+        return GSD_ERROR_INVALID_ARGUMENT;
+        }
+    if (handle->open_flags == GSD_OPEN_APPEND)
+        {
+        return GSD_ERROR_FILE_MUST_BE_READABLE;
         }
 
-    // increment the frame counter
-    handle->cur_frame++;
+    // the file is up to date once the writer has written all frames
+    gsd_writer_wait(handle);
 
-    // flush the namelist buffer
-    int retval = gsd_flush_name_buffer(handle);
-    if (retval != GSD_SUCCESS)
+    size_t size = chunk->N * chunk->M * gsd_sizeof_type((enum gsd_type)chunk->type);
+    if (size == 0)
         {
-        return retval;
+        return GSD_ERROR_FILE_CORRUPT;
         }
-
-    // flush the write buffer
-    retval = gsd_flush_write_buffer(handle);
-    if (retval != GSD_SUCCESS)
+    if (chunk->location == 0)
         {
-        return retval;
+        return GSD_ERROR_FILE_CORRUPT;
         }
 
-    // write the frame index to the file
-    if (handle->frame_index.size > 0)
+    if (chunk->flags != 0)
         {
-        // ensure there is enough space in the index
-        if ((handle->file_index.size + handle->frame_index.size) > handle->file_index.reserved)
-            {
-            gsd_expand_file_index(handle, handle->file_index.size + handle->frame_index.size);
-            }
-
-        // sort the index before writing
-        retval = gsd_index_buffer_sort(&handle->frame_index);
-        if (retval != 0)
-            {
-            return retval;
-            }
-
-        // write the frame index entries to the file
-        int64_t write_pos = handle->header.index_location
-                            + sizeof(struct gsd_index_entry) * handle->file_index.size;
-
-        size_t bytes_to_write = sizeof(struct gsd_index_entry) * handle->frame_index.size;
-        ssize_t bytes_written
-            = gsd_io_pwrite_retry(handle->fd, handle->frame_index.data, bytes_to_write, write_pos);
-
-        if (bytes_written == -1 || bytes_written != bytes_to_write)
-            {
-            return GSD_ERROR_IO;
-            }
-
-#if !GSD_USE_MMAP
-        // add the entries to the file index
-        memcpy(handle->file_index.data + handle->file_index.size,
-               handle->frame_index.data,
-               sizeof(struct gsd_index_entry) * handle->frame_index.size);
-#endif
+        return gsd_read_encoded_chunk(handle, data, size, chunk);
+        }
 
-        // update size of file index
-        handle->file_index.size += handle->frame_index.size;
+    // validate that we don't read past the end of the file
+    if ((chunk->location + size) > (uint64_t)handle->file_size)
+        {
+        return GSD_ERROR_FILE_CORRUPT;
+        }
 
-        // clear the frame index
-        handle->frame_index.size = 0;
+    ssize_t bytes_read = gsd_io_pread_retry(handle->fd, data, size, chunk->location);
+    if (bytes_read == -1 || bytes_read != size)
+        {
+        return GSD_ERROR_IO;
         }
 
     return GSD_SUCCESS;
     }
 
-int gsd_write_chunk(struct gsd_handle* handle,
-                    const char* name,
-                    enum gsd_type type,
-                    uint64_t N,
-                    uint32_t M,
-                    uint8_t flags,
-                    const void* data)
+int gsd_read_chunk_into(struct gsd_handle* handle,
+                        void* data,
+                        enum gsd_type type,
+                        uint64_t N,
+                        uint32_t M,
+                        const struct gsd_index_entry* chunk)
     {
-    // validate input
-    if (N > 0 && data == NULL)
+    if (chunk == NULL)
         {
         return GSD_ERROR_INVALID_ARGUMENT;
         }
-    if (M == 0)
+    if (chunk->type != type || chunk->N != N || chunk->M != M)
         {
         return GSD_ERROR_INVALID_ARGUMENT;
         }
-    if (handle->open_flags == GSD_OPEN_READONLY)
+
+    return gsd_read_chunk(handle, data, chunk);
+    }
+
+int gsd_read_chunks(struct gsd_handle* handle,
+                    struct gsd_chunk_request* requests,
+                    size_t n_requests)
+    {
+    if (handle == NULL)
         {
-        return GSD_ERROR_FILE_MUST_BE_WRITABLE;
+        return GSD_ERROR_INVALID_ARGUMENT;
         }
-    if (flags != 0)
+    if (requests == NULL)
         {
         return GSD_ERROR_INVALID_ARGUMENT;
         }
-
-    uint16_t id = gsd_name_id_map_find(&handle->name_map, name);
-    if (id == UINT16_MAX)
+    if (handle->open_flags == GSD_OPEN_APPEND)
         {
-        // not found, append to the index
-        int retval = gsd_append_name(&id, handle, name);
-        if (retval != GSD_SUCCESS)
-            {
-            return retval;
-            }
-
-        if (id == UINT16_MAX)
-            {
-            // this should never happen
-            return GSD_ERROR_NAMELIST_FULL;
-            }
+        return GSD_ERROR_FILE_MUST_BE_READABLE;
+        }
+    if (n_requests == 0)
+        {
+        return GSD_SUCCESS;
         }
 
-    struct gsd_index_entry entry;
-    // populate fields in the entry's data
-    gsd_util_zero_memory(&entry, sizeof(struct gsd_index_entry));
-    entry.frame = handle->cur_frame;
-    entry.id = id;
-    entry.type = (uint8_t)type;
-    entry.N = N;
-    entry.M = M;
-    size_t size = N * M * gsd_sizeof_type(type);
+    // the file is up to date once the writer has written all frames
+    gsd_writer_wait(handle);
 
-    // decide whether to write this chunk to the buffer or straight to disk
-    if (size < handle->write_buffer.reserved / 2)
+    struct gsd_chunk_request** to_read = malloc(sizeof(struct gsd_chunk_request*) * n_requests);
+    if (to_read == NULL)
         {
-        // flush the buffer if this entry won't fit
-        if (size > (handle->write_buffer.reserved - handle->write_buffer.size))
+        return GSD_ERROR_MEMORY_ALLOCATION_FAILED;
+        }
+
+    // find the requested chunks and validate the ones to read
+    size_t n_to_read = 0;
+    size_t i;
+    for (i = 0; i < n_requests; i++)
+        {
+        struct gsd_chunk_request* request = requests + i;
+        if (request->chunk == NULL)
             {
-            gsd_flush_write_buffer(handle);
+            request->chunk = gsd_find_chunk(handle, request->frame, request->name);
             }
 
-        entry.location = handle->write_buffer.size;
-
-        // add an entry to the buffer index
-        struct gsd_index_entry* index_entry;
-
-        int retval = gsd_index_buffer_add(&handle->buffer_index, &index_entry);
-        if (retval != GSD_SUCCESS)
+        if (request->chunk == NULL || request->data == NULL || request->chunk->N == 0)
             {
-            return retval;
+            continue;
             }
-        *index_entry = entry;
 
-        // add the data to the write buffer
-        if (size > 0)
+        const struct gsd_index_entry* chunk = request->chunk;
+        if (chunk->flags != 0)
             {
-            retval = gsd_byte_buffer_append(&handle->write_buffer, data, size);
+            // compressed chunks are read one at a time
+            int retval = gsd_read_chunk(handle, request->data, chunk);
             if (retval != GSD_SUCCESS)
                 {
+                free(to_read);
                 return retval;
                 }
+            continue;
+            }
+
+        size_t size = chunk->N * chunk->M * gsd_sizeof_type((enum gsd_type)chunk->type);
+        if (size == 0 || chunk->location == 0
+            || (chunk->location + size) > (uint64_t)handle->file_size)
+            {
+            free(to_read);
+            return GSD_ERROR_FILE_CORRUPT;
             }
+
+        to_read[n_to_read] = request;
+        n_to_read++;
         }
-    else
+
+    // read the chunks in file order
+    qsort(to_read, n_to_read, sizeof(struct gsd_chunk_request*), gsd_cmp_chunk_request_location);
+
+#if GSD_USE_PREADV
+    // merge chunks that are adjacent in the file into a single read, reading small gaps between
+    // them into a scratch buffer
+    struct iovec iov[GSD_READ_MAX_IOV];
+    char* gap_buffer = NULL;
+
+    i = 0;
+    while (i < n_to_read)
         {
-        // add an entry to the frame index
-        struct gsd_index_entry* index_entry;
+        int64_t run_start = to_read[i]->chunk->location;
+        int64_t run_end = run_start;
+        int iovcnt = 0;
 
-        int retval = gsd_index_buffer_add(&handle->frame_index, &index_entry);
-        if (retval != GSD_SUCCESS)
+        // each chunk may need 2 buffers: one for the gap before it and one for its data
+        while (i < n_to_read && iovcnt + 2 <= GSD_READ_MAX_IOV)
             {
-            return retval;
-            }
-        *index_entry = entry;
+            const struct gsd_index_entry* chunk = to_read[i]->chunk;
+            size_t size = chunk->N * chunk->M * gsd_sizeof_type((enum gsd_type)chunk->type);
 
-        // find the location at the end of the file for the chunk
-        index_entry->location = handle->file_size;
+            if (iovcnt > 0)
+                {
+                // chunks requested more than once start a new read
+                if (chunk->location < run_end
+                    || (uint64_t)(chunk->location - run_end) > GSD_READ_MERGE_GAP)
+                    {
+                    break;
+                    }
 
-        // write the data
-        ssize_t bytes_written = gsd_io_pwrite_retry(handle->fd, data, size, index_entry->location);
-        if (bytes_written == -1 || bytes_written != size)
+                size_t gap = chunk->location - run_end;
+                if (gap > 0)
+                    {
+                    if (gap_buffer == NULL)
+                        {
+                        gap_buffer = malloc(GSD_READ_MERGE_GAP);
+                        if (gap_buffer == NULL)
+                            {
+                            free(to_read);
+                            return GSD_ERROR_MEMORY_ALLOCATION_FAILED;
+                            }
+                        }
+
+                    iov[iovcnt].iov_base = gap_buffer;
+                    iov[iovcnt].iov_len = gap;
+                    iovcnt++;
+                    }
+                }
+
+            iov[iovcnt].iov_base = to_read[i]->data;
+            iov[iovcnt].iov_len = size;
+            iovcnt++;
+            run_end = chunk->location + size;
+            i++;
+            }
+
+        ssize_t bytes_read = gsd_io_preadv_retry(handle->fd, iov, iovcnt, run_start);
+        if (bytes_read == -1 || bytes_read != run_end - run_start)
             {
+            free(gap_buffer);
+            free(to_read);
             return GSD_ERROR_IO;
             }
+        }
 
-        // update the file_size in the handle
-        handle->file_size += bytes_written;
+    free(gap_buffer);
+#else
+    for (i = 0; i < n_to_read; i++)
+        {
+        int retval = gsd_read_chunk(handle, to_read[i]->data, to_read[i]->chunk);
+        if (retval != GSD_SUCCESS)
+            {
+            free(to_read);
+            return retval;
+            }
         }
+#endif
 
+    free(to_read);
     return GSD_SUCCESS;
     }
 
-uint64_t gsd_get_nframes(struct gsd_handle* handle)
+int gsd_read_chunk_series(struct gsd_handle* handle,
+                          const char* name,
+                          uint64_t frame_begin,
+                          uint64_t frame_end,
+                          uint64_t stride,
+                          enum gsd_type type,
+                          uint64_t N,
+                          uint32_t M,
+                          void* data)
     {
-    if (handle == NULL)
+    if (handle == NULL || name == NULL || stride == 0)
         {
-        return 0;
+        return GSD_ERROR_INVALID_ARGUMENT;
         }
-    return handle->cur_frame;
-    }
-
-const struct gsd_index_entry*
-gsd_find_chunk(struct gsd_handle* handle, uint64_t frame, const char* name)
-    {
-    if (handle == NULL)
+    if (frame_end > gsd_get_nframes(handle))
         {
-        return NULL;
+        return GSD_ERROR_INVALID_ARGUMENT;
         }
-    if (name == NULL)
+    if (handle->open_flags == GSD_OPEN_APPEND)
         {
-        return NULL;
+        return GSD_ERROR_FILE_MUST_BE_READABLE;
         }
-    if (frame >= gsd_get_nframes(handle))
+    if (frame_begin >= frame_end)
         {
-        return NULL;
+        return GSD_SUCCESS;
         }
-    if (handle->open_flags == GSD_OPEN_APPEND)
+    if (data == NULL)
         {
-        return NULL;
+        return GSD_ERROR_INVALID_ARGUMENT;
         }
 
-    // find the id for the given name
-    uint16_t match_id = gsd_name_id_map_find(&handle->name_map, name);
-    if (match_id == UINT16_MAX)
+    uint16_t id = gsd_name_id_map_find(&handle->name_map, name);
+    if (id == UINT16_MAX)
         {
-        return NULL;
+        return GSD_ERROR_INVALID_ARGUMENT;
         }
 
-    if (handle->header.gsd_version >= gsd_make_version(2, 0))
+    size_t n_frames = (frame_end - frame_begin + stride - 1) / stride;
+    size_t frame_size = N * M * gsd_sizeof_type(type);
+    struct gsd_chunk_request* requests
+        = (struct gsd_chunk_request*)malloc(sizeof(struct gsd_chunk_request) * n_frames);
+    if (requests == NULL)
         {
-        // gsd 2.0 files sort the entire index
-        // binary search for the index entry
-        ssize_t L = 0;
-        ssize_t R = handle->file_index.size - 1;
-        struct gsd_index_entry T;
-        T.frame = frame;
-        T.id = match_id;
-
-        while (L <= R)
-            {
-            size_t m = (L + R) / 2;
-            int cmp = gsd_cmp_index_entry(handle->file_index.data + m, &T);
-            if (cmp == -1)
-                {
-                L = m + 1;
-                }
-            else if (cmp == 1)
-                {
-                R = m - 1;
-                }
-            else
-                {
-                return &(handle->file_index.data[m]);
-                }
-            }
+        return GSD_ERROR_MEMORY_ALLOCATION_FAILED;
         }
-    else
-        {
-        // gsd 1.0 file: use binary search to find the frame and linear search to find the entry
-        size_t L = 0;
-        size_t R = handle->file_index.size;
-
-        // progressively narrow the search window by halves
-        do
-            {
-            size_t m = (L + R) / 2;
-
-            if (frame < handle->file_index.data[m].frame)
-                {
-                R = m;
-                }
-            else
-                {
-                L = m;
-                }
-            } while ((R - L) > 1);
 
-        // this finds L = the rightmost index with the desired frame
-        int64_t cur_index;
-
-        // search all index entries with the matching frame
-        for (cur_index = L; (cur_index >= 0) && (handle->file_index.data[cur_index].frame == frame);
-             cur_index--)
+    // every frame must have the chunk with the same type and shape
+    size_t i;
+    for (i = 0; i < n_frames; i++)
+        {
+        uint64_t frame = frame_begin + i * stride;
+        const struct gsd_index_entry* chunk = gsd_find_chunk_id(handle, frame, id);
+        if (chunk == NULL || chunk->type != type || chunk->N != N || chunk->M != M)
             {
-            // if the frame matches, check the id
-            if (match_id == handle->file_index.data[cur_index].id)
-                {
-                return &(handle->file_index.data[cur_index]);
-                }
+            free(requests);
+            return GSD_ERROR_INVALID_ARGUMENT;
             }
+
+        requests[i].frame = frame;
+        requests[i].name = name;
+        requests[i].data = (char*)data + i * frame_size;
+        requests[i].chunk = chunk;
         }
 
-    // if we got here, we didn't find the specified chunk
-    return NULL;
+    int retval = gsd_read_chunks(handle, requests, n_frames);
+    free(requests);
+    return retval;
     }
 
-int gsd_read_chunk(struct gsd_handle* handle, void* data, const struct gsd_index_entry* chunk)
+int gsd_map_data(struct gsd_handle* handle)
     {
     if (handle == NULL)
         {
         return GSD_ERROR_INVALID_ARGUMENT;
         }
-    if (data == NULL)
+    if (handle->open_flags != GSD_OPEN_READONLY)
         {
         return GSD_ERROR_INVALID_ARGUMENT;
         }
-    if (chunk == NULL)
+    if (handle->file_map != NULL)
         {
-        return GSD_ERROR_INVALID_ARGUMENT;
+        return GSD_SUCCESS;
         }
-    if (handle->open_flags == GSD_OPEN_APPEND)
+
+#if GSD_USE_MMAP
+    void* file_map = mmap(NULL, handle->file_size, PROT_READ, MAP_SHARED, handle->fd, 0);
+    if (file_map == MAP_FAILED)
         {
-        return GSD_ERROR_FILE_MUST_BE_READABLE;
+        return GSD_ERROR_IO;
         }
 
-    size_t size = chunk->N * chunk->M * gsd_sizeof_type((enum gsd_type)chunk->type);
-    if (size == 0)
+    handle->file_map = file_map;
+    handle->file_map_len = handle->file_size;
+    return GSD_SUCCESS;
+#else
+    return GSD_ERROR_INVALID_ARGUMENT;
+#endif
+    }
+
+int gsd_build_search_tree(struct gsd_handle* handle)
+    {
+    if (handle == NULL)
         {
-        return GSD_ERROR_FILE_CORRUPT;
+        return GSD_ERROR_INVALID_ARGUMENT;
         }
-    if (chunk->location == 0)
+    if (handle->open_flags != GSD_OPEN_READONLY)
         {
-        return GSD_ERROR_FILE_CORRUPT;
+        return GSD_ERROR_INVALID_ARGUMENT;
         }
-
-    // validate that we don't read past the end of the file
-    if ((chunk->location + size) > (uint64_t)handle->file_size)
+    if (handle->search_tree.frame != NULL)
         {
-        return GSD_ERROR_FILE_CORRUPT;
+        return GSD_SUCCESS;
         }
 
-    ssize_t bytes_read = gsd_io_pread_retry(handle->fd, data, size, chunk->location);
-    if (bytes_read == -1 || bytes_read != size)
+    struct gsd_search_tree tree;
+    tree.size = (handle->file_index.size + GSD_SEARCH_TREE_STRIDE - 1) / GSD_SEARCH_TREE_STRIDE;
+    tree.frame = (uint64_t*)malloc(sizeof(uint64_t) * (tree.size + 1));
+    tree.position = (uint64_t*)malloc(sizeof(uint64_t) * (tree.size + 1));
+    if (tree.frame == NULL || tree.position == NULL)
         {
-        return GSD_ERROR_IO;
+        gsd_search_tree_free(&tree);
+        return GSD_ERROR_MEMORY_ALLOCATION_FAILED;
         }
 
+    tree.frame[0] = 0;
+    tree.position[0] = 0;
+    gsd_search_tree_fill(&tree, &handle->file_index, 1, 0);
+    handle->search_tree = tree;
     return GSD_SUCCESS;
     }
 
+const void* gsd_chunk_pointer(struct gsd_handle* handle, const struct gsd_index_entry* chunk)
+    {
+    if (handle == NULL || chunk == NULL || handle->file_map == NULL || chunk->flags != 0)
+        {
+        return NULL;
+        }
+
+    size_t size = chunk->N * chunk->M * gsd_sizeof_type((enum gsd_type)chunk->type);
+    if (size == 0 || chunk->location == 0
+        || (chunk->location + size) > (uint64_t)handle->file_map_len)
+        {
+        return NULL;
+        }
+
+    return (const char*)handle->file_map + chunk->location;
+    }
+
 size_t gsd_sizeof_type(enum gsd_type type)
     {
     size_t val = 0;
@@ -2235,6 +6178,10 @@ gsd_find_matching_chunk_name(struct gsd_handle* handle, const char* match, const
         {
         return NULL;
         }
+
+    // the name list is up to date once the writer has written all frames
+    gsd_writer_wait(handle);
+
     if (handle->file_names.n_names == 0)
         {
         return NULL;
@@ -2297,6 +6244,102 @@ gsd_find_matching_chunk_name(struct gsd_handle* handle, const char* match, const
     return NULL;
     }
 
+/** @internal
+    @brief Compare two gsd_name_id_pair by id
+
+    @param a Pointer to the first pair.
+    @param b Pointer to the second pair.
+
+    @returns -1 when a's id is less than b's, 1 when it is greater, and 0 when they are equal.
+*/
+static int gsd_cmp_name_id_pair_id(const void* a, const void* b)
+    {
+    uint16_t id_a = ((const struct gsd_name_id_pair*)a)->id;
+    uint16_t id_b = ((const struct gsd_name_id_pair*)b)->id;
+    if (id_a < id_b)
+        {
+        return -1;
+        }
+    if (id_a > id_b)
+        {
+        return 1;
+        }
+    return 0;
+    }
+
+int gsd_find_matching_chunk_names(struct gsd_handle* handle,
+                                  const char* match,
+                                  const char** names,
+                                  size_t* n_names)
+    {
+    if (handle == NULL || match == NULL || n_names == NULL)
+        {
+        return GSD_ERROR_INVALID_ARGUMENT;
+        }
+    if (*n_names > 0 && names == NULL)
+        {
+        return GSD_ERROR_INVALID_ARGUMENT;
+        }
+
+    // the name list is up to date once the writer has written all frames
+    gsd_writer_wait(handle);
+
+    struct gsd_name_id_map* map = &handle->name_map;
+    int retval = gsd_name_id_map_sort(map);
+    if (retval != GSD_SUCCESS)
+        {
+        return retval;
+        }
+
+    // names that match the prefix are adjacent in the directory
+    size_t match_len = strlen(match);
+    size_t begin = gsd_name_id_map_lower_bound(map, match);
+    size_t end = begin;
+    while (end < map->n_sorted
+           && strncmp(map->names + map->sorted[end].name, match, match_len) == 0)
+        {
+        end++;
+        }
+
+    struct gsd_name_id_pair* found = NULL;
+    if (end > begin)
+        {
+        found = malloc(sizeof(struct gsd_name_id_pair) * (end - begin));
+        if (found == NULL)
+            {
+            return GSD_ERROR_MEMORY_ALLOCATION_FAILED;
+            }
+        }
+
+    // skip names added in the frame that has not yet been written
+    size_t n_found = 0;
+    size_t i;
+    for (i = begin; i < end; i++)
+        {
+        if (map->sorted[i].id < handle->file_names.n_names)
+            {
+            found[n_found] = map->sorted[i];
+            n_found++;
+            }
+        }
+
+    // ids follow the order of the names in the file
+    if (n_found > 1)
+        {
+        qsort(found, n_found, sizeof(struct gsd_name_id_pair), gsd_cmp_name_id_pair_id);
+        }
+
+    size_t n_copy = (*n_names < n_found) ? *n_names : n_found;
+    for (i = 0; i < n_copy; i++)
+        {
+        names[i] = map->names + found[i].name;
+        }
+    *n_names = n_found;
+
+    free(found);
+    return GSD_SUCCESS;
+    }
+
 int gsd_upgrade(struct gsd_handle* handle)
     {
     if (handle == NULL)
@@ -2307,6 +6350,13 @@ int gsd_upgrade(struct gsd_handle* handle)
         {
         return GSD_ERROR_INVALID_ARGUMENT;
         }
+
+    int writer_retval = gsd_writer_wait(handle);
+    if (writer_retval != GSD_SUCCESS)
+        {
+        return writer_retval;
+        }
+
     if (handle->frame_index.size > 0 || handle->frame_names.n_names > 0)
         {
         return GSD_ERROR_INVALID_ARGUMENT;
@@ -2355,10 +6405,10 @@ int gsd_upgrade(struct gsd_handle* handle)
                 }
 
             // sync the updated index
-            retval = fsync(handle->fd);
-            if (retval != 0)
+            retval = gsd_sync_header_update(handle);
+            if (retval != GSD_SUCCESS)
                 {
-                return GSD_ERROR_IO;
+                return retval;
                 }
             }
 
@@ -2413,11 +6463,11 @@ int gsd_upgrade(struct gsd_handle* handle)
             handle->file_names.data = new_name_buf;
 
             // sync the updated name list
-            retval = fsync(handle->fd);
-            if (retval != 0)
+            retval = gsd_sync_header_update(handle);
+            if (retval != GSD_SUCCESS)
                 {
                 gsd_byte_buffer_free(&new_name_buf);
-                return GSD_ERROR_IO;
+                return retval;
                 }
             }
 
@@ -2433,10 +6483,10 @@ int gsd_upgrade(struct gsd_handle* handle)
             }
 
         // sync the updated header
-        int retval = fsync(handle->fd);
-        if (retval != 0)
+        int retval = gsd_sync_header_update(handle);
+        if (retval != GSD_SUCCESS)
             {
-            return GSD_ERROR_IO;
+            return retval;
             }
 
         // remap the file index
@@ -2445,6 +6495,8 @@ int gsd_upgrade(struct gsd_handle* handle)
             {
             return retval;
             }
+        gsd_frame_table_free(&handle->frame_table);
+        gsd_chunk_history_free(&handle->chunk_history);
 
         retval = gsd_index_buffer_map(&handle->file_index, handle);
         if (retval != 0)
@@ -65,6 +65,22 @@ extern "C"
         GSD_OPEN_APPEND
         };
 
+    /// When a writable GSD file is synchronized to the storage device
+    enum gsd_durability
+        {
+        /// Synchronize on every update of the file header and on close
+        GSD_DURABILITY_ALWAYS = 0,
+
+        /// Synchronize after every *sync_interval* frames and on close
+        GSD_DURABILITY_FRAMES,
+
+        /// Synchronize only on close
+        GSD_DURABILITY_CLOSE,
+
+        /// Never synchronize (except when requested with gsd_flush())
+        GSD_DURABILITY_NEVER
+        };
+
     /// Error return values
     enum gsd_error
         {
@@ -103,6 +119,28 @@ extern "C"
         GSD_ERROR_FILE_MUST_BE_READABLE = -9,
         };
 
+    /// Flags that select the compression of a chunk in gsd_write_chunk()
+    enum gsd_chunk_flag
+        {
+        /// Store the chunk data uncompressed.
+        GSD_COMPRESSION_NONE = 0,
+
+        /// Compress the chunk data with the built in LZ4 block codec.
+        GSD_COMPRESSION_LZ4 = 1,
+
+        /// Bits of the flags that select the compression codec.
+        GSD_COMPRESSION_MASK = 0x0f,
+
+        /// Byte shuffle the elements of the chunk before compressing it.
+        GSD_FILTER_SHUFFLE = 0x10,
+
+        /// Bit shuffle the elements of the chunk before compressing it.
+        GSD_FILTER_BITSHUFFLE = 0x20,
+
+        /// The chunk holds float data quantized by gsd_write_quantized_chunk().
+        GSD_FILTER_QUANTIZE = 0x40
+        };
+
     enum
         {
         /** v1 file: Size of a GSD name in memory. v2 file: The name buffer size is a multiple of
@@ -187,33 +225,74 @@ extern "C"
         uint8_t flags;
         };
 
+    /** Chunk read request
+
+        One element of the request array passed to gsd_read_chunks().
+    */
+    struct gsd_chunk_request
+        {
+        /// Frame index of the chunk to read.
+        uint64_t frame;
+
+        /// Name of the chunk to read.
+        const char* name;
+
+        /// Buffer to read the chunk data into (NULL to skip reading this chunk).
+        void* data;
+
+        /** Index entry of the chunk. Set to NULL to have gsd_read_chunks() find it from *frame*
+            and *name*. Set to NULL on output when the chunk is not present in the file.
+        */
+        const struct gsd_index_entry* chunk;
+        };
+
     /** Name/id mapping
 
-        A string name paired with an ID. Used for storing sorted name/id mappings in a hash map.
+        A slot in the name/id hash map.
     */
     struct gsd_name_id_pair
         {
-        /// Pointer to name (actual name storage is allocated in gsd_handle)
-        char* name;
+        /// Offset of the name in the name storage of the map
+        uint32_t name;
 
-        /// Next name/id pair with the same hash
-        struct gsd_name_id_pair* next;
+        /// Hash of the name
+        uint32_t hash;
 
-        /// Entry id
+        /// Entry id (UINT16_MAX in empty slots)
         uint16_t id;
         };
 
     /** Name/id hash map
 
-        A hash map of string names to integer identifiers.
+        An open addressing hash map of string names to integer identifiers. The map stores copies
+        of the names in a single allocation and a directory of the mappings sorted by name for
+        prefix searches.
     */
     struct gsd_name_id_map
         {
-        /// Name/id mappings
+        /// Name/id mappings (the number of slots is a power of 2)
         struct gsd_name_id_pair* v;
 
-        /// Number of entries in the mapping
+        /// Number of slots in the mapping
         size_t size;
+
+        /// Number of names in the mapping
+        size_t n_names;
+
+        /// Names in the mapping, each followed by a NULL terminator
+        char* names;
+
+        /// Number of bytes used in names
+        size_t names_size;
+
+        /// Number of bytes allocated in names
+        size_t names_reserved;
+
+        /// Name/id mappings in the order they were inserted, the first n_sorted sorted by name
+        struct gsd_name_id_pair* sorted;
+
+        /// Number of mappings at the start of sorted that are sorted by name
+        size_t n_sorted;
         };
 
     /** Array of index entries
@@ -238,6 +317,69 @@ extern "C"
         size_t mapped_len;
         };
 
+    /** Table of the positions of frames in the file index
+
+        gsd_find_chunk() fills in the position of each frame the first time it looks up a chunk in
+        that frame.
+    */
+    struct gsd_frame_table
+        {
+        /// Position in the file index of the first entry of each frame (UINT64_MAX when unknown)
+        uint64_t* start;
+
+        /// Number of elements allocated in start
+        size_t reserved;
+        };
+
+    /** Search tree over the frames of the file index
+
+        gsd_build_search_tree() samples the frame of every 128th entry of the file index and stores
+        the samples in Eytzinger (breadth first) order. Searches read the top levels of the tree
+        from a few cache lines and then read one page of the file index.
+    */
+    struct gsd_search_tree
+        {
+        /// Sampled frames in Eytzinger order, starting at element 1
+        uint64_t* frame;
+
+        /// Position in the file index of each sample
+        uint64_t* position;
+
+        /// Number of samples
+        size_t size;
+        };
+
+    /** Positions of the chunks with one name in the file index
+    */
+    struct gsd_chunk_list
+        {
+        /// Positions in the file index in increasing order
+        uint64_t* position;
+
+        /// Number of positions in the list
+        size_t size;
+
+        /// Number of elements allocated in position
+        size_t reserved;
+        };
+
+    /** Lists of the chunks of each name in the file index
+
+        gsd_find_chunk_at_or_before() builds the lists the first time it is called and extends
+        them with the entries of frames added later.
+    */
+    struct gsd_chunk_history
+        {
+        /// List of chunks for each name id
+        struct gsd_chunk_list* lists;
+
+        /// Number of elements allocated in lists
+        size_t n_lists;
+
+        /// Number of file index entries added to the lists
+        size_t n_indexed;
+        };
+
     /** Byte buffer
 
         Used to buffer of small data chunks held for a buffered write at the end of a frame. Also
@@ -269,6 +411,8 @@ extern "C"
         size_t n_names;
         };
 
+    struct gsd_writer;
+
     /** File handle
 
         A handle to an open GSD file.
@@ -289,6 +433,15 @@ extern "C"
         /// Mapped data chunk index
         struct gsd_index_buffer file_index;
 
+        /// Positions of frames in file_index
+        struct gsd_frame_table frame_table;
+
+        /// Search tree over the frames in file_index
+        struct gsd_search_tree search_tree;
+
+        /// Positions of the chunks of each name in file_index
+        struct gsd_chunk_history chunk_history;
+
         /// Index entries to append to the current frame
         struct gsd_index_buffer frame_index;
 
@@ -315,6 +468,24 @@ extern "C"
 
         /// Access the names in the namelist
         struct gsd_name_id_map name_map;
+
+        /// Read only mapping of the whole file (NULL if not mapped)
+        void* file_map;
+
+        /// Number of bytes in the file mapping
+        size_t file_map_len;
+
+        /// Background writer (NULL when frames are written by gsd_end_frame())
+        struct gsd_writer* writer;
+
+        /// When to synchronize the file to the storage device
+        enum gsd_durability durability;
+
+        /// Number of frames between synchronizations with GSD_DURABILITY_FRAMES
+        uint64_t sync_interval;
+
+        /// Number of frames written since the last synchronization
+        uint64_t unsynced_frames;
         };
 
     /** Specify a version
@@ -436,10 +607,13 @@ extern "C"
         @warning Ensure that all gsd_write_chunk() calls are committed with gsd_end_frame() before
         closing the file.
 
+        @note gsd_close() waits for the background writer to write all ended frames.
+
         @return
           - GSD_SUCCESS (0) on success. Negative value on failure:
           - GSD_ERROR_IO: IO error (check errno).
           - GSD_ERROR_INVALID_ARGUMENT: *handle* is NULL.
+          - Any error that the background writer encountered.
     */
     int gsd_close(struct gsd_handle* handle);
 
@@ -452,15 +626,122 @@ extern "C"
 
         @post The current frame counter is increased by 1 and cached indexes are written to disk.
 
+        @note When the background writer is enabled, gsd_end_frame() hands the frame to the writer
+        and returns. It waits only while the writer is still writing the previous frame.
+
         @return
           - GSD_SUCCESS (0) on success. Negative value on failure:
           - GSD_ERROR_IO: IO error (check errno).
           - GSD_ERROR_INVALID_ARGUMENT: *handle* is NULL.
           - GSD_ERROR_FILE_MUST_BE_WRITABLE: The file was opened read-only.
           - GSD_ERROR_MEMORY_ALLOCATION_FAILED: Unable to allocate memory.
+          - Any error that the background writer encountered while writing previous frames.
     */
     int gsd_end_frame(struct gsd_handle* handle);
 
+    /** Enable or disable the background writer
+
+        @param handle Handle to an open GSD file.
+        @param enable Non-zero to write frames in a background thread, 0 to write them in
+        gsd_end_frame().
+
+        @pre *handle* was opened by gsd_open() in a writable mode.
+
+        While the background writer is enabled, gsd_write_chunk() copies every chunk into the write
+        buffer and gsd_end_frame() hands the completed frame to a background thread that writes it
+        to the file. The caller fills the next frame while the writer writes the previous one, so
+        up to two frames of chunk data are held in memory. Functions that access the file contents
+        (such as gsd_find_chunk() and gsd_read_chunk()) first wait for the writer. Errors that the
+        writer encounters are returned by the next call to gsd_end_frame(), gsd_flush(), or
+        gsd_close(), and all frames ended after an error are discarded.
+
+        Disabling the background writer waits for it to write all ended frames.
+
+        @note The background writer is only available on platforms with POSIX threads.
+
+        @return
+          - GSD_SUCCESS (0) on success. Negative value on failure:
+          - GSD_ERROR_INVALID_ARGUMENT: *handle* is NULL or the platform does not support threads.
+          - GSD_ERROR_FILE_MUST_BE_WRITABLE: The file was opened read-only.
+          - GSD_ERROR_MEMORY_ALLOCATION_FAILED: Unable to allocate memory or start the thread.
+          - When disabling, any error that the background writer encountered.
+    */
+    int gsd_set_async(struct gsd_handle* handle, int enable);
+
+    /** Wait for all ended frames to be written and synchronize the file to disk
+
+        @param handle Handle to an open GSD file.
+
+        @pre *handle* was opened by gsd_open() in a writable mode.
+
+        @post All frames ended with gsd_end_frame() are in the file and the file is synchronized to
+        the storage device. Chunks written since the last call to gsd_end_frame() remain buffered.
+
+        @return
+          - GSD_SUCCESS (0) on success. Negative value on failure:
+          - GSD_ERROR_IO: IO error (check errno).
+          - GSD_ERROR_INVALID_ARGUMENT: *handle* is NULL.
+          - GSD_ERROR_FILE_MUST_BE_WRITABLE: The file was opened read-only.
+          - Any error that the background writer encountered.
+    */
+    int gsd_flush(struct gsd_handle* handle);
+
+    /** Reserve space in the file for future frames
+
+        @param handle Handle to an open GSD file.
+        @param n_frames Number of frames that will be added to the file.
+        @param entries_per_frame Number of chunks in each frame.
+        @param bytes Number of bytes of chunk data that the frames will add.
+
+        @pre *handle* was opened by gsd_open() in a writable mode.
+
+        @post The index can hold the chunks of *n_frames* additional frames without moving.
+
+        GSD moves the index to the end of the file and doubles its size whenever it fills, which
+        leaves the old copy unused in the file. Call gsd_reserve() before writing a run of known
+        length to size the index once. Where the platform supports it (Linux), gsd_reserve() also
+        allocates *bytes* of storage for the chunk data past the end of the file without changing
+        the file size.
+
+        @return
+          - GSD_SUCCESS (0) on success. Negative value on failure:
+          - GSD_ERROR_IO: IO error (check errno).
+          - GSD_ERROR_INVALID_ARGUMENT: *handle* is NULL or the number of entries overflows.
+          - GSD_ERROR_FILE_MUST_BE_WRITABLE: The file was opened read-only.
+          - GSD_ERROR_MEMORY_ALLOCATION_FAILED: Unable to allocate memory.
+          - Any error that the background writer encountered.
+    */
+    int gsd_reserve(struct gsd_handle* handle,
+                    uint64_t n_frames,
+                    uint64_t entries_per_frame,
+                    uint64_t bytes);
+
+    /** Set the durability policy
+
+        @param handle Handle to an open GSD file.
+        @param durability When to synchronize the file to the storage device.
+        @param sync_interval Number of frames between synchronizations with GSD_DURABILITY_FRAMES
+        (ignored otherwise).
+
+        @pre *handle* was opened by gsd_open() in a writable mode.
+
+        By default (GSD_DURABILITY_ALWAYS), GSD synchronizes the file to the storage device around
+        every update of the file header so that the file remains consistent after a system crash.
+        The other policies trade this guarantee for throughput: a system crash may lose the frames
+        written since the last synchronization or leave the file corrupt. A crash of the
+        application alone never loses ended frames. Where available, GSD uses fdatasync() instead
+        of fsync().
+
+        @return
+          - GSD_SUCCESS (0) on success. Negative value on failure:
+          - GSD_ERROR_INVALID_ARGUMENT: *handle* is NULL, *durability* is not valid, or
+            *sync_interval* is 0 with GSD_DURABILITY_FRAMES.
+          - GSD_ERROR_FILE_MUST_BE_WRITABLE: The file was opened read-only.
+    */
+    int gsd_set_durability(struct gsd_handle* handle,
+                           enum gsd_durability durability,
+                           uint64_t sync_interval);
+
     /** Write a data chunk to the current frame
 
         @param handle Handle to an open GSD file.
@@ -468,7 +749,8 @@ extern "C"
         @param type type ID that identifies the type of data in *data*.
         @param N Number of rows in the data.
         @param M Number of columns in the data.
-        @param flags set to 0, non-zero values reserved for future use.
+        @param flags Compression codec from gsd_chunk_flag, optionally combined with
+        GSD_FILTER_SHUFFLE or GSD_FILTER_BITSHUFFLE. Set to 0 to store the data uncompressed.
         @param data Data buffer.
 
         @pre *handle* was opened by gsd_open().
@@ -483,11 +765,15 @@ extern "C"
 
         @note *N* == 0 is allowed. When *N* is 0, *data* may be NULL.
 
+        @note Compressed chunks are stored uncompressed when compression does not reduce their size.
+        gsd_read_chunk() decompresses chunks transparently.
+
         @return
           - GSD_SUCCESS (0) on success. Negative value on failure:
           - GSD_ERROR_IO: IO error (check errno).
           - GSD_ERROR_INVALID_ARGUMENT: *handle* is NULL, *N* == 0, *M* == 0, *type* is invalid, or
-            *flags* != 0.
+            *flags* is not a valid combination of gsd_chunk_flag values or includes
+            GSD_FILTER_QUANTIZE.
           - GSD_ERROR_FILE_MUST_BE_WRITABLE: The file was opened read-only.
           - GSD_ERROR_NAMELIST_FULL: The file cannot store any additional unique chunk names.
           - GSD_ERROR_MEMORY_ALLOCATION_FAILED: failed to allocate memory.
@@ -500,6 +786,148 @@ extern "C"
                         uint8_t flags,
                         const void* data);
 
+    /** Look up the id of a chunk name
+
+        @param handle Handle to an open GSD file.
+        @param name Name of the data chunk.
+        @param[out] id Id of the name.
+
+        @pre *handle* was opened by gsd_open().
+
+        Pass the id to gsd_write_chunk_id() and gsd_find_chunk_id() to avoid looking up *name* on
+        every call. When *name* is not yet in the file and the file is writable,
+        gsd_intern_name() adds it to the names stored with the next frame. Ids remain valid until
+        the file is truncated or closed.
+
+        @return
+          - GSD_SUCCESS (0) on success. Negative value on failure:
+          - GSD_ERROR_INVALID_ARGUMENT: *handle*, *name*, or *id* is NULL.
+          - GSD_ERROR_FILE_MUST_BE_WRITABLE: *name* is not in the file, which was opened
+            read-only.
+          - GSD_ERROR_NAMELIST_FULL: The file cannot store any additional unique chunk names.
+          - GSD_ERROR_MEMORY_ALLOCATION_FAILED: failed to allocate memory.
+    */
+    int gsd_intern_name(struct gsd_handle* handle, const char* name, uint16_t* id);
+
+    /** Write a data chunk to the current frame by name id
+
+        @param handle Handle to an open GSD file.
+        @param id Id of the chunk name (from gsd_intern_name()).
+        @param type type ID that identifies the type of data in *data*.
+        @param N Number of rows in the data.
+        @param M Number of columns in the data.
+        @param flags Chunk flags (see gsd_write_chunk()).
+        @param data Data buffer.
+
+        Behaves as gsd_write_chunk() and skips the lookup of the name.
+
+        @return
+          - GSD_SUCCESS (0) on success. Negative value on failure:
+          - GSD_ERROR_IO: IO error (check errno).
+          - GSD_ERROR_INVALID_ARGUMENT: *handle* is NULL, *id* is not a valid name id, *M* == 0,
+            *type* is invalid, or *flags* is invalid.
+          - GSD_ERROR_FILE_MUST_BE_WRITABLE: The file was opened read-only.
+          - GSD_ERROR_MEMORY_ALLOCATION_FAILED: failed to allocate memory.
+    */
+    int gsd_write_chunk_id(struct gsd_handle* handle,
+                           uint16_t id,
+                           enum gsd_type type,
+                           uint64_t N,
+                           uint32_t M,
+                           uint8_t flags,
+                           const void* data);
+
+    /** Write a data chunk to the current frame without copying the data
+
+        @param handle Handle to an open GSD file.
+        @param name Name of the data chunk.
+        @param type type ID that identifies the type of data in *data*.
+        @param N Number of rows in the data.
+        @param M Number of columns in the data.
+        @param flags Chunk flags (see gsd_chunk_flag).
+        @param data Data buffer.
+        @param release Function that GSD calls with *user_data* when it no longer needs *data*
+        (may be NULL).
+        @param user_data Argument to pass to *release*.
+
+        @pre *handle* was opened by gsd_open().
+        @pre *name* is a unique name for data chunks in the given frame.
+        @pre data is allocated and contains at least `N * M * gsd_sizeof_type(type)` bytes.
+
+        When the background writer is enabled (see gsd_set_async()) and *flags* is 0, the caller
+        lends *data* to GSD instead of GSD copying it into the write buffer: the writer thread
+        writes the chunk straight from *data* after gsd_end_frame(). The caller must not modify or
+        free *data* until GSD calls *release*, which happens on the writer thread once the frame is
+        written (or discarded after an error). gsd_end_frame() returns only after the previous
+        frame is written, so without a *release* function, the data of a frame may be reused after
+        the call to gsd_end_frame() that follows the one that ended the frame, or after
+        gsd_flush().
+
+        Otherwise, gsd_write_chunk_lent() writes the chunk with gsd_write_chunk() and calls
+        *release* before it returns.
+
+        GSD calls *release* exactly once, also when gsd_write_chunk_lent() fails.
+
+        @return
+          - GSD_SUCCESS (0) on success. Negative value on failure:
+          - GSD_ERROR_IO: IO error (check errno).
+          - GSD_ERROR_INVALID_ARGUMENT: *handle* is NULL, *M* == 0, *type* is invalid, *flags* is
+            invalid, or *data* is NULL and *N* > 0.
+          - GSD_ERROR_FILE_MUST_BE_WRITABLE: The file was opened read-only.
+          - GSD_ERROR_NAMELIST_FULL: The file cannot store any additional unique chunk names.
+          - GSD_ERROR_MEMORY_ALLOCATION_FAILED: failed to allocate memory.
+    */
+    int gsd_write_chunk_lent(struct gsd_handle* handle,
+                             const char* name,
+                             enum gsd_type type,
+                             uint64_t N,
+                             uint32_t M,
+                             uint8_t flags,
+                             const void* data,
+                             void (*release)(void* user_data),
+                             void* user_data);
+
+    /** Write a float data chunk quantized to a fixed precision
+
+        @param handle Handle to an open GSD file.
+        @param name Name of the data chunk.
+        @param N Number of rows in the data.
+        @param M Number of columns in the data.
+        @param flags Compression codec from gsd_chunk_flag to apply to the quantized values.
+        @param data Data buffer of `N * M` floats.
+        @param precision Distance between adjacent representable values.
+        @param extent Array of *M* values, or NULL. Column *c* represents at least the range
+        [-extent[c]/2, extent[c]/2] (for example, the box lengths of particle positions).
+
+        @pre *handle* was opened by gsd_open().
+        @pre *name* is a unique name for data chunks in the given frame.
+
+        @post The chunk is stored with type GSD_TYPE_FLOAT. gsd_read_chunk() returns values that
+        differ from *data* by at most *precision* / 2.
+
+        Each column is stored as fixed point integers relative to its smallest value (or
+        -extent[c]/2) with just enough bits to represent its range. A column with range *L* takes
+        `ceil(log2(L / precision + 1))` bits per value.
+
+        @return
+          - GSD_SUCCESS (0) on success. Negative value on failure:
+          - GSD_ERROR_IO: IO error (check errno).
+          - GSD_ERROR_INVALID_ARGUMENT: *handle* is NULL, *M* == 0, *precision* is not positive,
+            *flags* includes a filter, a value in *data* is not finite, or the range of a column
+            exceeds `2^32 * precision`.
+          - GSD_ERROR_FILE_MUST_BE_WRITABLE: The file was opened read-only.
+          - GSD_ERROR_NAMELIST_FULL: The file cannot store any additional unique chunk names.
+          - GSD_ERROR_MEMORY_ALLOCATION_FAILED: failed to allocate memory.
+    */
+    int gsd_write_quantized_chunk(struct gsd_handle* handle,
+                                  const char* name,
+                                  uint64_t N,
+                                  uint32_t M,
+                                  uint8_t flags,
+                                  const float* data,
+                                  double precision,
+                                  const float* extent);
+
     /** Find a chunk in the GSD file
 
         @param handle Handle to an open GSD file
@@ -516,6 +944,69 @@ extern "C"
     const struct gsd_index_entry*
     gsd_find_chunk(struct gsd_handle* handle, uint64_t frame, const char* name);
 
+    /** Find a chunk in the GSD file by name id
+
+        @param handle Handle to an open GSD file
+        @param frame Frame to look for chunk
+        @param id Id of the chunk name (from gsd_intern_name() or the *id* member of an index
+        entry)
+
+        @pre *handle* was opened by gsd_open() in read or readwrite mode.
+
+        Behaves as gsd_find_chunk() and skips the lookup of the name.
+
+        @return A pointer to the found chunk, or NULL if not found.
+    */
+    const struct gsd_index_entry*
+    gsd_find_chunk_id(struct gsd_handle* handle, uint64_t frame, uint16_t id);
+
+    /** Find the most recent chunk with a given name at or before a frame
+
+        @param handle Handle to an open GSD file
+        @param frame Last frame to look for the chunk in
+        @param name Name of the chunk to find
+
+        @pre *handle* was opened by gsd_open() in read or readwrite mode.
+
+        Schemas may store a quantity only in the frames where it changes. This function finds the
+        value in effect at *frame*: the chunk named *name* in the latest frame that is not after
+        *frame* and contains such a chunk. The frame of the found chunk is in its *frame* member.
+
+        The first call builds a list of the frames that contain each name from the file index, so
+        that later calls take time logarithmic in the number of frames that contain *name*.
+
+        @return A pointer to the found chunk, or NULL if no frame up to *frame* has a chunk named
+        *name*.
+    */
+    const struct gsd_index_entry*
+    gsd_find_chunk_at_or_before(struct gsd_handle* handle, uint64_t frame, const char* name);
+
+    /** Find many chunks in one frame of the GSD file
+
+        @param handle Handle to an open GSD file.
+        @param frame Frame to look for chunks.
+        @param names Names of the chunks.
+        @param n_names Number of elements in *names*.
+        @param[out] chunks Found chunks, NULL for each name not present in the frame.
+
+        @pre *chunks* points to an array of at least *n_names* elements.
+
+        gsd_find_chunks() looks up the ids of all the names and then matches them to the entries of
+        the frame in one pass. It is faster than calling gsd_find_chunk() for each name when reading
+        most of the chunks in a frame. Like gsd_find_chunk(), it finds no chunks in files opened in
+        append mode.
+
+        @return
+          - GSD_SUCCESS (0) on success. Negative value on failure:
+          - GSD_ERROR_INVALID_ARGUMENT: *handle* is NULL, or *names* or *chunks* is NULL.
+          - GSD_ERROR_MEMORY_ALLOCATION_FAILED: Unable to allocate memory.
+    */
+    int gsd_find_chunks(struct gsd_handle* handle,
+                        uint64_t frame,
+                        const char* const* names,
+                        size_t n_names,
+                        const struct gsd_index_entry** chunks);
+
     /** Read a chunk from the GSD file
 
         @param handle Handle to an open GSD file.
@@ -527,15 +1018,174 @@ extern "C"
         @pre *data* points to an allocated buffer with at least `N * M * gsd_sizeof_type(type)`
        bytes.
 
+        @note Compressed chunks are decompressed into *data*.
+
         @return
           - GSD_SUCCESS (0) on success. Negative value on failure:
           - GSD_ERROR_IO: IO error (check errno).
           - GSD_ERROR_INVALID_ARGUMENT: *handle* is NULL, *data* is NULL, or *chunk* is NULL.
           - GSD_ERROR_FILE_MUST_BE_READABLE: The file was opened in append mode.
           - GSD_ERROR_FILE_CORRUPT: The GSD file is corrupt.
+          - GSD_ERROR_MEMORY_ALLOCATION_FAILED: Unable to allocate memory.
     */
     int gsd_read_chunk(struct gsd_handle* handle, void* data, const struct gsd_index_entry* chunk);
 
+    /** Read a chunk from the GSD file into a buffer of a given type and shape
+
+        @param handle Handle to an open GSD file.
+        @param data Data buffer to read into.
+        @param type Type of the elements in *data*.
+        @param N Number of rows in *data*.
+        @param M Number of columns in *data*.
+        @param chunk Chunk to read.
+
+        @pre *handle* was opened in read or readwrite mode.
+        @pre *chunk* was found by gsd_find_chunk().
+        @pre *data* points to an allocated buffer with at least `N * M * gsd_sizeof_type(type)`
+        bytes.
+
+        gsd_read_chunk_into() checks that the chunk has the given type and shape before reading it,
+        so callers can read the chunks of many frames into one reused buffer.
+
+        @return
+          - GSD_SUCCESS (0) on success. Negative value on failure:
+          - GSD_ERROR_IO: IO error (check errno).
+          - GSD_ERROR_INVALID_ARGUMENT: *handle* is NULL, *data* is NULL, *chunk* is NULL, or the
+            type or shape of *chunk* differs from *type*, *N*, and *M*.
+          - GSD_ERROR_FILE_MUST_BE_READABLE: The file was opened in append mode.
+          - GSD_ERROR_FILE_CORRUPT: The GSD file is corrupt.
+          - GSD_ERROR_MEMORY_ALLOCATION_FAILED: Unable to allocate memory.
+    */
+    int gsd_read_chunk_into(struct gsd_handle* handle,
+                            void* data,
+                            enum gsd_type type,
+                            uint64_t N,
+                            uint32_t M,
+                            const struct gsd_index_entry* chunk);
+
+    /** Read many chunks from the GSD file
+
+        @param handle Handle to an open GSD file.
+        @param requests Array of chunk requests.
+        @param n_requests Number of elements in *requests*.
+
+        @pre *handle* was opened in read or readwrite mode.
+        @pre For each request with a non-NULL *data*, *data* points to an allocated buffer with at
+        least `N * M * gsd_sizeof_type(type)` bytes of the requested chunk.
+
+        gsd_read_chunks() first finds every request with a NULL *chunk* by its *frame* and *name*.
+        Requests for chunks that are not present in the file are left with a NULL *chunk* and are
+        not read. Callers that need the chunk sizes to allocate the data buffers may call
+        gsd_find_chunk() first and pass the found entries in *chunk*.
+
+        The chunks are then read in the order of their location in the file. Chunks that are
+        adjacent (or separated by small gaps) in the file are read with a single vectored system
+        call where the platform supports it.
+
+        @return
+          - GSD_SUCCESS (0) on success. Negative value on failure:
+          - GSD_ERROR_IO: IO error (check errno).
+          - GSD_ERROR_INVALID_ARGUMENT: *handle* is NULL or *requests* is NULL.
+          - GSD_ERROR_FILE_MUST_BE_READABLE: The file was opened in append mode.
+          - GSD_ERROR_FILE_CORRUPT: The GSD file is corrupt.
+          - GSD_ERROR_MEMORY_ALLOCATION_FAILED: Unable to allocate memory.
+    */
+    int gsd_read_chunks(struct gsd_handle* handle,
+                        struct gsd_chunk_request* requests,
+                        size_t n_requests);
+
+    /** Read one chunk from a series of frames into a contiguous buffer
+
+        @param handle Handle to an open GSD file.
+        @param name Name of the chunk to read.
+        @param frame_begin First frame to read.
+        @param frame_end Read frames before *frame_end*.
+        @param stride Read every *stride*-th frame.
+        @param type Type of the elements in *data*.
+        @param N Number of rows of the chunk in each frame.
+        @param M Number of columns of the chunk in each frame.
+        @param data Data buffer to read into.
+
+        @pre *handle* was opened in read or readwrite mode.
+        @pre *data* points to an allocated buffer with at least
+        `n_frames * N * M * gsd_sizeof_type(type)` bytes, where `n_frames` is the number of frames
+        in the series.
+
+        gsd_read_chunk_series() stores the chunk of the i-th frame in the series at offset
+        `i * N * M * gsd_sizeof_type(type)` bytes in *data*. It reads the chunks of all frames with
+        gsd_read_chunks(), which reads them in file order and merges reads of neighboring chunks.
+
+        @return
+          - GSD_SUCCESS (0) on success. Negative value on failure:
+          - GSD_ERROR_IO: IO error (check errno).
+          - GSD_ERROR_INVALID_ARGUMENT: *handle* is NULL, *name* is NULL, *data* is NULL, *stride*
+            is 0, *frame_end* is greater than the number of frames in the file, or a frame in the
+            series does not have the chunk with the given type and shape.
+          - GSD_ERROR_FILE_MUST_BE_READABLE: The file was opened in append mode.
+          - GSD_ERROR_FILE_CORRUPT: The GSD file is corrupt.
+          - GSD_ERROR_MEMORY_ALLOCATION_FAILED: Unable to allocate memory.
+    */
+    int gsd_read_chunk_series(struct gsd_handle* handle,
+                              const char* name,
+                              uint64_t frame_begin,
+                              uint64_t frame_end,
+                              uint64_t stride,
+                              enum gsd_type type,
+                              uint64_t N,
+                              uint32_t M,
+                              void* data);
+
+    /** Map the file data for zero-copy access
+
+        @param handle Handle to an open GSD file.
+
+        @pre *handle* was opened by gsd_open() with GSD_OPEN_READONLY.
+
+        @post The whole file is mapped read only into memory and gsd_chunk_pointer() returns
+        pointers into the mapping. The mapping is released by gsd_close().
+
+        @return
+          - GSD_SUCCESS (0) on success. Negative value on failure:
+          - GSD_ERROR_IO: IO error (check errno).
+          - GSD_ERROR_INVALID_ARGUMENT: *handle* is NULL, *handle* was not opened with
+            GSD_OPEN_READONLY, or the platform does not support memory mapped files.
+    */
+    int gsd_map_data(struct gsd_handle* handle);
+
+    /** Build a search tree to find frames in the file index
+
+        @param handle Handle to an open GSD file.
+
+        @pre *handle* was opened by gsd_open() in GSD_OPEN_READONLY mode.
+
+        gsd_find_chunk() searches the whole file index the first time it looks up a chunk in a
+        frame. In a large memory mapped index, each step of that search may read a different page
+        from the file. gsd_build_search_tree() reads a sample of the index once and keeps it in
+        memory, so later searches read one page of the index. Call it after opening files with
+        large indices that will be read in random order.
+
+        @return
+          - GSD_SUCCESS (0) on success. Negative value on failure:
+          - GSD_ERROR_INVALID_ARGUMENT: *handle* is NULL or not open in GSD_OPEN_READONLY mode.
+          - GSD_ERROR_MEMORY_ALLOCATION_FAILED: Unable to allocate memory.
+    */
+    int gsd_build_search_tree(struct gsd_handle* handle);
+
+    /** Access a chunk's data without copying
+
+        @param handle Handle to an open GSD file.
+        @param chunk Chunk to access.
+
+        @pre gsd_map_data() has been called on *handle*.
+        @pre *chunk* was found by gsd_find_chunk().
+
+        @return A read only pointer to the first byte of the chunk data in the file mapping, or NULL
+        when the file is not mapped, the chunk has no data, or the chunk data cannot be accessed in
+        place (e.g. it is compressed). Callers should fall back to gsd_read_chunk() when this
+        returns NULL.
+    */
+    const void* gsd_chunk_pointer(struct gsd_handle* handle, const struct gsd_index_entry* chunk);
+
     /** Get the number of frames in the GSD file
 
         @param handle Handle to an open GSD file
@@ -573,6 +1223,37 @@ extern "C"
     const char*
     gsd_find_matching_chunk_name(struct gsd_handle* handle, const char* match, const char* prev);
 
+    /** Find all chunk names that begin with a given string
+
+        @param handle Handle to an open GSD file.
+        @param match String to match.
+        @param[out] names Matching chunk names.
+        @param[in,out] n_names Number of elements in *names* on input, number of matching names on
+        output.
+
+        @pre *handle* was opened by gsd_open()
+
+        gsd_find_matching_chunk_names() finds the same names as repeated calls to
+        gsd_find_matching_chunk_name() in the same order, the order of the names in the file. It
+        searches a directory of the names sorted by name, so it takes time logarithmic in the number
+        of names in the file plus linear in the number of matches. It stores at most *n_names*
+        matches in *names* and sets *n_names* to the total number of matches. Call it with
+        *n_names* set to 0 to count the matches.
+
+        The pointers in *names* remain valid until the next call to gsd_write_chunk() that adds a
+        new name, or until the file is closed.
+
+        @return
+          - GSD_SUCCESS (0) on success. Negative value on failure:
+          - GSD_ERROR_INVALID_ARGUMENT: *handle*, *match*, or *n_names* is NULL, or *names* is NULL
+            and *n_names* is not 0.
+          - GSD_ERROR_MEMORY_ALLOCATION_FAILED: Unable to allocate memory.
+    */
+    int gsd_find_matching_chunk_names(struct gsd_handle* handle,
+                                      const char* match,
+                                      const char** names,
+                                      size_t* n_names);
+
     /** Upgrade a GSD file to the latest specification.
 
         @param handle Handle to an open GSD file
@@ -22,6 +22,7 @@ import numpy
 from collections import OrderedDict
 import logging
 import json
+import functools
 
 try:
     from gsd import fl
@@ -36,6 +37,44 @@ except ImportError:
 logger = logging.getLogger('gsd.hoomd')
 
 
+class _LazyData(object):
+    """Read attributes from the file when they are first accessed.
+
+    Lazy snapshots read by `HOOMDTrajectory` hold a loader in place of each
+    per entry array attribute. The first access calls the loader and stores
+    the result as an ordinary attribute.
+    """
+
+    def __getattr__(self, name):
+        # Python calls __getattr__ only for attributes not in the instance
+        loaders = self.__dict__.get('_loaders')
+        if loaders is None or name not in loaders:
+            raise AttributeError("'" + type(self).__name__
+                                 + "' object has no attribute '" + name + "'")
+
+        value = loaders.pop(name)()
+        self.__dict__[name] = value
+        return value
+
+    def _read_later(self, name, loader):
+        """Replace the attribute *name* with a loader called on first access."""
+        self.__dict__.pop(name, None)
+        self.__dict__.setdefault('_loaders', {})[name] = loader
+
+    def __getstate__(self):
+        """Read all pending attributes so that copies do not need the file."""
+        for name in list(self.__dict__.get('_loaders', {})):
+            getattr(self, name)
+
+        state = self.__dict__.copy()
+        state.pop('_loaders', None)
+        return state
+
+    def __setstate__(self, state):
+        """Restore the attributes."""
+        self.__dict__.update(state)
+
+
 class ConfigurationData(object):
     """Store configuration data.
 
@@ -81,7 +120,7 @@ class ConfigurationData(object):
             self.box = self.box.reshape([6])
 
 
-class ParticleData(object):
+class ParticleData(_LazyData):
     """Store particle data chunks.
 
     Use the `Snapshot.particles` attribute of a to access the particles.
@@ -224,7 +263,7 @@ class ParticleData(object):
             self.image = self.image.reshape([self.N, 3])
 
 
-class BondData(object):
+class BondData(_LazyData):
     """Store bond data chunks.
 
     Use the `Snapshot.bonds`, `Snapshot.angles`, `Snapshot.dihedrals`,
@@ -306,7 +345,7 @@ class BondData(object):
             self.group = self.group.reshape([self.N, self.M])
 
 
-class ConstraintData(object):
+class ConstraintData(_LazyData):
     """Store constraint data chunks.
 
     Use the `Snapshot.constraints` attribute to access the constraints.
@@ -586,6 +625,69 @@ class Snapshot(object):
                 raise RuntimeError('Not a valid state: ' + k)
 
 
+_CHANGED_ONLY_CHUNK = 'hoomd/changed_only'
+
+
+def _is_per_entry(path, name):
+    """Test if a data chunk stores one value per particle, bond, etc..."""
+    return (path not in ('configuration', 'log')
+            and name not in ('N', 'types', 'type_shapes'))
+
+
+def _chunk_data(name, data):
+    """Convert snapshot data to the array stored in a data chunk."""
+    if name == 'N':
+        data = numpy.array([data], dtype=numpy.uint32)
+    if name == 'step':
+        data = numpy.array([data], dtype=numpy.uint64)
+    if name == 'dimensions':
+        data = numpy.array([data], dtype=numpy.uint8)
+    if name in ('types', 'type_shapes'):
+        if name == 'type_shapes':
+            data = [json.dumps(shape_dict) for shape_dict in data]
+        wid = max((len(w) for w in data), default=0) + 1
+        b = numpy.array(data, dtype=numpy.dtype((bytes, wid)))
+        data = b.view(dtype=numpy.int8).reshape(len(b), wid)
+    return data
+
+
+def _chunk_value(name, data):
+    """Convert a data chunk read from the file to snapshot data."""
+    if name in ('N', 'step', 'dimensions'):
+        return data[0]
+    if name in ('types', 'type_shapes'):
+        data = data.view(dtype=numpy.dtype((bytes, data.shape[1])))
+        data = [a.decode('UTF-8') for a in data.reshape([data.shape[0]])]
+        if name == 'type_shapes':
+            data = [json.loads(json_string) for json_string in data]
+    return data
+
+
+def _frame_chunk_names(snapshot, per_entry=True):
+    """List the names of the schema data chunks that a frame may store.
+
+    Set *per_entry* to ``False`` to omit the chunks that store one value per
+    particle, bond, etc...
+    """
+    names = []
+    for path in [
+            'configuration',
+            'particles',
+            'bonds',
+            'angles',
+            'dihedrals',
+            'impropers',
+            'constraints',
+            'pairs',
+    ]:
+        container = getattr(snapshot, path)
+        names.extend(path + '/' + name for name in container._default_value
+                     if per_entry or not _is_per_entry(path, name))
+
+    names.extend('state/' + state for state in snapshot._valid_state)
+    return names
+
+
 class _HOOMDTrajectoryIterable(object):
     """Iterable over a HOOMDTrajectory object."""
 
@@ -629,22 +731,73 @@ class _HOOMDTrajectoryView(object):
         else:
             return self._trajectory[self._indices[key]]
 
+    def select(self, names):
+        """Select data chunks of the frames in the view.
+
+        See `HOOMDTrajectory.select`.
+        """
+        plan = self._trajectory._plan_selection(names)
+        return _HOOMDTrajectorySelection(self._trajectory, plan, self._indices)
+
+
+class _HOOMDTrajectorySelection(object):
+    """Selected data chunks of a subset of a HOOMDTrajectory.
+
+    Iterating over a selection reads only the planned chunks of each frame.
+    """
+
+    def __init__(self, trajectory, plan, indices):
+        self._trajectory = trajectory
+        self._plan = plan
+        self._indices = indices
+
+    def __iter__(self):
+        for idx in self._indices:
+            yield self._trajectory._read_selection(idx, self._plan)
+
+    def __len__(self):
+        return len(self._indices)
+
+    def __getitem__(self, key):
+        if isinstance(key, slice):
+            return type(self)(self._trajectory, self._plan, self._indices[key])
+        else:
+            return self._trajectory._read_selection(self._indices[key],
+                                                    self._plan)
+
 
 class HOOMDTrajectory(object):
     """Read and write hoomd gsd files.
 
     Args:
         file (`gsd.fl.GSDFile`): File to access.
+        position_precision (float): When not ``None``, quantize particle
+            positions written by `append` to this precision.
+        changed_only (bool): Set to ``True`` to write data chunks only in the
+            frames where they change (see `append`).
+        lazy (bool): Set to ``True`` to read per particle, bond, etc...
+            arrays when they are first accessed (see `read_frame`).
 
     Open hoomd GSD files with `open`.
     """
 
-    def __init__(self, file):
+    def __init__(self,
+                 file,
+                 position_precision=None,
+                 changed_only=False,
+                 lazy=False):
         if file.mode == 'ab':
             raise ValueError('Append mode not yet supported')
+        if position_precision is not None and position_precision <= 0:
+            raise ValueError('position_precision must be positive')
 
         self._file = file
         self._initial_frame = None
+        self._position_precision = position_precision
+        self._changed_only = changed_only
+        self._lazy = lazy
+        self._written = {}
+        self._frame_chunk_names = {}
 
         logger.info('opening HOOMDTrajectory: ' + str(self.file))
 
@@ -661,6 +814,20 @@ class HOOMDTrajectory(object):
 
         logger.info('found ' + str(len(self)) + ' frames')
 
+        # files with frames keep the mode they were written with
+        if len(self) > 0:
+            in_file = self.file.chunk_exists(frame=0,
+                                             name=_CHANGED_ONLY_CHUNK)
+            if changed_only and not in_file:
+                raise ValueError('changed_only is not set in: '
+                                 + str(self.file))
+            self._changed_only = in_file
+
+    @property
+    def changed_only(self):
+        """bool: True when data chunks are written only when they change."""
+        return self._changed_only
+
     @property
     def file(self):
         """:class:`gsd.fl.GSDFile`: The underlying file handle."""
@@ -682,6 +849,18 @@ class HOOMDTrajectory(object):
         or the default value. If the given data differs, write it out to the
         frame. If it is the same, do not write it out as it can be instantiated
         either from the value at the initial frame or the default value.
+
+        When the trajectory is ``changed_only``, `append` compares each field
+        to the value that it has in the previous frame instead. It writes only
+        the fields that change, which reduces the size of files where some
+        quantities (such as the box, types, or bonds) rarely change. Fields
+        that are ``None`` keep their value from the previous frame.
+
+        When the trajectory has a ``position_precision``, `append` stores
+        ``particles/position`` as fixed point values relative to the box with
+        `gsd.fl.GSDFile.write_quantized_chunk`. Reading the frame returns
+        positions that differ from the appended ones by at most half the
+        precision.
         """
         logger.debug('Appending snapshot to hoomd trajectory: '
                      + str(self.file))
@@ -690,9 +869,16 @@ class HOOMDTrajectory(object):
 
         # want the initial frame specified as a reference to detect if chunks
         # need to be written
-        if self._initial_frame is None and len(self) > 0:
+        if (not self._changed_only and self._initial_frame is None
+                and len(self) > 0):
             self.read_frame(0)
 
+        # collect the chunks of the frame to write them in one call
+        chunks = {}
+
+        if self._changed_only and len(self) == 0:
+            chunks[_CHANGED_ONLY_CHUNK] = numpy.array([1], dtype=numpy.uint8)
+
         for path in [
                 'configuration',
                 'particles',
@@ -705,46 +891,74 @@ class HOOMDTrajectory(object):
         ]:
             container = getattr(snapshot, path)
             for name in container._default_value:
-                if self._should_write(path, name, snapshot):
+                if self._changed_only:
+                    write = self._has_changed(path, name, snapshot)
+                else:
+                    write = self._should_write(path, name, snapshot)
+
+                if write:
                     logger.debug('writing data chunk: ' + path + '/' + name)
-                    data = getattr(container, name)
-
-                    if name == 'N':
-                        data = numpy.array([data], dtype=numpy.uint32)
-                    if name == 'step':
-                        data = numpy.array([data], dtype=numpy.uint64)
-                    if name == 'dimensions':
-                        data = numpy.array([data], dtype=numpy.uint8)
-                    if name in ('types', 'type_shapes'):
-                        if name == 'type_shapes':
-                            data = [
-                                json.dumps(shape_dict) for shape_dict in data
-                            ]
-                        wid = max(len(w) for w in data) + 1
-                        b = numpy.array(data, dtype=numpy.dtype((bytes, wid)))
-                        data = b.view(dtype=numpy.int8).reshape(len(b), wid)
-
-                    self.file.write_chunk(path + '/' + name, data)
+                    data = _chunk_data(name, getattr(container, name))
+
+                    if self._changed_only:
+                        N = None
+                        if _is_per_entry(path, name):
+                            N = container.N
+                        self._written[path + '/' + name] = (N,
+                                                            numpy.array(data))
+
+                    if (path == 'particles' and name == 'position'
+                            and self._position_precision is not None):
+                        self._write_quantized_position(snapshot, data)
+                        continue
+
+                    chunks[path + '/' + name] = data
 
         # write state data
         for state, data in snapshot.state.items():
-            self.file.write_chunk('state/' + state, data)
+            chunks['state/' + state] = data
 
         # write log data
         for log, data in snapshot.log.items():
-            self.file.write_chunk('log/' + log, data)
+            if self._changed_only:
+                if not self._log_changed(log, data):
+                    continue
+                self._written['log/' + log] = (None, numpy.array(data))
 
-        self.file.end_frame()
+            chunks['log/' + log] = data
+
+        if hasattr(self.file, 'write_chunks'):
+            self.file.write_chunks(chunks)
+        else:
+            for name, data in chunks.items():
+                self.file.write_chunk(name, data)
+            self.file.end_frame()
+
+    def _write_quantized_position(self, snapshot, data):
+        """Write particle positions quantized relative to the box."""
+        box = snapshot.configuration.box
+        if box is None:
+            box = snapshot.configuration._default_value['box']
+        extent = numpy.array(box[0:3], dtype=numpy.float32)
+        if snapshot.configuration.dimensions == 2:
+            extent[2] = 0
+
+        self.file.write_quantized_chunk('particles/position',
+                                        data,
+                                        self._position_precision,
+                                        extent=extent)
 
     def truncate(self):
         """Remove all frames from the file."""
         self.file.truncate()
         self._initial_frame = None
+        self._written = {}
 
     def close(self):
         """Close the file."""
         self.file.close()
         del self._initial_frame
+        del self._written
 
     def _should_write(self, path, name, snapshot):
         """Test if we should write a given data chunk.
@@ -779,6 +993,162 @@ class HOOMDTrajectory(object):
 
         return True
 
+    def _has_changed(self, path, name, snapshot):
+        """Test if a data chunk differs from the value in the previous frame.
+
+        Args:
+            path (str): Path part of the data chunk.
+            name (str): Name part of the data chunk.
+            snapshot (:py:class:`Snapshot`): Snapshot data is from.
+
+        Returns:
+            False if the data matches the value that readers take from
+            earlier frames of a ``changed_only`` file, or the default value
+            when no earlier frame defines it. True otherwise.
+        """
+        container = getattr(snapshot, path)
+        data = getattr(container, name)
+
+        if data is None:
+            return False
+
+        chunk = path + '/' + name
+        if chunk not in self._written:
+            self._written[chunk] = self._read_written(path, name)
+
+        per_entry = _is_per_entry(path, name)
+        if self._written[chunk] is not None:
+            N, written_data = self._written[chunk]
+            if not per_entry or N == container.N:
+                return not numpy.array_equal(_chunk_data(name, data),
+                                             written_data)
+
+        if per_entry:
+            return not numpy.array_equiv(data, container._default_value[name])
+        return not numpy.array_equal(data, container._default_value[name])
+
+    def _log_changed(self, name, data):
+        """Test if logged data differs from the value in the previous frame."""
+        chunk = 'log/' + name
+        if chunk not in self._written:
+            self._written[chunk] = self._read_written('log', name)
+
+        if self._written[chunk] is None:
+            return True
+        return not numpy.array_equal(data, self._written[chunk][1])
+
+    def _read_written(self, path, name):
+        """Read the last value of a data chunk written to the file.
+
+        Returns:
+            A tuple of the *N* of the group at the frame where the chunk was
+            written (``None`` for quantities that are not per entry) and the
+            chunk data, or ``None`` when the file does not have the chunk.
+        """
+        if len(self) == 0 or self.file.mode in ('wb', 'xb'):
+            return None
+
+        chunk = path + '/' + name
+        frame = self.file.find_chunk_at_or_before(frame=len(self) - 1,
+                                                  name=chunk)
+        if frame is None:
+            return None
+
+        N = None
+        if _is_per_entry(path, name):
+            N = self._read_N(frame, path)
+        return (N, self.file.read_chunk(frame=frame, name=chunk))
+
+    def _chunk_frame(self, idx, name):
+        """Find the frame that defines a data chunk at the given frame.
+
+        Returns:
+            The index of the frame to read the chunk from, or ``None`` when no
+            frame defines the chunk.
+        """
+        if self._changed_only:
+            return self.file.find_chunk_at_or_before(frame=idx, name=name)
+
+        if self.file.chunk_exists(frame=idx, name=name):
+            return idx
+        return None
+
+    def _read_chunk(self, idx, name, chunks):
+        """Read the data chunk that defines a quantity at the given frame.
+
+        Args:
+            idx (int): Frame index.
+            name (str): Name of the chunk.
+            chunks (dict): Chunks read from frame *idx*.
+
+        Returns:
+            A tuple of the index of the frame the chunk was read from and the
+            chunk data, or ``(None, None)`` when no frame defines the chunk.
+        """
+        if name in chunks:
+            return idx, chunks[name]
+
+        if self._changed_only:
+            frame = self.file.find_chunk_at_or_before(frame=idx, name=name)
+            if frame is not None:
+                return frame, self.file.read_chunk(frame=frame, name=name)
+
+        return None, None
+
+    def _read_entries(self, idx, path, name, N, default, chunks=None):
+        """Read a per entry quantity of a group at the given frame.
+
+        Args:
+            idx (int): Frame index.
+            path (str): Name of the group.
+            name (str): Name of the quantity.
+            N (int): Number of entries in the group at frame *idx*.
+            default: Default value of one entry.
+            chunks (dict): Chunks read from frame *idx*, or ``None`` to read
+                the chunk now.
+
+        Returns:
+            The quantity read from the file, or from the initial frame or the
+            default value as a non-writable array when no frame defines it.
+        """
+        chunk = path + '/' + name
+        if chunks is None:
+            chunks = self.file.read_chunks(frame=idx, names=[chunk])
+
+        frame, data = self._read_chunk(idx, chunk, chunks)
+        if (frame is not None and frame != idx
+                and self._read_N(frame, path) != N):
+            # values written with a different N do not carry forward
+            frame = None
+
+        if frame is not None:
+            return data
+
+        # lazy reads of frame 0 find the initial frame, which is frame 0 itself
+        if self._initial_frame is not None and idx != 0:
+            initial_frame_container = getattr(self._initial_frame, path)
+            if initial_frame_container.N == N:
+                # read default from initial frame
+                data = getattr(initial_frame_container, name)
+                data.flags.writeable = False
+                return data
+
+        # initialize from default value
+        tmp = numpy.array([default])
+        s = list(tmp.shape)
+        s[0] = N
+        data = numpy.empty(shape=s, dtype=tmp.dtype)
+        data[:] = tmp
+        data.flags.writeable = False
+        return data
+
+    def _read_N(self, idx, path):
+        """Read the number of entries in a group at the given frame."""
+        frame = self._chunk_frame(idx, path + '/N')
+        if frame is None:
+            return 0
+        return self.file.read_chunk(frame=frame, name=path + '/N')[0]
+
     def extend(self, iterable):
         """Append each item of the iterable to the file.
 
@@ -803,20 +1173,40 @@ class HOOMDTrajectory(object):
         from frame 0, or initialize from default values if not in frame 0. Cache
         frame 0 data to avoid file read overhead. Return any default data as
         non-writable numpy arrays.
+
+        When the trajectory is lazy, read the configuration, the number of
+        entries and types of each group, state, and log data immediately, but
+        defer reading each per particle, bond, etc... array (and creating its
+        default value) until it is first accessed. Access the arrays of lazy
+        snapshots before closing the file.
         """
+        return self._read_frame(idx, self._lazy)
+
+    def _read_frame(self, idx, lazy):
+        """Read the frame at the given index, optionally as a lazy snapshot."""
         if idx >= len(self):
             raise IndexError
 
         logger.debug('reading frame ' + str(idx) + ' from: ' + str(self.file))
 
-        if self._initial_frame is None and idx != 0:
-            self.read_frame(0)
+        if (not self._changed_only and self._initial_frame is None
+                and idx != 0):
+            self._read_frame(0, lazy)
 
         snap = Snapshot()
+
+        # read all the chunks of the frame in one call
+        if lazy not in self._frame_chunk_names:
+            self._frame_chunk_names[lazy] = _frame_chunk_names(
+                snap, per_entry=not lazy)
+        logged_data_names = self.file.find_matching_chunk_names('log/')
+        chunks = self.file.read_chunks(frame=idx,
+                                       names=self._frame_chunk_names[lazy]
+                                       + logged_data_names)
+
         # read configuration first
-        if self.file.chunk_exists(frame=idx, name='configuration/step'):
-            step_arr = self.file.read_chunk(frame=idx,
-                                            name='configuration/step')
+        frame, step_arr = self._read_chunk(idx, 'configuration/step', chunks)
+        if frame is not None:
             snap.configuration.step = step_arr[0]
         else:
             if self._initial_frame is not None:
@@ -825,9 +1215,10 @@ class HOOMDTrajectory(object):
                 snap.configuration.step = \
                     snap.configuration._default_value['step']
 
-        if self.file.chunk_exists(frame=idx, name='configuration/dimensions'):
-            dimensions_arr = self.file.read_chunk(
-                frame=idx, name='configuration/dimensions')
+        frame, dimensions_arr = self._read_chunk(idx,
+                                                 'configuration/dimensions',
+                                                 chunks)
+        if frame is not None:
             snap.configuration.dimensions = dimensions_arr[0]
         else:
             if self._initial_frame is not None:
@@ -837,9 +1228,9 @@ class HOOMDTrajectory(object):
                 snap.configuration.dimensions = \
                     snap.configuration._default_value['dimensions']
 
-        if self.file.chunk_exists(frame=idx, name='configuration/box'):
-            snap.configuration.box = self.file.read_chunk(
-                frame=idx, name='configuration/box')
+        frame, box = self._read_chunk(idx, 'configuration/box', chunks)
+        if frame is not None:
+            snap.configuration.box = box
         else:
             if self._initial_frame is not None:
                 snap.configuration.box = self._initial_frame.configuration.box
@@ -862,8 +1253,8 @@ class HOOMDTrajectory(object):
                 initial_frame_container = getattr(self._initial_frame, path)
 
             container.N = 0
-            if self.file.chunk_exists(frame=idx, name=path + '/N'):
-                N_arr = self.file.read_chunk(frame=idx, name=path + '/N')
+            frame, N_arr = self._read_chunk(idx, path + '/N', chunks)
+            if frame is not None:
                 container.N = N_arr[0]
             else:
                 if self._initial_frame is not None:
@@ -871,11 +1262,9 @@ class HOOMDTrajectory(object):
 
             # type names
             if 'types' in container._default_value:
-                if self.file.chunk_exists(frame=idx, name=path + '/types'):
-                    tmp = self.file.read_chunk(frame=idx, name=path + '/types')
-                    tmp = tmp.view(dtype=numpy.dtype((bytes, tmp.shape[1])))
-                    tmp = tmp.reshape([tmp.shape[0]])
-                    container.types = list(a.decode('UTF-8') for a in tmp)
+                frame, tmp = self._read_chunk(idx, path + '/types', chunks)
+                if frame is not None:
+                    container.types = _chunk_value('types', tmp)
                 else:
                     if self._initial_frame is not None:
                         container.types = initial_frame_container.types
@@ -885,15 +1274,10 @@ class HOOMDTrajectory(object):
             # type shapes
             if ('type_shapes' in container._default_value
                     and path == 'particles'):
-                if self.file.chunk_exists(frame=idx,
-                                          name=path + '/type_shapes'):
-                    tmp = self.file.read_chunk(frame=idx,
-                                               name=path + '/type_shapes')
-                    tmp = tmp.view(dtype=numpy.dtype((bytes, tmp.shape[1])))
-                    tmp = tmp.reshape([tmp.shape[0]])
-                    container.type_shapes = \
-                        list(json.loads(json_string.decode('UTF-8'))
-                             for json_string in tmp)
+                frame, tmp = self._read_chunk(idx, path + '/type_shapes',
+                                              chunks)
+                if frame is not None:
+                    container.type_shapes = _chunk_value('type_shapes', tmp)
                 else:
                     if self._initial_frame is not None:
                         container.type_shapes = \
@@ -907,43 +1291,33 @@ class HOOMDTrajectory(object):
                     continue
 
                 # per particle/bond quantities
-                if self.file.chunk_exists(frame=idx, name=path + '/' + name):
-                    container.__dict__[name] = self.file.read_chunk(
-                        frame=idx, name=path + '/' + name)
+                default = container._default_value[name]
+                if lazy:
+                    container._read_later(
+                        name,
+                        functools.partial(self._read_entries, idx, path, name,
+                                          container.N, default))
                 else:
-                    if (self._initial_frame is not None
-                            and initial_frame_container.N == container.N):
-                        # read default from initial frame
-                        container.__dict__[name] = \
-                            initial_frame_container.__dict__[name]
-                    else:
-                        # initialize from default value
-                        tmp = numpy.array([container._default_value[name]])
-                        s = list(tmp.shape)
-                        s[0] = container.N
-                        container.__dict__[name] = numpy.empty(shape=s,
-                                                               dtype=tmp.dtype)
-                        container.__dict__[name][:] = tmp
-
-                    container.__dict__[name].flags.writeable = False
+                    container.__dict__[name] = self._read_entries(
+                        idx, path, name, container.N, default, chunks)
 
         # read state data
         for state in snap._valid_state:
-            if self.file.chunk_exists(frame=idx, name='state/' + state):
-                snap.state[state] = self.file.read_chunk(frame=idx,
-                                                         name='state/' + state)
+            if 'state/' + state in chunks:
+                snap.state[state] = chunks['state/' + state]
 
         # read log data
-        logged_data_names = self.file.find_matching_chunk_names('log/')
         for log in logged_data_names:
-            if self.file.chunk_exists(frame=idx, name=log):
-                snap.log[log[4:]] = self.file.read_chunk(frame=idx, name=log)
+            frame, data = self._read_chunk(idx, log, chunks)
+            if frame is not None:
+                snap.log[log[4:]] = data
             else:
-                if self._initial_frame is not None:
+                if (self._initial_frame is not None
+                        and log[4:] in self._initial_frame.log):
                     snap.log[log[4:]] = self._initial_frame.log[log[4:]]
 
         # store initial frame
-        if self._initial_frame is None and idx == 0:
+        if not self._changed_only and self._initial_frame is None and idx == 0:
             self._initial_frame = snap
 
         return snap
@@ -974,6 +1348,198 @@ class HOOMDTrajectory(object):
         """Iterate over HOOMD trajectories."""
         return _HOOMDTrajectoryIterable(self, range(len(self)))
 
+    def select(self, names):
+        """Select data chunks to read from each frame.
+
+        Args:
+            names (typing.List[str]): Names of the data chunks to read, such
+                as ``'particles/position'``, ``'configuration/box'``, or
+                ``'log/value'``.
+
+        Returns:
+            A sequence of the frames in the trajectory that can be indexed,
+            sliced, and iterated like the trajectory. Each frame is a `dict`
+            that maps the selected names to the values a `Snapshot` read with
+            `read_frame` would store.
+
+        Selections read only the selected chunks from each frame, plus the
+        number of entries in each group that has selected per particle, bond,
+        etc... quantities. They read each frame with a single call that reads
+        the chunks in file order. Chunks not present in a frame fall back to
+        the same values as in `read_frame`. Log and state chunks that no frame
+        defines are ``None``.
+
+        Example::
+
+            with gsd.hoomd.open(name='file.gsd', mode='rb') as traj:
+                for frame in traj.select(['particles/position',
+                                          'configuration/box'])[::10]:
+                    print(frame['configuration/box'])
+        """
+        return _HOOMDTrajectorySelection(self, self._plan_selection(names),
+                                         range(len(self)))
+
+    def read_log(self, names=None):
+        """Read logged quantities from all frames.
+
+        Args:
+            names (typing.List[str]): Names of the logged quantities to read
+                (the keys of `Snapshot.log`). ``None`` reads all logged
+                quantities that every frame defines.
+
+        Returns:
+            dict: Map of each name to a `numpy.ndarray` with one row for each
+            frame in the trajectory, with the shape returned by
+            `gsd.fl.GSDFile.read_series`.
+
+        Raises:
+            KeyError: When a frame does not define a quantity in *names*.
+            ValueError: When a quantity changes type or shape between frames.
+
+        The values for frames that do not store a quantity fall back to the
+        same values as in `read_frame`. `read_log` reads each quantity with a
+        single call when every frame stores it, and does not create `Snapshot`
+        objects.
+
+        Example::
+
+            with gsd.hoomd.open(name='file.gsd', mode='rb') as traj:
+                log = traj.read_log()
+                print(log['value/potential_energy'])
+        """
+        logged_data_names = self.file.find_matching_chunk_names('log/')
+        if names is None:
+            names = [log[4:] for log in logged_data_names]
+            skip_undefined = True
+        else:
+            skip_undefined = False
+
+        result = {}
+        for name in names:
+            chunk = 'log/' + name
+            if chunk in logged_data_names:
+                data = self._read_log_series(chunk)
+            else:
+                data = None
+
+            if data is not None:
+                result[name] = data
+            elif not skip_undefined:
+                raise KeyError('log quantity ' + name
+                               + ' is not defined in all frames of: '
+                               + str(self.file))
+
+        return result
+
+    def _read_log_series(self, chunk):
+        """Read a logged quantity from all frames.
+
+        Returns:
+            A `numpy.ndarray` with one row for each frame, or ``None`` when
+            a frame does not define the quantity.
+        """
+        if len(self) == 0:
+            return None
+
+        # read quantities that are stored in every frame with one call
+        try:
+            return self.file.read_series(chunk)
+        except (KeyError, ValueError):
+            pass
+
+        # otherwise find the frame that defines the quantity in each frame
+        sources = numpy.empty(len(self), dtype=numpy.int64)
+        initial = 0 if self.file.chunk_exists(frame=0, name=chunk) else None
+        for idx in range(len(self)):
+            if self._changed_only:
+                frame = self.file.find_chunk_at_or_before(frame=idx, name=chunk)
+            elif self.file.chunk_exists(frame=idx, name=chunk):
+                frame = idx
+            else:
+                frame = initial
+
+            if frame is None:
+                return None
+            sources[idx] = frame
+
+        frames, inverse = numpy.unique(sources, return_inverse=True)
+        values = [self.file.read_chunk(frame=f, name=chunk) for f in frames]
+        for value in values:
+            if value.dtype != values[0].dtype or value.shape != values[0].shape:
+                raise ValueError('log quantity ' + chunk[4:]
+                                 + ' changes type or shape in: '
+                                 + str(self.file))
+
+        return numpy.stack(values)[inverse]
+
+    def _plan_selection(self, names):
+        """Plan the reads of the data chunks selected by `select`.
+
+        Returns:
+            A tuple of the chunk names to read from each frame and a list of
+            ``(name, path, quantity, default)`` tuples for the selected chunks.
+        """
+        snap = Snapshot()
+        schema_names = set(_frame_chunk_names(snap))
+        read_names = list(names)
+        plan = []
+        for chunk in names:
+            if chunk not in schema_names and not chunk.startswith('log/'):
+                raise ValueError('Not a hoomd schema data chunk: ' + chunk)
+
+            path, name = chunk.split('/', 1)
+            default = None
+            if path not in ('log', 'state'):
+                default = getattr(snap, path)._default_value[name]
+                if (_is_per_entry(path, name)
+                        and path + '/N' not in read_names):
+                    read_names.append(path + '/N')
+            plan.append((chunk, path, name, default))
+
+        return read_names, plan
+
+    def _read_selection(self, idx, plan):
+        """Read the data chunks selected by `select` from the given frame."""
+        read_names, plan = plan
+        if idx < 0:
+            idx += len(self)
+        if idx >= len(self) or idx < 0:
+            raise IndexError()
+
+        # fall back to lazily read values from the initial frame
+        if (not self._changed_only and self._initial_frame is None
+                and idx != 0):
+            self._read_frame(0, lazy=True)
+
+        chunks = self.file.read_chunks(frame=idx, names=read_names)
+        values = {}
+        for chunk, path, name, default in plan:
+            if path == 'state':
+                values[chunk] = chunks.get(chunk)
+            elif path == 'log':
+                frame, data = self._read_chunk(idx, chunk, chunks)
+                if frame is None and self._initial_frame is not None:
+                    data = self._initial_frame.log.get(name)
+                values[chunk] = data
+            elif _is_per_entry(path, name):
+                N = self._read_value(idx, path, 'N', 0, chunks)
+                values[chunk] = self._read_entries(idx, path, name, N,
+                                                   default, chunks)
+            else:
+                values[chunk] = self._read_value(idx, path, name, default,
+                                                 chunks)
+
+        return values
+
+    def _read_value(self, idx, path, name, default, chunks):
+        """Read a quantity that is not per entry at the given frame."""
+        frame, data = self._read_chunk(idx, path + '/' + name, chunks)
+        if frame is not None:
+            return _chunk_value(name, data)
+        if self._initial_frame is not None:
+            return getattr(getattr(self._initial_frame, path), name)
+        return default
+
     def __enter__(self):
         """Enter the context manager."""
         return self
@@ -983,7 +1549,13 @@ class HOOMDTrajectory(object):
         self.file.close()
 
 
-def open(name, mode='rb'):
+def open(name,
+         mode='rb',
+         compression=None,
+         shuffle='byte',
+         position_precision=None,
+         changed_only=False,
+         lazy=False):
     """Open a hoomd schema GSD file.
 
     The return value of `open` can be used as a context manager.
@@ -991,6 +1563,18 @@ def open(name, mode='rb'):
     Args:
         name (str): File name to open.
         mode (str): File open mode.
+        compression (str): Compression codec for frames written to the file:
+            ``None`` or ``'lz4'`` (see `gsd.fl.open`).
+        shuffle (str): Filter applied to chunks before compression:
+            ``None``, ``'byte'``, or ``'bit'``.
+        position_precision (float): When not ``None``, store particle
+            positions as fixed point values with this precision (lossy).
+        changed_only (bool): Set to ``True`` to store data chunks only in the
+            frames where they change. Applies to new files, files with frames
+            keep the mode they were written with.
+        lazy (bool): Set to ``True`` to read per particle, bond, etc... arrays
+            of the frames when they are first accessed
+            (see `HOOMDTrajectory.read_frame`).
 
     Returns:
         An `HOOMDTrajectory` instance that accesses the file *name* with the
@@ -1038,6 +1622,11 @@ def open(name, mode='rb'):
                          mode=mode,
                          application='gsd.hoomd ' + gsd.__version__,
                          schema='hoomd',
-                         schema_version=[1, 4])
-
-    return HOOMDTrajectory(gsdfileobj)
+                         schema_version=[1, 5],
+                         compression=compression,
+                         shuffle=shuffle)
+
+    return HOOMDTrajectory(gsdfileobj,
+                           position_precision=position_precision,
+                           changed_only=changed_only,
+                           lazy=lazy)
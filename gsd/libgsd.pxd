@@ -23,6 +23,20 @@ cdef extern from "gsd.h" nogil:
         GSD_OPEN_READONLY
         GSD_OPEN_APPEND
 
+    cdef enum gsd_durability:
+        GSD_DURABILITY_ALWAYS=0
+        GSD_DURABILITY_FRAMES
+        GSD_DURABILITY_CLOSE
+        GSD_DURABILITY_NEVER
+
+    cdef enum gsd_chunk_flag:
+        GSD_COMPRESSION_NONE = 0
+        GSD_COMPRESSION_LZ4 = 1
+        GSD_COMPRESSION_MASK = 0x0f
+        GSD_FILTER_SHUFFLE = 0x10
+        GSD_FILTER_BITSHUFFLE = 0x20
+        GSD_FILTER_QUANTIZE = 0x40
+
     cdef enum gsd_error:
         GSD_SUCCESS = 0
         GSD_ERROR_IO = -1
@@ -56,6 +70,12 @@ cdef extern from "gsd.h" nogil:
         uint8_t type
         uint8_t flags
 
+    cdef struct gsd_chunk_request:
+        uint64_t frame
+        const char *name
+        void *data
+        const gsd_index_entry *chunk
+
     cdef struct gsd_namelist_entry:
         char name[64]
 
@@ -89,6 +109,8 @@ cdef extern from "gsd.h" nogil:
         gsd_open_flag open_flags
         gsd_name_id_map name_map
         uint64_t namelist_written_entries
+        void *file_map
+        size_t file_map_len
 
     uint32_t gsd_make_version(unsigned int major, unsigned int minor)
     int gsd_create(const char *fname,
@@ -107,6 +129,12 @@ cdef extern from "gsd.h" nogil:
     int gsd_truncate(gsd_handle* handle)
     int gsd_close(gsd_handle* handle)
     int gsd_end_frame(gsd_handle* handle)
+    int gsd_set_async(gsd_handle* handle, int enable)
+    int gsd_flush(gsd_handle* handle)
+    int gsd_reserve(gsd_handle* handle, uint64_t n_frames,
+                    uint64_t entries_per_frame, uint64_t bytes)
+    int gsd_set_durability(gsd_handle* handle, gsd_durability durability,
+                           uint64_t sync_interval)
     int gsd_write_chunk(gsd_handle* handle,
                         const char *name,
                         gsd_type type,
@@ -114,14 +142,65 @@ cdef extern from "gsd.h" nogil:
                         uint8_t M,
                         uint8_t flags,
                         const void *data)
+    int gsd_intern_name(gsd_handle* handle, const char *name, uint16_t *id)
+    int gsd_write_chunk_id(gsd_handle* handle,
+                           uint16_t id,
+                           gsd_type type,
+                           uint64_t N,
+                           uint32_t M,
+                           uint8_t flags,
+                           const void *data)
+    int gsd_write_chunk_lent(gsd_handle* handle,
+                             const char *name,
+                             gsd_type type,
+                             uint64_t N,
+                             uint32_t M,
+                             uint8_t flags,
+                             const void *data,
+                             void (*release)(void *user_data),
+                             void *user_data)
+    int gsd_write_quantized_chunk(gsd_handle* handle,
+                                  const char *name,
+                                  uint64_t N,
+                                  uint32_t M,
+                                  uint8_t flags,
+                                  const float *data,
+                                  double precision,
+                                  const float *extent)
     const gsd_index_entry* gsd_find_chunk(gsd_handle* handle,
                                           uint64_t frame,
                                           const char *name)
+    const gsd_index_entry* gsd_find_chunk_id(gsd_handle* handle,
+                                             uint64_t frame,
+                                             uint16_t id)
+    const gsd_index_entry* gsd_find_chunk_at_or_before(gsd_handle* handle,
+                                                       uint64_t frame,
+                                                       const char *name)
+    int gsd_find_chunks(gsd_handle* handle, uint64_t frame,
+                        const char* const* names, size_t n_names,
+                        const gsd_index_entry** chunks)
     int gsd_read_chunk(gsd_handle* handle, void* data,
                        const gsd_index_entry* chunk)
+    int gsd_read_chunk_into(gsd_handle* handle, void* data, gsd_type type,
+                            uint64_t N, uint32_t M,
+                            const gsd_index_entry* chunk)
+    int gsd_read_chunks(gsd_handle* handle, gsd_chunk_request* requests,
+                        size_t n_requests)
+    int gsd_read_chunk_series(gsd_handle* handle, const char *name,
+                              uint64_t frame_begin, uint64_t frame_end,
+                              uint64_t stride, gsd_type type, uint64_t N,
+                              uint32_t M, void* data)
+    int gsd_map_data(gsd_handle* handle)
+    int gsd_build_search_tree(gsd_handle* handle)
+    const void* gsd_chunk_pointer(gsd_handle* handle,
+                                  const gsd_index_entry* chunk)
     uint64_t gsd_get_nframes(gsd_handle* handle)
     size_t gsd_sizeof_type(gsd_type type)
     const char *gsd_find_matching_chunk_name(gsd_handle* handle,
                                              const char *match,
                                              const char *prev)
+    int gsd_find_matching_chunk_names(gsd_handle* handle,
+                                      const char *match,
+                                      const char **names,
+                                      size_t* n_names)
     int gsd_upgrade(gsd_handle *handle)
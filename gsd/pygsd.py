@@ -34,6 +34,7 @@ The :py:class:`GSDFile` in this module can be used with the
 from __future__ import print_function
 from __future__ import division
 import logging
+import mmap as _mmap
 import numpy
 import struct
 from collections import namedtuple
@@ -55,6 +56,40 @@ gsd_header_struct = struct.Struct('QQQQQII64s64s80s')
 gsd_index_entry = namedtuple('gsd_index_entry',
                              'frame N location M id type flags')
 gsd_index_entry_struct = struct.Struct('QQqIHBB')
+gsd_index_entry_dtype = numpy.dtype([('frame', numpy.uint64),
+                                     ('N', numpy.uint64),
+                                     ('location', numpy.int64),
+                                     ('M', numpy.uint32),
+                                     ('id', numpy.uint16),
+                                     ('type', numpy.uint8),
+                                     ('flags', numpy.uint8)])
+
+gsd_chunk_header_struct = struct.Struct('QQ')
+
+GSD_COMPRESSION_NONE = 0
+GSD_COMPRESSION_LZ4 = 1
+GSD_COMPRESSION_MASK = 0x0f
+GSD_FILTER_SHUFFLE = 0x10
+GSD_FILTER_BITSHUFFLE = 0x20
+GSD_FILTER_QUANTIZE = 0x40
+gsd_quantize_header_struct = struct.Struct('dQ')
+gsd_quantize_column_struct = struct.Struct('dQ')
+
+# objects that GSDFile reads as buffers
+_buffer_types = (bytes, bytearray, memoryview, _mmap.mmap)
+
+
+def _readonly_bytes(buffer):
+    """Return a read-only byte memoryview of *buffer*."""
+    view = memoryview(buffer).cast('B')
+    if view.readonly:
+        return view
+
+    # memoryview.toreadonly requires Python 3.8
+    array = numpy.frombuffer(view, dtype=numpy.uint8)
+    array.flags.writeable = False
+    return memoryview(array)
+
 
 gsd_type_mapping = {
     1: numpy.dtype('uint8'),
@@ -70,13 +105,198 @@ gsd_type_mapping = {
 }
 
 
+def _is_flags_valid(flags):
+    """Return True if the chunk flags select a known codec and filters."""
+    if flags & ~(GSD_COMPRESSION_MASK | GSD_FILTER_SHUFFLE
+                 | GSD_FILTER_BITSHUFFLE | GSD_FILTER_QUANTIZE):
+        return False
+
+    if flags & GSD_FILTER_SHUFFLE and flags & GSD_FILTER_BITSHUFFLE:
+        return False
+
+    if flags & GSD_FILTER_QUANTIZE and flags & (GSD_FILTER_SHUFFLE
+                                                | GSD_FILTER_BITSHUFFLE):
+        return False
+
+    return (flags & GSD_COMPRESSION_MASK) in (GSD_COMPRESSION_NONE,
+                                              GSD_COMPRESSION_LZ4)
+
+
+def _lz4_read_length(src, ip, length):
+    """Read the extension bytes of an LZ4 length."""
+    while True:
+        if ip >= len(src):
+            raise RuntimeError("Corrupt compressed chunk")
+        b = src[ip]
+        ip += 1
+        length += b
+        if b != 255:
+            return ip, length
+
+
+def _lz4_decompress(src, size):
+    """Decompress data in the LZ4 block format.
+
+    Args:
+        src (bytes): Compressed data.
+        size (int): Number of bytes expected after decompression.
+
+    Returns:
+        bytearray: The decompressed data.
+    """
+    dst = bytearray(size)
+    n = len(src)
+    ip = 0
+    op = 0
+
+    while ip < n:
+        token = src[ip]
+        ip += 1
+
+        length = token >> 4
+        if length == 15:
+            ip, length = _lz4_read_length(src, ip, length)
+        if length > n - ip or length > size - op:
+            raise RuntimeError("Corrupt compressed chunk")
+        dst[op:op + length] = src[ip:ip + length]
+        ip += length
+        op += length
+
+        # the last sequence has no match
+        if ip == n:
+            break
+
+        if n - ip < 2:
+            raise RuntimeError("Corrupt compressed chunk")
+        offset = src[ip] | (src[ip + 1] << 8)
+        ip += 2
+        if offset == 0 or offset > op:
+            raise RuntimeError("Corrupt compressed chunk")
+
+        length = token & 0x0f
+        if length == 15:
+            ip, length = _lz4_read_length(src, ip, length)
+        length += 4
+        if length > size - op:
+            raise RuntimeError("Corrupt compressed chunk")
+
+        start = op - offset
+        if offset >= length:
+            dst[op:op + length] = dst[start:start + length]
+        else:
+            # overlapping matches repeat the last offset bytes
+            pattern = bytes(dst[start:op]) * (length // offset + 1)
+            dst[op:op + length] = pattern[:length]
+        op += length
+
+    if op != size:
+        raise RuntimeError("Corrupt compressed chunk")
+
+    return dst
+
+
+def _decode_chunk(encoded, header, flags, dtype, size):
+    """Decompress the data of a chunk with non-zero flags.
+
+    Args:
+        encoded (bytes): Encoded data that follows the chunk header.
+        header (tuple): Chunk header (stored_size, data_size).
+        flags (int): Chunk flags.
+        dtype (numpy.dtype): Type of the chunk elements.
+        size (int): Number of bytes in the decoded chunk data.
+
+    Returns:
+        bytes: The decoded chunk data.
+    """
+    data_size = header[1]
+    codec = flags & GSD_COMPRESSION_MASK
+    if codec == GSD_COMPRESSION_LZ4:
+        data = _lz4_decompress(encoded, data_size)
+    else:
+        if len(encoded) != data_size:
+            raise RuntimeError("Corrupt compressed chunk")
+        data = encoded
+
+    if flags & GSD_FILTER_SHUFFLE and dtype.itemsize > 1:
+        shuffled = numpy.frombuffer(data, dtype=numpy.uint8)
+        data = shuffled.reshape([dtype.itemsize, -1]).T.tobytes()
+
+    if flags & GSD_FILTER_BITSHUFFLE:
+        data = _bit_unshuffle(data, dtype.itemsize)
+
+    if flags & GSD_FILTER_QUANTIZE:
+        data = _dequantize(data, size)
+
+    return data
+
+
+def _dequantize(data, size):
+    """Convert quantized values back to float32.
+
+    The quantized encoding holds the step, the origin and number of bits of
+    each column, and the quantized values packed least significant bit first.
+    """
+    step, M = gsd_quantize_header_struct.unpack_from(data, 0)
+    offset = gsd_quantize_header_struct.size
+    if M == 0 or M * gsd_quantize_column_struct.size > len(data) - offset \
+            or size % (M * 4) != 0:
+        raise RuntimeError("Corrupt quantized chunk")
+    N = size // (M * 4)
+
+    columns = [gsd_quantize_column_struct.unpack_from(
+        data, offset + c * gsd_quantize_column_struct.size) for c in range(M)]
+    offset += M * gsd_quantize_column_struct.size
+    row_bits = sum(bits for origin, bits in columns)
+    if any(bits > 32 for origin, bits in columns) \
+            or (N * row_bits + 7) // 8 != len(data) - offset:
+        raise RuntimeError("Corrupt quantized chunk")
+
+    # unpackbits orders bits most significant first
+    packed = numpy.frombuffer(data, dtype=numpy.uint8, offset=offset)
+    bits = numpy.unpackbits(packed.reshape([-1, 1]), axis=1)[:, ::-1]
+    bits = bits.reshape([-1])[:N * row_bits].reshape([N, row_bits])
+
+    result = numpy.empty([N, M], dtype=numpy.float32)
+    first = 0
+    for c, (origin, n_bits) in enumerate(columns):
+        weights = numpy.left_shift(numpy.uint64(1),
+                                   numpy.arange(n_bits, dtype=numpy.uint64))
+        q = bits[:, first:first + n_bits].astype(numpy.uint64).dot(weights)
+        result[:, c] = origin + q * step
+        first += n_bits
+
+    return result.tobytes()
+
+
+def _bit_unshuffle(data, type_size):
+    """Reverse the bit shuffle filter.
+
+    Bit plane ``8 * j + k`` holds bit k of byte j of the elements in multiples
+    of 8. The remaining elements follow unchanged.
+    """
+    count = len(data) // type_size
+    count8 = count - count % 8
+    planes = numpy.frombuffer(data, dtype=numpy.uint8, count=count8
+                              * type_size)
+    # unpackbits and packbits order bits most significant first
+    bits = numpy.unpackbits(planes.reshape([type_size, 8, count8 // 8, 1]),
+                            axis=3)
+    bits = bits[:, :, :, ::-1].reshape([type_size, 8, count8])
+    rows = numpy.packbits(bits[:, ::-1, :], axis=1)
+    return (rows.reshape([type_size, count8]).T.tobytes()
+            + bytes(data[count8 * type_size:]))
+
+
 class GSDFile(object):
     """GSD file access interface.
 
     Implemented in pure python and accepts any python file-like object.
 
     Args:
-        file: File-like object to read.
+        file: File-like object to read, or a `bytes`, `bytearray`,
+            `memoryview`, or `mmap.mmap` object with the contents of the file.
+        mmap (bool): Set to True to memory map *file*, which must have a
+            ``fileno()`` method.
 
     GSDFile implements an object oriented class interface to the GSD file
     layer. Use it to open an existing file in a **read-only** mode. For
@@ -102,17 +322,38 @@ class GSDFile(object):
 
             with GSDFile(open('file.gsd', mode='rb')) as f:
                 data = f.read_chunk(frame=0, name='chunk')
+
+        Read without copying::
+
+            with GSDFile(open('file.gsd', mode='rb'), mmap=True) as f:
+                data = f.read_chunk(frame=0, name='chunk')
+
+    When *file* is memory mapped or is a buffer, :py:meth:`read_chunk()`
+    returns read-only numpy arrays that view the buffer directly instead of
+    copying the data into new arrays. Compressed chunks are decoded into new
+    arrays. The views remain valid after the file is closed: the mapping is
+    released when the file is closed and the last array viewing it is freed.
     """
 
-    def __init__(self, file):
+    def __init__(self, file, mmap=False):
         self.__file = file
 
-        logger.info('opening file: ' + str(file))
+        if isinstance(file, _buffer_types):
+            self.__file_str = '<' + type(file).__name__ + '>'
+            self.__buffer = _readonly_bytes(file)
+        elif mmap:
+            self.__file_str = str(file)
+            self.__buffer = _readonly_bytes(
+                _mmap.mmap(file.fileno(), 0, access=_mmap.ACCESS_READ))
+        else:
+            self.__file_str = str(file)
+            self.__buffer = None
+
+        logger.info('opening file: ' + self.__file_str)
 
         # read the header
-        self.__file.seek(0)
         try:
-            header_raw = self.__file.read(gsd_header_struct.size)
+            header_raw = self.__read(0, gsd_header_struct.size)
         except UnicodeDecodeError:
             print("\nDid you open the file in binary mode (rb)?\n",
                   file=sys.stderr)
@@ -125,24 +366,21 @@ class GSDFile(object):
 
         # validate the header
         if self.__header.magic != 0x65DF65DF65DF65DF:
-            raise RuntimeError("Not a GSD file: " + str(self.__file))
+            raise RuntimeError("Not a GSD file: " + self.__file_str)
         if (self.__header.gsd_version < (1 << 16)
                 and self.__header.gsd_version != (0 << 16 | 3)):
             raise RuntimeError("Unsupported GSD file version: "
-                               + str(self.__file))
+                               + self.__file_str)
         if self.__header.gsd_version >= (3 << 16):
             raise RuntimeError("Unsupported GSD file version: "
-                               + str(self.__file))
-
-        # determine the file size (only works in python 3)
-        self.__file.seek(0, 2)
+                               + self.__file_str)
 
         # read the namelist block into a dict for easy lookup
         self.__namelist = {}
         c = 0
-        self.__file.seek(self.__header.namelist_location, 0)
-        namelist_raw = self.__file.read(self.__header.namelist_allocated_entries
-                                        * 64)
+        namelist_raw = bytes(
+            self.__read(self.__header.namelist_location,
+                        self.__header.namelist_allocated_entries * 64))
 
         names = namelist_raw.split(b'\x00')
 
@@ -153,46 +391,71 @@ class GSDFile(object):
                 c = c + 1
 
         # read the index block. Since this is a read-only implementation, only
-        # read in the used entries
-        self.__index = []
-        self.__file.seek(self.__header.index_location, 0)
-        for i in range(self.__header.index_allocated_entries):
-            index_entry_raw = self.__file.read(gsd_index_entry_struct.size)
-            if len(index_entry_raw) != gsd_index_entry_struct.size:
-                raise IOError
+        # keep the used entries
+        index_raw = self.__read(self.__header.index_location,
+                                self.__header.index_allocated_entries
+                                * gsd_index_entry_dtype.itemsize)
+        index = numpy.frombuffer(index_raw,
+                                 dtype=gsd_index_entry_dtype,
+                                 count=len(index_raw)
+                                 // gsd_index_entry_dtype.itemsize)
+
+        # 0 location signifies end of index
+        end = numpy.flatnonzero(index['location'] == 0)
+        if len(end) > 0:
+            index = index[:end[0]]
+        elif len(index) != self.__header.index_allocated_entries:
+            raise IOError
 
-            idx = gsd_index_entry._make(
-                gsd_index_entry_struct.unpack(index_entry_raw))
+        if not self.__is_index_valid(index):
+            raise RuntimeError("Corrupt GSD file: " + self.__file_str)
 
-            # 0 location signifies end of index
-            if idx.location == 0:
-                break
+        self.__index = index
 
-            if not self.__is_entry_valid(idx):
-                raise RuntimeError("Corrupt GSD file: " + str(self.__file))
+        # GSD 2.x files sort the entries of each frame by id
+        if self.__header.gsd_version >= (2 << 16):
+            self.__keys = (index['frame'] << numpy.uint64(16)) \
+                | index['id'].astype(numpy.uint64)
+        else:
+            self.__keys = None
 
-            if i > 0 and idx.frame < self.__index[i - 1].frame:
-                raise RuntimeError("Corrupt GSD file: " + str(self.__file))
+        self.__chunk_frames = {}
+        self.__is_open = True
 
-            self.__index.append(idx)
+    def __read(self, location, size):
+        """Read up to *size* bytes from the file at *location*."""
+        if self.__buffer is not None:
+            return self.__buffer[location:location + size]
 
-        self.__is_open = True
+        self.__file.seek(location, 0)
+        return self.__file.read(size)
+
+    def __is_index_valid(self, index):
+        """Return True if all entries in an index are valid."""
+        valid_types = numpy.zeros(256, dtype=bool)
+        valid_types[list(gsd_type_mapping.keys())] = True
+        if not numpy.all(valid_types[index['type']]):
+            return False
 
-    def __is_entry_valid(self, entry):
-        """Return True if an entry is valid."""
-        if entry.type not in gsd_type_mapping:
+        if numpy.any(index['M'] == 0):
             return False
 
-        if entry.M == 0:
+        if numpy.any(index['frame'] >= numpy.uint64(
+                self.__header.index_allocated_entries)):
             return False
 
-        if entry.frame >= self.__header.index_allocated_entries:
+        if numpy.any(index['id'] >= len(self.__namelist)):
             return False
 
-        if entry.id >= len(self.__namelist):
+        for flags in numpy.flatnonzero(numpy.bincount(index['flags'])):
+            if not _is_flags_valid(int(flags)):
+                return False
+
+        if numpy.any((index['flags'] & GSD_FILTER_QUANTIZE != 0)
+                     & (index['type'] != 9)):
             return False
 
-        if entry.flags != 0:
+        if numpy.any(index['frame'][1:] < index['frame'][:-1]):
             return False
 
         return True
@@ -206,12 +469,18 @@ class GSDFile(object):
         the context manager exits.
         """
         if self.__is_open:
-            logger.info('closing file: ' + str(self.__file))
+            logger.info('closing file: ' + self.__file_str)
             self.__handle = None
             self.__index = None
+            self.__keys = None
             self.__namelist = None
+            self.__chunk_frames = None
             self.__is_open = False
-            self.__file.close()
+
+            # views returned by read_chunk keep the buffer alive
+            self.__buffer = None
+            if not isinstance(self.__file, _buffer_types):
+                self.__file.close()
 
     def truncate(self):
         """Not implemented."""
@@ -232,30 +501,26 @@ class GSDFile(object):
         else:
             return None
 
-        # TODO: optimize for v2.0 files
-        # binary search for the first index entry at the requested frame
-        L = 0
-        R = len(self.__index)
-
-        # progressively narrow the search window by halves
-        while (R - L > 1):
-            m = (L + R) // 2
-
-            if frame < self.__index[m].frame:
-                R = m
-            else:
-                L = m
+        if frame < 0 or frame >= self.nframes:
+            return None
 
-        # this finds L = the rightmost index with the desired frame
-        # search all index entries with the matching frame
-        cur_index = L
-        while cur_index >= 0 and self.__index[cur_index].frame == frame:
-            if match_id == self.__index[cur_index].id:
-                return self.__index[cur_index]
-            cur_index = cur_index - 1
+        if self.__keys is not None:
+            # binary search for the entry with the requested frame and id
+            key = numpy.uint64(frame << 16 | match_id)
+            i = int(numpy.searchsorted(self.__keys, key))
+            if i == len(self.__keys) or self.__keys[i] != key:
+                return None
+        else:
+            # search all index entries with the matching frame
+            frames = self.__index['frame']
+            L = int(numpy.searchsorted(frames, numpy.uint64(frame), 'left'))
+            R = int(numpy.searchsorted(frames, numpy.uint64(frame), 'right'))
+            matches = numpy.flatnonzero(self.__index['id'][L:R] == match_id)
+            if len(matches) == 0:
+                return None
+            i = L + int(matches[-1])
 
-        # if we got here, we didn't find the specified chunk
-        return None
+        return gsd_index_entry._make(self.__index[i].item())
 
     def chunk_exists(self, frame, name):
         """Test if a chunk exists.
@@ -283,15 +548,49 @@ class GSDFile(object):
         chunk = self._find_chunk(frame, name)
         return chunk is not None
 
-    def read_chunk(self, frame, name):
+    def find_chunk_at_or_before(self, frame, name):
+        """Find the latest frame up to *frame* that contains a chunk.
+
+        Args:
+            frame (int): Index of the last frame to check
+            name (str): Name of the chunk
+
+        Returns:
+            int: Index of the latest frame not after *frame* that contains
+            a chunk named *name*, or ``None`` when there is no such frame.
+        """
+        if not self.__is_open:
+            raise ValueError("File is not open")
+        if frame < 0:
+            raise ValueError("frame must be non-negative")
+
+        if name not in self.__namelist:
+            return None
+        match_id = self.__namelist[name]
+
+        # list the frames that contain each name on first use
+        if match_id not in self.__chunk_frames:
+            self.__chunk_frames[match_id] = self.__index['frame'][
+                self.__index['id'] == match_id]
+
+        frames = self.__chunk_frames[match_id]
+        i = int(numpy.searchsorted(frames, numpy.uint64(frame), 'right'))
+        if i == 0:
+            return None
+        return int(frames[i - 1])
+
+    def read_chunk(self, frame, name, out=None):
         """Read a data chunk from the file and return it as a numpy array.
 
         Args:
             frame (int): Index of the frame to read
             name (str): Name of the chunk
+            out (numpy.ndarray): Array to read the data into. Must be C
+                contiguous and writeable, and have the type and shape of the
+                returned array.
 
         Returns:
-            `numpy.ndarray`: Data read from file.
+            `numpy.ndarray`: Data read from file, or *out* when it is given.
 
         Examples:
             Read a 1D array::
@@ -318,7 +617,8 @@ class GSDFile(object):
             Each call invokes a disk read and allocation of a
             new numpy array for storage. To avoid overhead, don't call
             :py:meth:`read_chunk()` on the same chunk repeatedly. Cache the
-            arrays instead.
+            arrays instead. When reading the same chunk from many frames,
+            pass the array read from a previous frame in ``out`` to reuse it.
         """
         if not self.__is_open:
             raise ValueError("File is not open")
@@ -327,21 +627,62 @@ class GSDFile(object):
 
         if chunk is None:
             raise KeyError("frame " + str(frame) + " / chunk " + name
-                           + " not found in: " + str(self.__file))
+                           + " not found in: " + self.__file_str)
 
-        logger.debug('read chunk: ' + str(self.__file) + ' - ' + str(frame)
+        logger.debug('read chunk: ' + self.__file_str + ' - ' + str(frame)
                      + ' - ' + name)
 
         size = chunk.N * chunk.M * gsd_type_mapping[chunk.type].itemsize
         if chunk.location == 0:
             raise RuntimeError("Corrupt chunk: " + str(frame) + " / " + name
-                               + " in file" + str(self.__file))
+                               + " in file" + self.__file_str)
+
+        if out is not None:
+            if chunk.M == 1:
+                shape = (chunk.N,)
+            else:
+                shape = (chunk.N, chunk.M)
+
+            dtype = gsd_type_mapping[chunk.type]
+            if (not isinstance(out, numpy.ndarray) or out.dtype != dtype
+                    or out.shape != shape):
+                raise ValueError("out must be an array with dtype "
+                                 + dtype.name + " and shape " + str(shape)
+                                 + " to read chunk: " + name)
+            if not out.flags.c_contiguous or not out.flags.writeable:
+                raise ValueError("out must be C contiguous and writeable")
+
+            # read uncompressed chunks directly into out
+            if size != 0 and chunk.flags == 0 and self.__buffer is None:
+                self.__file.seek(chunk.location, 0)
+                if self.__file.readinto(memoryview(out).cast('B')) != size:
+                    raise IOError
+                return out
 
         if (size == 0):
+            if out is not None:
+                return out
             return numpy.array([], dtype=gsd_type_mapping[chunk.type])
 
-        self.__file.seek(chunk.location, 0)
-        data_raw = self.__file.read(size)
+        if chunk.flags != 0:
+            header_raw = self.__read(chunk.location,
+                                     gsd_chunk_header_struct.size)
+            if len(header_raw) != gsd_chunk_header_struct.size:
+                raise IOError
+            header = gsd_chunk_header_struct.unpack(header_raw)
+            if header[1] != size and not chunk.flags & GSD_FILTER_QUANTIZE:
+                raise RuntimeError("Corrupt chunk: " + str(frame) + " / "
+                                   + name + " in file" + self.__file_str)
+
+            encoded = self.__read(
+                chunk.location + gsd_chunk_header_struct.size, header[0])
+            if len(encoded) != header[0]:
+                raise IOError
+
+            data_raw = _decode_chunk(encoded, header, chunk.flags,
+                                     gsd_type_mapping[chunk.type], size)
+        else:
+            data_raw = self.__read(chunk.location, size)
 
         if len(data_raw) != size:
             raise IOError
@@ -349,11 +690,88 @@ class GSDFile(object):
         data_npy = numpy.frombuffer(data_raw,
                                     dtype=gsd_type_mapping[chunk.type])
 
+        if out is not None:
+            out.reshape(-1)[:] = data_npy
+            return out
+
         if chunk.M == 1:
             return data_npy
         else:
             return data_npy.reshape([chunk.N, chunk.M])
 
+    def read_chunks(self, frame, names):
+        """Read many data chunks from one frame of the file.
+
+        Args:
+            frame (int): Index of the frame to read
+            names (list[str]): Names of the chunks
+
+        Returns:
+            dict[str, numpy.ndarray]: Data read from the file for each name in
+            *names* that is present in the frame.
+        """
+        if not self.__is_open:
+            raise ValueError("File is not open")
+
+        result = {}
+        for name in names:
+            if self._find_chunk(frame, name) is not None:
+                result[name] = self.read_chunk(frame, name)
+
+        return result
+
+    def read_series(self, name, start=0, stop=None, step=1, out=None):
+        """Read one data chunk from a series of frames into a single array.
+
+        Args:
+            name (str): Name of the chunk
+            start (int): First frame to read
+            stop (int): Read frames before *stop* (``None`` reads to the end
+                of the file)
+            step (int): Read every *step*-th frame
+            out (numpy.ndarray): Array to read the data into.
+
+        Returns:
+            numpy.ndarray: Data read from file with one row for each frame in
+            ``range(start, stop, step)``. Returns *out* when it is given.
+
+        See `gsd.fl.GSDFile.read_series`.
+        """
+        if not self.__is_open:
+            raise ValueError("File is not open")
+
+        if step < 1:
+            raise ValueError("step must be positive")
+
+        frames = range(*slice(start, stop, step).indices(self.nframes))
+        if len(frames) == 0:
+            raise ValueError("No frames to read chunk " + name + " from: "
+                             + self.__file_str)
+
+        first = self.read_chunk(frames[0], name)
+        shape = (len(frames),) + first.shape
+        if out is None:
+            out = numpy.empty(shape, dtype=first.dtype)
+        elif (not isinstance(out, numpy.ndarray) or out.dtype != first.dtype
+              or out.shape != shape):
+            raise ValueError("out must be an array with dtype "
+                             + first.dtype.name + " and shape " + str(shape)
+                             + " to read chunk: " + name)
+
+        out[0] = first
+        for i, frame in enumerate(frames[1:], start=1):
+            data = None
+            if self._find_chunk(frame, name) is not None:
+                data = self.read_chunk(frame, name)
+            if (data is None or data.dtype != first.dtype
+                    or data.shape != first.shape):
+                raise ValueError("chunk " + name + " is not present with the "
+                                 "same type and shape in all frames "
+                                 + str(frames) + " of: " + self.__file_str)
+            out[i] = data
+
+        return out
+
     def find_matching_chunk_names(self, match):
         """Find chunk names in the file that start with the string *match*.
 
@@ -372,11 +790,11 @@ class GSDFile(object):
 
     def __getstate__(self):
         """Implement the pickle protocol."""
-        return dict(name=self.name)
+        return dict(name=self.name, mmap=self.mmap)
 
     def __setstate__(self, state):
         """Implement the pickle protocol."""
-        self.__init__(open(state['name'], 'rb'))
+        self.__init__(open(state['name'], 'rb'), state.get('mmap', False))
 
     def __enter__(self):
         """Implement the context manager protocol."""
@@ -396,6 +814,11 @@ class GSDFile(object):
         """File-like object opened."""
         return self.__file
 
+    @property
+    def mmap(self):
+        """bool: True when read_chunk returns views of the file data."""
+        return self.__buffer is not None
+
     @property
     def mode(self):
         """str: Mode of the open file."""
@@ -438,4 +861,4 @@ class GSDFile(object):
         if len(self.__index) == 0:
             return 0
         else:
-            return self.__index[-1].frame + 1
+            return int(self.__index['frame'][-1]) + 1
@@ -1,5 +1,6 @@
 """Benchmark GSD HOOMD file read/write."""
 
+import argparse
 import time
 import gsd.fl
 import gsd.pygsd
@@ -14,6 +15,23 @@ from subprocess import call, PIPE
 # import logging
 # logging.basicConfig(level=logging.DEBUG)
 
+parser = argparse.ArgumentParser(description=__doc__)
+parser.add_argument('--compression',
+                    default=None,
+                    choices=['lz4'],
+                    help='compression codec for the written file')
+parser.add_argument('--shuffle',
+                    default='byte',
+                    choices=['none', 'byte', 'bit'],
+                    help='filter applied to chunks before compression')
+parser.add_argument('--position-precision',
+                    default=None,
+                    type=float,
+                    help='quantize particle positions to this precision')
+args = parser.parse_args()
+if args.shuffle == 'none':
+    args.shuffle = None
+
 
 def write_frame(file, frame, position, orientation):
     """Write a frame to the file."""
@@ -113,12 +131,20 @@ def run_benchmarks(N, size):
     # if the file size is small, write it once to warm up the disk
     if size < 64 * 1024**3:
         gsd.hoomd.open(mode='wb', name='test.gsd')
-        with gsd.hoomd.open(name='test.gsd', mode='wb') as hf:
+        with gsd.hoomd.open(name='test.gsd',
+                            mode='wb',
+                            compression=args.compression,
+                            shuffle=args.shuffle,
+                            position_precision=args.position_precision) as hf:
             write_file(hf, nframes, N, position, orientation)
 
     # write it again and time this one
     gsd.hoomd.open(mode='wb', name='test.gsd')
-    with gsd.hoomd.open(name='test.gsd', mode='wb') as hf:
+    with gsd.hoomd.open(name='test.gsd',
+                        mode='wb',
+                        compression=args.compression,
+                        shuffle=args.shuffle,
+                        position_precision=args.position_precision) as hf:
         start = time.time()
         write_file(hf, nframes, N, position, orientation)
 
@@ -129,6 +155,7 @@ def run_benchmarks(N, size):
     end = time.time()
 
     timings['write'] = actual_size / 1024**2 / (end - start)
+    timings['ratio'] = actual_size / os.path.getsize('test.gsd')
 
     # time how long it takes to open the file
     print("Opening file... ", file=sys.stderr, flush=True, end='')
@@ -173,37 +200,42 @@ def run_sweep(size, size_str):
         result = run_benchmarks(32 * 32, size)
 
         print("{0:<7} {1:<6} {2:<9.4g} {3:<12.4g} "
-              "{4:<11.4g} {5:<13.4g} {6:<11.3g}".format(
+              "{4:<11.4g} {5:<13.4g} {6:<11.3g} {7:<5.3g}".format(
                   size_str, "32^2", result['open_time'] * 1000, result['write'],
                   result['seq_read'], result['random_read'],
-                  result['random_read_time']))
+                  result['random_read_time'], result['ratio']))
         sys.stdout.flush()
 
     result = run_benchmarks(128 * 128, size)
 
     print("{0:<7} {1:<6} {2:<9.4g} {3:<12.4g} {4:<11.4g} {5:<13.4g} {6:<11.3g}"
-          .format(size_str, "128^2", result['open_time'] * 1000,
-                  result['write'], result['seq_read'], result['random_read'],
-                  result['random_read_time']))
+          " {7:<5.3g}".format(size_str, "128^2", result['open_time'] * 1000,
+                              result['write'], result['seq_read'],
+                              result['random_read'],
+                              result['random_read_time'], result['ratio']))
     sys.stdout.flush()
 
     result = run_benchmarks(1024 * 1024, size)
 
     print("{0:<7} {1:<6} {2:<9.4g} {3:<12.4g} {4:<11.4g} {5:<13.4g} {6:<11.3g}"
-          .format(size_str, "1024^2", result['open_time'] * 1000,
-                  result['write'], result['seq_read'], result['random_read'],
-                  result['random_read_time']))
+          " {7:<5.3g}".format(size_str, "1024^2", result['open_time'] * 1000,
+                              result['write'], result['seq_read'],
+                              result['random_read'],
+                              result['random_read_time'], result['ratio']))
     sys.stdout.flush()
 
 
-print("""
-======= ====== ========= ============ =========== ============= ===========
-Size    N      Open (ms) Write (MB/s) Read (MB/s) Random (MB/s) Random (ms)
-======= ====== ========= ============ =========== ============= ===========""")
+print("\n"
+      "======= ====== ========= ============ =========== ============= "
+      "=========== =====\n"
+      "Size    N      Open (ms) Write (MB/s) Read (MB/s) Random (MB/s) "
+      "Random (ms) Ratio\n"
+      "======= ====== ========= ============ =========== ============= "
+      "=========== =====")
 
 run_sweep(128 * 1024**2, "128 MiB")
 run_sweep(1 * 1024**3, "1 GiB")
 # run_sweep(128*1024**3, "128 GiB");
 
 print("======= ====== ========= ============ "
-      "=========== ============= ===========")
+      "=========== ============= =========== =====")
@@ -57,5 +57,30 @@ int main(int argc, char** argv) // NOLINT
     const double us = 1e-6;
     std::cout << "Sequential read time: " << time_per_key / us << " microseconds/key." << std::endl;
 
+    // read each frame with one batched call
+    std::vector<char> batch_data(data.size() * n_keys);
+    std::vector<gsd_chunk_request> requests(n_keys);
+
+    t1 = std::chrono::high_resolution_clock::now();
+
+    for (size_t frame = 0; frame < n_read; frame++)
+        {
+        for (size_t i = 0; i < n_keys; i++)
+            {
+            requests[i].frame = frame;
+            requests[i].name = names[i].c_str();
+            requests[i].data = &batch_data[i * data.size()];
+            requests[i].chunk = NULL;
+            }
+        gsd_read_chunks(&handle, &requests[0], n_keys);
+        }
+
+    t2 = std::chrono::high_resolution_clock::now();
+
+    time_span = std::chrono::duration_cast<std::chrono::duration<double>>(t2 - t1);
+    time_per_key = time_span.count() / double(n_keys) / double(n_read);
+
+    std::cout << "Batched read time: " << time_per_key / us << " microseconds/key." << std::endl;
+
     gsd_close(&handle);
     }
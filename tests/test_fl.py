@@ -10,9 +10,13 @@ import numpy
 import platform
 import pytest
 import random
+import pickle
+import mmap
 import pathlib
 import os
 import shutil
+import subprocess
+import sys
 
 test_path = pathlib.Path(os.path.realpath(__file__)).parent
 
@@ -555,6 +559,49 @@ def test_find_matching_chunk_names(tmp_path, open_mode):
         assert len(other_chunks) == 0
 
 
+def test_find_matching_chunk_names_many(tmp_path):
+    """Test find_matching_chunk_names with names added over many frames."""
+    rng = numpy.random.RandomState(12)
+    data = numpy.array([1], dtype=numpy.int32)
+    prefixes = ['log/', 'log/particles/', 'particles/', 'l', 'z']
+    matches = ['', 'l', 'log', 'log/', 'log/particles/', 'particles/', 'p',
+               'z', 'log/9', 'none']
+    written = []
+
+    def check(f, names):
+        for match in matches:
+            expected = [name for name in names if name.startswith(match)]
+            assert f.find_matching_chunk_names(match) == expected
+
+    with gsd.fl.open(name=tmp_path / 'test.gsd',
+                     mode='wb+',
+                     application='test_find_matching_chunk_names_many',
+                     schema='none',
+                     schema_version=[1, 2]) as f:
+        # alternate between frames with few and many new names
+        for n_new in [3, 40, 1, 200, 16, 17, 5]:
+            frame_names = []
+            for i in rng.randint(0, 1000, size=n_new):
+                name = prefixes[i % len(prefixes)] + str(i)
+                if name not in written and name not in frame_names:
+                    frame_names.append(name)
+                    f.write_chunk(name=name, data=data)
+
+            # names in the unfinished frame are not yet in the file
+            check(f, written)
+
+            f.end_frame()
+            written.extend(frame_names)
+            check(f, written)
+
+    with gsd.fl.open(name=tmp_path / 'test.gsd',
+                     mode='rb',
+                     application='test_find_matching_chunk_names_many',
+                     schema='none',
+                     schema_version=[1, 2]) as f:
+        check(f, written)
+
+
 def test_chunk_name_limit(tmp_path, open_mode):
     """Test that providing more than the maximum allowed chunk names errors."""
     with gsd.fl.open(name=tmp_path / 'test.gsd',
@@ -891,3 +938,1078 @@ def test_zero_size(tmp_path, open_mode):
         data_read = f.read_chunk(frame=0, name='data')
         assert data_read.shape == (0,)
         assert data_read.dtype == numpy.float32
+
+
+def test_read_chunks(tmp_path, open_mode):
+    """Test that read_chunks reads the same data as read_chunk."""
+    # 'large' bypasses the write buffer and leaves a gap between chunks
+    chunks = {
+        'a': numpy.array([1, 2, 3, 4], dtype=numpy.float32),
+        'b': numpy.array([[5, 6], [7, 8]], dtype=numpy.int64),
+        'c': numpy.array([9], dtype=numpy.uint8),
+        'empty': numpy.array([], dtype=numpy.float64),
+        'large': numpy.arange(3 * 1024 * 1024, dtype=numpy.uint32),
+    }
+
+    with gsd.fl.open(name=tmp_path / 'test_read_chunks.gsd',
+                     mode=open_mode.write,
+                     application='test_read_chunks',
+                     schema='none',
+                     schema_version=[1, 2]) as f:
+        for frame in range(3):
+            for name, data in chunks.items():
+                f.write_chunk(name=name, data=data + frame)
+            f.end_frame()
+        f.write_chunk(name='a', data=chunks['a'])
+        f.end_frame()
+
+        # files opened in write only mode find no chunks
+        if open_mode.write == 'wb':
+            assert f.read_chunks(frame=0, names=['a', 'b']) == {}
+
+    with gsd.fl.open(name=tmp_path / 'test_read_chunks.gsd',
+                     mode=open_mode.read,
+                     application='test_read_chunks',
+                     schema='none',
+                     schema_version=[1, 2]) as f:
+        names = ['large', 'c', 'missing', 'a', 'empty', 'b', 'a']
+        for frame in range(3):
+            data_read = f.read_chunks(frame=frame, names=names)
+            assert set(data_read.keys()) == set(chunks.keys())
+            for name in chunks:
+                expected = f.read_chunk(frame=frame, name=name)
+                assert data_read[name].dtype == expected.dtype
+                assert data_read[name].shape == expected.shape
+                numpy.testing.assert_array_equal(data_read[name], expected)
+
+        data_read = f.read_chunks(frame=3, names=names)
+        assert list(data_read.keys()) == ['a']
+        numpy.testing.assert_array_equal(data_read['a'], chunks['a'])
+
+        assert f.read_chunks(frame=4, names=names) == {}
+        assert f.read_chunks(frame=0, names=[]) == {}
+
+    # test again with pygsd
+    with gsd.pygsd.GSDFile(file=open(str(tmp_path / 'test_read_chunks.gsd'),
+                                     mode='rb')) as f:
+        data_read = f.read_chunks(frame=1, names=['c', 'missing', 'a'])
+        assert list(data_read.keys()) == ['c', 'a']
+        numpy.testing.assert_array_equal(data_read['c'], chunks['c'] + 1)
+        numpy.testing.assert_array_equal(data_read['a'], chunks['a'] + 1)
+
+
+@pytest.mark.skipif(platform.system() == 'Windows',
+                    reason="memory mapped files are not supported on Windows")
+def test_mmap(tmp_path):
+    """Test read-only views of memory mapped files."""
+    data = numpy.arange(1024, dtype=numpy.float64).reshape([512, 2])
+    with gsd.fl.open(name=tmp_path / 'test_mmap.gsd',
+                     mode='wb',
+                     application='test_mmap',
+                     schema='none',
+                     schema_version=[1, 2]) as f:
+        f.write_chunk(name='data', data=data)
+        f.write_chunk(name='small', data=numpy.array([1, 2, 3],
+                                                     dtype=numpy.uint16))
+        f.write_chunk(name='empty', data=numpy.array([], dtype=numpy.int32))
+        f.end_frame()
+
+    with pytest.raises(ValueError):
+        gsd.fl.open(name=tmp_path / 'test_mmap.gsd', mode='rb+', mmap=True)
+
+    f = gsd.fl.open(name=tmp_path / 'test_mmap.gsd', mode='rb', mmap=True)
+    assert f.mmap
+
+    data_read = f.read_chunk(frame=0, name='data')
+    assert not data_read.flags.writeable
+    numpy.testing.assert_array_equal(data_read, data)
+    with pytest.raises(ValueError):
+        data_read[0, 0] = 10
+
+    small = f.read_chunk(frame=0, name='small')
+    assert small.shape == (3,)
+    numpy.testing.assert_array_equal(small, [1, 2, 3])
+
+    empty = f.read_chunk(frame=0, name='empty')
+    assert empty.shape == (0,)
+    assert empty.dtype == numpy.int32
+
+    chunks = f.read_chunks(frame=0, names=['data', 'small', 'empty'])
+    numpy.testing.assert_array_equal(chunks['data'], data)
+    assert not chunks['data'].flags.writeable
+
+    # views remain valid after the file is closed
+    f.close()
+    with pytest.raises(ValueError):
+        f.read_chunk(frame=0, name='data')
+    del f
+    numpy.testing.assert_array_equal(data_read, data)
+    numpy.testing.assert_array_equal(small, [1, 2, 3])
+    del data_read, small, chunks
+
+
+@pytest.mark.parametrize('async_write', [False, True])
+@pytest.mark.parametrize('compression', [None, 'lz4'])
+def test_write_chunks(tmp_path, async_write, compression):
+    """Test writing many chunks in one call."""
+    name = tmp_path / 'test_write_chunks.gsd'
+    with gsd.fl.open(name=name,
+                     mode='wb',
+                     application='test_write_chunks',
+                     schema='none',
+                     schema_version=[1, 2],
+                     async_write=async_write,
+                     compression=compression) as f:
+        for frame in range(3):
+            f.write_chunks({
+                'uint8': numpy.array([frame], dtype=numpy.uint8),
+                'float64': numpy.full((10, 3), frame, dtype=numpy.float64),
+                'list': [frame, frame + 1],
+                'scalar': numpy.float32(frame),
+                'empty': numpy.array([], dtype=numpy.int32),
+            })
+
+        # add chunks to a frame before ending it
+        f.write_chunks({'a': numpy.array([1], dtype=numpy.int16)},
+                       end_frame=False)
+        f.write_chunk(name='b', data=numpy.array([2], dtype=numpy.int16))
+        f.end_frame()
+
+        # invalid chunks are not written
+        with pytest.raises(ValueError):
+            f.write_chunks({
+                'c': numpy.array([3], dtype=numpy.int16),
+                'd': numpy.zeros((2, 2, 2), dtype=numpy.float32),
+            })
+        with pytest.raises(ValueError):
+            f.write_chunks({
+                'c': numpy.array([3], dtype=numpy.int16),
+                'd': numpy.array([1 + 2j]),
+            })
+
+    with gsd.fl.open(name=name, mode='rb') as f:
+        assert f.nframes == 4
+        for frame in range(3):
+            assert f.read_chunk(frame=frame, name='uint8')[0] == frame
+            assert f.read_chunk(frame=frame, name='uint8').dtype == numpy.uint8
+            numpy.testing.assert_array_equal(
+                f.read_chunk(frame=frame, name='float64'),
+                numpy.full((10, 3), frame))
+            numpy.testing.assert_array_equal(
+                f.read_chunk(frame=frame, name='list'), [frame, frame + 1])
+            assert f.read_chunk(frame=frame, name='scalar')[0] == frame
+            assert len(f.read_chunk(frame=frame, name='empty')) == 0
+
+        assert f.read_chunk(frame=3, name='a')[0] == 1
+        assert f.read_chunk(frame=3, name='b')[0] == 2
+        assert f.find_matching_chunk_names('c') == []
+        assert f.find_matching_chunk_names('d') == []
+
+
+@pytest.mark.parametrize('compression', [None, 'lz4'])
+def test_read_chunk_out(tmp_path, compression):
+    """Test reading chunks into caller provided arrays."""
+    name = tmp_path / 'test_read_chunk_out.gsd'
+    with gsd.fl.open(name=name,
+                     mode='wb',
+                     application='test_read_chunk_out',
+                     schema='none',
+                     schema_version=[1, 2],
+                     compression=compression) as f:
+        for frame in range(3):
+            f.write_chunk(name='position',
+                          data=numpy.full((100, 3), frame, dtype=numpy.float32))
+            f.write_chunk(name='typeid',
+                          data=numpy.arange(100, dtype=numpy.uint32) + frame)
+            f.write_chunk(name='empty', data=numpy.array([], dtype=numpy.int32))
+            f.end_frame()
+
+    def check(f):
+        position = numpy.empty((100, 3), dtype=numpy.float32)
+        typeid = numpy.empty(100, dtype=numpy.uint32)
+        for frame in range(3):
+            result = f.read_chunk(frame=frame, name='position', out=position)
+            assert result is position
+            numpy.testing.assert_array_equal(position, frame)
+
+            result = f.read_chunk(frame=frame, name='typeid', out=typeid)
+            assert result is typeid
+            numpy.testing.assert_array_equal(typeid, numpy.arange(100) + frame)
+
+        empty = numpy.empty(0, dtype=numpy.int32)
+        assert f.read_chunk(frame=0, name='empty', out=empty) is empty
+
+        for bad in [
+                numpy.empty((100, 3), dtype=numpy.float64),
+                numpy.empty((100, 2), dtype=numpy.float32),
+                numpy.empty(300, dtype=numpy.float32),
+                numpy.empty((3, 100), dtype=numpy.float32).T,
+                numpy.empty((100, 3), dtype=numpy.float32).tolist(),
+        ]:
+            with pytest.raises(ValueError):
+                f.read_chunk(frame=0, name='position', out=bad)
+
+        readonly = numpy.empty(100, dtype=numpy.uint32)
+        readonly.flags.writeable = False
+        with pytest.raises(ValueError):
+            f.read_chunk(frame=0, name='typeid', out=readonly)
+
+    with gsd.fl.open(name=name, mode='rb') as f:
+        check(f)
+
+    with gsd.fl.open(name=name, mode='rb', mmap=True) as f:
+        check(f)
+
+    with gsd.pygsd.GSDFile(file=open(str(name), mode='rb')) as f:
+        check(f)
+
+    with gsd.pygsd.GSDFile(file=open(str(name), mode='rb'), mmap=True) as f:
+        check(f)
+
+
+@pytest.mark.parametrize('compression', [None, 'lz4'])
+def test_read_series(tmp_path, compression):
+    """Test reading one chunk from a series of frames."""
+    name = tmp_path / 'test_read_series.gsd'
+    with gsd.fl.open(name=name,
+                     mode='wb',
+                     application='test_read_series',
+                     schema='none',
+                     schema_version=[1, 2],
+                     compression=compression) as f:
+        for frame in range(10):
+            f.write_chunk(name='position',
+                          data=numpy.full((100, 3), frame, dtype=numpy.float32))
+            f.write_chunk(name='value',
+                          data=numpy.array([frame], dtype=numpy.float64))
+            if frame < 5:
+                f.write_chunk(name='partial',
+                              data=numpy.array([frame], dtype=numpy.int32))
+            else:
+                f.write_chunk(name='partial',
+                              data=numpy.array([frame, frame],
+                                               dtype=numpy.int32))
+            f.end_frame()
+
+    def check(f):
+        series = f.read_series(name='position')
+        assert series.dtype == numpy.float32
+        assert series.shape == (10, 100, 3)
+        for frame in range(10):
+            numpy.testing.assert_array_equal(series[frame], frame)
+
+        series = f.read_series(name='value', start=1, stop=-1, step=3)
+        assert series.shape == (3, 1)
+        numpy.testing.assert_array_equal(series, [[1], [4], [7]])
+
+        out = numpy.empty((5, 1), dtype=numpy.int32)
+        assert f.read_series(name='partial', stop=5, out=out) is out
+        numpy.testing.assert_array_equal(out, [[0], [1], [2], [3], [4]])
+        numpy.testing.assert_array_equal(
+            f.read_series(name='partial', start=8), [[8, 8], [9, 9]])
+
+        # the chunk changes shape in frame 5
+        with pytest.raises(ValueError):
+            f.read_series(name='partial')
+        with pytest.raises(ValueError):
+            f.read_series(name='value',
+                          out=numpy.empty((10, 1), dtype=numpy.float32))
+        with pytest.raises(ValueError):
+            f.read_series(name='value', start=10)
+        with pytest.raises(ValueError):
+            f.read_series(name='value', step=0)
+        with pytest.raises(KeyError):
+            f.read_series(name='missing')
+
+    with gsd.fl.open(name=name, mode='rb') as f:
+        check(f)
+
+    with gsd.pygsd.GSDFile(file=open(str(name), mode='rb')) as f:
+        check(f)
+
+
+def test_pygsd_mmap(tmp_path):
+    """Test read-only views of memory mapped files and buffers in pygsd."""
+    name = tmp_path / 'test_pygsd_mmap.gsd'
+    data = numpy.arange(1024, dtype=numpy.float64).reshape([512, 2])
+    compressed = numpy.zeros(4096, dtype=numpy.int32)
+    with gsd.fl.open(name=name,
+                     mode='wb',
+                     application='test_pygsd_mmap',
+                     schema='none',
+                     schema_version=[1, 2]) as f:
+        f.write_chunk(name='data', data=data)
+        f.write_chunk(name='empty', data=numpy.array([], dtype=numpy.int32))
+        f.end_frame()
+
+    with gsd.fl.open(name=name, mode='ab', compression='lz4') as f:
+        f.write_chunk(name='compressed', data=compressed)
+        f.end_frame()
+
+    def check(f):
+        assert f.mmap
+        assert f.nframes == 2
+
+        data_read = f.read_chunk(frame=0, name='data')
+        assert not data_read.flags.writeable
+        numpy.testing.assert_array_equal(data_read, data)
+
+        empty = f.read_chunk(frame=0, name='empty')
+        assert empty.shape == (0,)
+        assert empty.dtype == numpy.int32
+
+        numpy.testing.assert_array_equal(
+            f.read_chunk(frame=1, name='compressed'), compressed)
+
+        # views remain valid after the file is closed
+        f.close()
+        with pytest.raises(ValueError):
+            f.read_chunk(frame=0, name='data')
+        del f
+        numpy.testing.assert_array_equal(data_read, data)
+
+    check(gsd.pygsd.GSDFile(open(str(name), 'rb'), mmap=True))
+    check(gsd.pygsd.GSDFile(name.read_bytes()))
+    check(gsd.pygsd.GSDFile(bytearray(name.read_bytes())))
+    check(gsd.pygsd.GSDFile(memoryview(bytearray(name.read_bytes()))))
+    with open(str(name), 'rb') as file:
+        m = mmap.mmap(file.fileno(), 0, access=mmap.ACCESS_READ)
+        check(gsd.pygsd.GSDFile(m))
+
+    with gsd.pygsd.GSDFile(open(str(name), 'rb')) as f:
+        assert not f.mmap
+
+    with gsd.pygsd.GSDFile(open(str(name), 'rb'), mmap=True) as f:
+        f2 = pickle.loads(pickle.dumps(f))
+        assert f2.mmap
+        numpy.testing.assert_array_equal(f2.read_chunk(frame=0, name='data'),
+                                         data)
+        f2.close()
+
+
+@pytest.mark.parametrize('shuffle', [None, 'byte', 'bit'])
+def test_compression(tmp_path, open_mode, shuffle):
+    """Test that compressed chunks read back the written data."""
+    rng = numpy.random.RandomState(0)
+    chunks = {
+        'position':
+            (rng.random_sample(size=(4096, 3)) * 10).astype(numpy.float32),
+        'typeid': numpy.repeat(numpy.arange(8, dtype=numpy.uint32), 512),
+        'image': numpy.zeros(shape=(4096, 3), dtype=numpy.int32),
+        'random': rng.randint(0, 256, size=1000).astype(numpy.uint8),
+        'small': numpy.array([1.0, 2.0], dtype=numpy.float64),
+        'odd': numpy.arange(1027, dtype=numpy.uint16) % 5,
+        'empty': numpy.array([], dtype=numpy.float32),
+    }
+
+    with gsd.fl.open(name=tmp_path / 'test_compression.gsd',
+                     mode=open_mode.write,
+                     application='test_compression',
+                     schema='none',
+                     schema_version=[1, 2],
+                     compression='lz4',
+                     shuffle=shuffle) as f:
+        assert f.compression == 'lz4'
+        for frame in range(2):
+            for name, data in chunks.items():
+                f.write_chunk(name=name, data=data)
+            f.end_frame()
+
+    raw_size = sum(data.nbytes for data in chunks.values()) * 2
+    assert os.path.getsize(tmp_path / 'test_compression.gsd') < raw_size
+
+    with gsd.fl.open(name=tmp_path / 'test_compression.gsd',
+                     mode=open_mode.read) as f:
+        for frame in range(2):
+            for name, data in chunks.items():
+                data_read = f.read_chunk(frame=frame, name=name)
+                assert data_read.dtype == data.dtype
+                assert data_read.shape == data.shape
+                numpy.testing.assert_array_equal(data_read, data)
+
+        data_read = f.read_chunks(frame=1, names=list(chunks.keys()))
+        for name, data in chunks.items():
+            numpy.testing.assert_array_equal(data_read[name], data)
+
+    # test again with pygsd
+    with gsd.pygsd.GSDFile(
+            file=open(str(tmp_path / 'test_compression.gsd'), mode='rb')) as f:
+        for name, data in chunks.items():
+            numpy.testing.assert_array_equal(f.read_chunk(frame=1, name=name),
+                                             data)
+
+
+def test_compression_errors(tmp_path):
+    """Test that invalid compression options raise errors."""
+    with pytest.raises(ValueError):
+        gsd.fl.open(name=tmp_path / 'test_compression_errors.gsd',
+                    mode='wb',
+                    application='test_compression_errors',
+                    schema='none',
+                    schema_version=[1, 2],
+                    compression='zip')
+
+    with pytest.raises(ValueError):
+        gsd.fl.open(name=tmp_path / 'test_compression_errors.gsd',
+                    mode='wb',
+                    application='test_compression_errors',
+                    schema='none',
+                    schema_version=[1, 2],
+                    compression='lz4',
+                    shuffle='word')
+
+
+@pytest.mark.parametrize('compression', [None, 'lz4'])
+def test_quantized_chunk(tmp_path, open_mode, compression):
+    """Test that quantized chunks read back within the precision."""
+    rng = numpy.random.RandomState(0)
+    position = ((rng.random_sample(size=(4096, 3)) - 0.5)
+                * 20).astype(numpy.float32)
+    position[:, 2] = 0
+    precision = 1e-3
+
+    with gsd.fl.open(name=tmp_path / 'test_quantized_chunk.gsd',
+                     mode=open_mode.write,
+                     application='test_quantized_chunk',
+                     schema='none',
+                     schema_version=[1, 2],
+                     compression=compression) as f:
+        f.write_quantized_chunk(name='position',
+                                data=position,
+                                precision=precision,
+                                extent=[20, 20, 0])
+        f.write_quantized_chunk(name='outside',
+                                data=position * 2,
+                                precision=precision,
+                                extent=[20, 20, 0])
+        f.write_quantized_chunk(name='1d', data=position[:, 0], precision=0.1)
+        f.write_quantized_chunk(name='small', data=[1.5], precision=0.1)
+        f.write_quantized_chunk(name='empty',
+                                data=numpy.array([], dtype=numpy.float32),
+                                precision=0.1)
+        f.end_frame()
+
+    # 15 bits per value in x and y and none in z
+    raw_size = position.nbytes * 2 + position[:, 0].nbytes
+    assert (os.path.getsize(tmp_path / 'test_quantized_chunk.gsd')
+            < raw_size * 0.6)
+
+    expected = {
+        'position': (position, precision),
+        'outside': (position * 2, precision),
+        '1d': (position[:, 0], 0.1),
+        'small': (numpy.array([1.5], dtype=numpy.float32), 0.1),
+        'empty': (numpy.array([], dtype=numpy.float32), 0.1),
+    }
+
+    with gsd.fl.open(name=tmp_path / 'test_quantized_chunk.gsd',
+                     mode=open_mode.read) as f:
+        for name, (data, tolerance) in expected.items():
+            data_read = f.read_chunk(frame=0, name=name)
+            assert data_read.dtype == numpy.float32
+            assert data_read.shape == data.shape
+            numpy.testing.assert_allclose(data_read,
+                                          data,
+                                          rtol=0,
+                                          atol=tolerance / 2 * 1.01)
+
+        numpy.testing.assert_array_equal(
+            f.read_chunk(frame=0, name='position')[:, 2], 0)
+
+    # test again with pygsd
+    with gsd.pygsd.GSDFile(file=open(
+            str(tmp_path / 'test_quantized_chunk.gsd'), mode='rb')) as f:
+        with gsd.fl.open(name=tmp_path / 'test_quantized_chunk.gsd',
+                         mode='rb') as f_c:
+            for name in expected:
+                numpy.testing.assert_array_equal(
+                    f.read_chunk(frame=0, name=name),
+                    f_c.read_chunk(frame=0, name=name))
+
+
+def test_quantized_chunk_errors(tmp_path):
+    """Test that invalid quantization arguments raise errors."""
+    with gsd.fl.open(name=tmp_path / 'test_quantized_chunk_errors.gsd',
+                     mode='wb',
+                     application='test_quantized_chunk_errors',
+                     schema='none',
+                     schema_version=[1, 2]) as f:
+        with pytest.raises(RuntimeError):
+            f.write_quantized_chunk(name='a', data=[1.0, 2.0], precision=0)
+
+        with pytest.raises(RuntimeError):
+            f.write_quantized_chunk(name='a',
+                                    data=[1.0, numpy.nan],
+                                    precision=0.1)
+
+        with pytest.raises(RuntimeError):
+            f.write_quantized_chunk(name='a', data=[0, 1e30], precision=0.1)
+
+        with pytest.raises(ValueError):
+            f.write_quantized_chunk(name='a',
+                                    data=[[1.0, 2.0]],
+                                    precision=0.1,
+                                    extent=[1.0])
+
+
+def test_async_write(tmp_path, open_mode):
+    """Test that frames written in the background read back."""
+    rng = numpy.random.RandomState(0)
+    frames = []
+    for frame in range(20):
+        frames.append({
+            'position': rng.random_sample(size=(1000, 3)).astype(numpy.float32),
+            'step': numpy.array([frame], dtype=numpy.uint64),
+            'frame' + str(frame): numpy.array([frame], dtype=numpy.int32),
+        })
+    frames[10]['large'] = numpy.arange(3 * 1024**2, dtype=numpy.uint32)
+
+    with gsd.fl.open(name=tmp_path / 'test_async_write.gsd',
+                     mode=open_mode.write,
+                     application='test_async_write',
+                     schema='none',
+                     schema_version=[1, 2],
+                     async_write=True) as f:
+        assert f.async_write
+        for frame, chunks in enumerate(frames):
+            for name, data in chunks.items():
+                f.write_chunk(name=name, data=data)
+            f.end_frame()
+
+            if frame == 10:
+                f.flush()
+                with gsd.fl.open(name=tmp_path / 'test_async_write.gsd',
+                                 mode='rb') as f_read:
+                    assert f_read.nframes == 11
+                    numpy.testing.assert_array_equal(
+                        f_read.read_chunk(frame=10, name='large'),
+                        frames[10]['large'])
+
+            if open_mode.write == 'wb+':
+                numpy.testing.assert_array_equal(
+                    f.read_chunk(frame=frame, name='position'),
+                    chunks['position'])
+                assert 'frame' + str(frame) in f.find_matching_chunk_names('')
+
+        assert f.nframes == 20
+
+    with gsd.fl.open(name=tmp_path / 'test_async_write.gsd',
+                     mode=open_mode.read) as f:
+        assert f.nframes == 20
+        for frame, chunks in enumerate(frames):
+            for name, data in chunks.items():
+                numpy.testing.assert_array_equal(
+                    f.read_chunk(frame=frame, name=name), data)
+
+
+def test_async_write_new_names(tmp_path):
+    """Test adding names in every frame while the writer grows the index."""
+    name = tmp_path / 'test_async_write_new_names.gsd'
+
+    with gsd.fl.open(name=name,
+                     mode='wb',
+                     application='test_async_write_new_names',
+                     schema='none',
+                     schema_version=[1, 2],
+                     async_write=True) as f:
+        for frame in range(2000):
+            for i in range(3):
+                f.write_chunk(name=f'frame{frame}/{i}',
+                              data=numpy.array([frame, i], dtype=numpy.int32))
+            f.end_frame()
+
+    with gsd.fl.open(name=name, mode='rb') as f:
+        assert f.nframes == 2000
+        for frame in range(2000):
+            for i in range(3):
+                numpy.testing.assert_array_equal(
+                    f.read_chunk(frame=frame, name=f'frame{frame}/{i}'),
+                    [frame, i])
+
+
+def test_async_write_errors(tmp_path):
+    """Test that async_write requires a writable file."""
+    with gsd.fl.open(name=tmp_path / 'test_async_write_errors.gsd',
+                     mode='wb',
+                     application='test_async_write_errors',
+                     schema='none',
+                     schema_version=[1, 2]) as f:
+        assert not f.async_write
+        f.end_frame()
+        f.flush()
+
+    with pytest.raises(ValueError):
+        gsd.fl.open(name=tmp_path / 'test_async_write_errors.gsd',
+                    mode='rb',
+                    async_write=True)
+
+
+@pytest.mark.parametrize('durability', ['always', 3, 'close', 'never'])
+@pytest.mark.parametrize('async_write', [False, True])
+def test_durability(tmp_path, durability, async_write):
+    """Test that files written with every durability policy read back."""
+    with gsd.fl.open(name=tmp_path / 'test_durability.gsd',
+                     mode='wb',
+                     application='test_durability',
+                     schema='none',
+                     schema_version=[1, 2],
+                     async_write=async_write,
+                     durability=durability) as f:
+        assert f.durability == durability
+        for frame in range(10):
+            f.write_chunk(name='step',
+                          data=numpy.array([frame], dtype=numpy.uint64))
+            f.write_chunk(name='frame' + str(frame),
+                          data=numpy.array([frame], dtype=numpy.int32))
+            f.end_frame()
+        f.flush()
+
+    with gsd.fl.open(name=tmp_path / 'test_durability.gsd', mode='rb') as f:
+        assert f.nframes == 10
+        for frame in range(10):
+            assert f.read_chunk(frame=frame, name='step')[0] == frame
+            assert f.read_chunk(frame=frame,
+                                name='frame' + str(frame))[0] == frame
+
+
+def test_durability_errors(tmp_path):
+    """Test that invalid durability policies are rejected."""
+    for durability in ['sometimes', 0, -1, 1.5, True]:
+        with pytest.raises(ValueError):
+            gsd.fl.open(name=tmp_path / 'test_durability_errors.gsd',
+                        mode='wb',
+                        application='test_durability_errors',
+                        schema='none',
+                        schema_version=[1, 2],
+                        durability=durability)
+
+    with gsd.fl.open(name=tmp_path / 'test_durability_errors.gsd',
+                     mode='wb',
+                     application='test_durability_errors',
+                     schema='none',
+                     schema_version=[1, 2]) as f:
+        assert f.durability == 'always'
+
+    with pytest.raises(ValueError):
+        gsd.fl.open(name=tmp_path / 'test_durability_errors.gsd',
+                    mode='rb',
+                    durability='never')
+
+
+@pytest.mark.parametrize('async_write', [False, True])
+def test_lend(tmp_path, async_write):
+    """Test that chunks lent to the writer read back."""
+    rng = numpy.random.RandomState(0)
+    buffers = [rng.random_sample(size=(100000, 3)).astype(numpy.float32)
+               for i in range(2)]
+    expected = []
+
+    with gsd.fl.open(name=tmp_path / 'test_lend.gsd',
+                     mode='wb',
+                     application='test_lend',
+                     schema='none',
+                     schema_version=[1, 2],
+                     async_write=async_write) as f:
+        for frame in range(10):
+            # the buffer lent two frames ago is written
+            position = buffers[frame % 2]
+            position[:] = frame
+            expected.append(position.copy())
+
+            f.write_chunk(name='position', data=position, lend=True)
+            f.write_chunk(name='step',
+                          data=numpy.array([frame], dtype=numpy.uint64))
+            f.write_chunk(name='empty',
+                          data=numpy.zeros((0, 3), dtype=numpy.float32),
+                          lend=True)
+            f.end_frame()
+
+        # lent chunks of an unfinished frame are discarded with it
+        f.write_chunk(name='position', data=buffers[0], lend=True)
+
+    with gsd.fl.open(name=tmp_path / 'test_lend.gsd', mode='rb') as f:
+        assert f.nframes == 10
+        for frame in range(10):
+            numpy.testing.assert_array_equal(
+                f.read_chunk(frame=frame, name='position'), expected[frame])
+            assert f.read_chunk(frame=frame, name='step')[0] == frame
+            assert f.read_chunk(frame=frame, name='empty').shape == (0, 3)
+
+
+@pytest.mark.parametrize('async_write', [False, True])
+def test_lend_many(tmp_path, async_write):
+    """Test frames with many lent chunks between buffered chunks."""
+    rng = numpy.random.RandomState(1)
+    expected = []
+
+    with gsd.fl.open(name=tmp_path / 'test_lend_many.gsd',
+                     mode='wb',
+                     application='test_lend_many',
+                     schema='none',
+                     schema_version=[1, 2],
+                     async_write=async_write) as f:
+        for frame in range(5):
+            chunks = {}
+            for i in range(40):
+                chunks[f'lent/{i}'] = rng.random_sample(size=(1000 + i, 3))
+                chunks[f'small/{i}'] = numpy.array([frame, i])
+            expected.append(chunks)
+
+            for name, data in chunks.items():
+                f.write_chunk(name=name,
+                              data=data,
+                              lend=name.startswith('lent/'))
+            f.end_frame()
+
+    with gsd.fl.open(name=tmp_path / 'test_lend_many.gsd', mode='rb') as f:
+        assert f.nframes == 5
+        for frame, chunks in enumerate(expected):
+            for name, data in chunks.items():
+                numpy.testing.assert_array_equal(
+                    f.read_chunk(frame=frame, name=name), data)
+
+
+@pytest.mark.parametrize('durability', ['always', 'never'])
+@pytest.mark.parametrize('async_write', [False, True])
+def test_commit_moves_namelist_and_index(tmp_path, durability, async_write):
+    """Test a frame that moves the namelist and the index and adds names."""
+    name = tmp_path / 'test_commit_moves_namelist_and_index.gsd'
+
+    def write_frame(f, names, frame):
+        for chunk in names:
+            f.write_chunk(name=chunk,
+                          data=numpy.array([frame], dtype=numpy.int32))
+        f.end_frame()
+
+    # frame 1 adds more names and entries than the namelist and index hold
+    frames = [['a', 'b'], [f'name/{i}' for i in range(300)], ['c', 'd']]
+    with gsd.fl.open(name=name,
+                     mode='wb',
+                     application='test_commit_moves_namelist_and_index',
+                     schema='none',
+                     schema_version=[1, 2],
+                     async_write=async_write,
+                     durability=durability) as f:
+        for frame, names in enumerate(frames):
+            write_frame(f, names, frame)
+
+    with gsd.fl.open(name=name, mode='rb') as f:
+        assert f.nframes == len(frames)
+        for frame, names in enumerate(frames):
+            for chunk in names:
+                assert f.read_chunk(frame=frame, name=chunk)[0] == frame
+        assert (f.find_matching_chunk_names('')
+                == [chunk for names in frames for chunk in names])
+
+    with gsd.pygsd.GSDFile(file=open(str(name), mode='rb')) as f:
+        assert f.nframes == len(frames)
+        assert f.read_chunk(frame=1, name='name/299')[0] == 1
+        assert f.read_chunk(frame=2, name='d')[0] == 2
+
+
+@pytest.mark.skipif(platform.system() == 'Windows',
+                    reason='requires RLIMIT_FSIZE')
+def test_short_write(tmp_path):
+    """Test that a frame cut short by the file size limit raises an error."""
+    name = tmp_path / 'test_short_write.gsd'
+
+    # the write of frame 1 stops at the file size limit and the retry fails
+    script = f"""
+import resource, signal
+import numpy
+import gsd.fl
+signal.signal(signal.SIGXFSZ, signal.SIG_IGN)
+with gsd.fl.open(name={str(name)!r}, mode='wb', application='a',
+                 schema='none', schema_version=[1, 2]) as f:
+    f.write_chunk(name='data', data=numpy.zeros(10))
+    f.end_frame()
+    resource.setrlimit(resource.RLIMIT_FSIZE, (1024 * 1024, 1024 * 1024))
+    try:
+        f.write_chunk(name='data', data=numpy.zeros(1024 * 1024))
+        f.end_frame()
+    except OSError:
+        print('OSError')
+"""
+    result = subprocess.run([sys.executable, '-c', script],
+                            capture_output=True,
+                            text=True,
+                            check=True,
+                            env=dict(os.environ,
+                                     PYTHONPATH=os.pathsep.join(sys.path)))
+    assert result.stdout.strip() == 'OSError'
+
+    # the frames written before the error remain readable
+    with gsd.fl.open(name=name, mode='rb') as f:
+        assert f.nframes == 1
+        numpy.testing.assert_array_equal(f.read_chunk(frame=0, name='data'),
+                                         numpy.zeros(10))
+
+
+@pytest.mark.parametrize('async_write', [False, True])
+def test_reserve(tmp_path, async_write):
+    """Test that the index does not move after reserving space."""
+    name = tmp_path / 'test_reserve.gsd'
+
+    def read_header():
+        with open(name, 'rb') as f:
+            return gsd.pygsd.gsd_header._make(
+                gsd.pygsd.gsd_header_struct.unpack(
+                    f.read(gsd.pygsd.gsd_header_struct.size)))
+
+    with gsd.fl.open(name=name,
+                     mode='wb',
+                     application='test_reserve',
+                     schema='none',
+                     schema_version=[1, 2],
+                     async_write=async_write) as f:
+        f.write_chunk(name='step', data=numpy.array([0], dtype=numpy.uint64))
+        f.end_frame()
+        f.reserve(nframes=1000, chunks_per_frame=3, nbytes=1000 * 20)
+        header = read_header()
+        assert header.index_allocated_entries >= 3001
+
+        for frame in range(1, 1001):
+            f.write_chunk(name='step',
+                          data=numpy.array([frame], dtype=numpy.uint64))
+            f.write_chunk(name='a', data=numpy.array([frame],
+                                                     dtype=numpy.int32))
+            f.write_chunk(name='b', data=numpy.array([frame],
+                                                     dtype=numpy.int64))
+            f.end_frame()
+
+        with pytest.raises(ValueError):
+            f.reserve(nframes=-1, chunks_per_frame=1)
+
+    assert read_header().index_location == header.index_location
+    assert (read_header().index_allocated_entries
+            == header.index_allocated_entries)
+
+    with gsd.fl.open(name=name, mode='rb') as f:
+        assert f.nframes == 1001
+        for frame in range(1001):
+            assert f.read_chunk(frame=frame, name='step')[0] == frame
+        assert f.read_chunk(frame=1000, name='b')[0] == 1000
+
+
+@pytest.mark.parametrize('async_write', [False, True])
+def test_find_chunk_frames(tmp_path, async_write):
+    """Test chunk lookups in frames with varying numbers of chunks."""
+    name = tmp_path / 'test_find_chunk_frames.gsd'
+    names = ['a', 'b', 'c', 'd']
+
+    with gsd.fl.open(name=name,
+                     mode='wb+',
+                     application='test_find_chunk_frames',
+                     schema='none',
+                     schema_version=[1, 2],
+                     async_write=async_write) as f:
+        for frame in range(200):
+            for chunk in names[:frame % 5]:
+                f.write_chunk(name=chunk,
+                              data=numpy.array([frame], dtype=numpy.int32))
+            f.end_frame()
+
+            # look up chunks while the file grows
+            if frame % 7 == 0:
+                assert f.chunk_exists(frame=frame // 2, name='a') == (
+                    (frame // 2) % 5 >= 1)
+
+        rng = numpy.random.RandomState(1)
+        for frame in rng.randint(0, 200, size=1000):
+            frame = int(frame)
+            for i, chunk in enumerate(names):
+                if i < frame % 5:
+                    assert f.read_chunk(frame=frame, name=chunk)[0] == frame
+                else:
+                    assert not f.chunk_exists(frame=frame, name=chunk)
+
+    # test again with pygsd
+    with gsd.pygsd.GSDFile(file=open(str(name), mode='rb')) as f:
+        assert f.nframes == 200
+        for frame in range(-1, 201):
+            for i, chunk in enumerate(names):
+                if 0 <= frame < 200 and i < frame % 5:
+                    assert f.read_chunk(frame=frame, name=chunk)[0] == frame
+                else:
+                    assert not f.chunk_exists(frame=frame, name=chunk)
+        assert f.find_chunk_at_or_before(frame=199, name='d') == 199
+        assert f.find_chunk_at_or_before(frame=198, name='d') == 194
+
+
+def test_search_tree(tmp_path):
+    """Test chunk lookups with a search tree of the file index."""
+    name = tmp_path / 'test_search_tree.gsd'
+    names = ['a', 'b', 'c', 'd', 'e', 'f', 'g']
+
+    with gsd.fl.open(name=name,
+                     mode='wb',
+                     application='test_search_tree',
+                     schema='none',
+                     schema_version=[1, 2]):
+        pass
+
+    with gsd.fl.open(name=name, mode='rb', search_tree=True) as f:
+        assert f.search_tree
+        assert f.nframes == 0
+
+    with gsd.fl.open(name=name,
+                     mode='wb',
+                     application='test_search_tree',
+                     schema='none',
+                     schema_version=[1, 2]) as f:
+        for frame in range(2000):
+            for chunk in names[:frame % 8]:
+                f.write_chunk(name=chunk,
+                              data=numpy.array([frame], dtype=numpy.int32))
+            f.end_frame()
+
+    with gsd.fl.open(name=name, mode='rb', search_tree=True) as f:
+        assert f.search_tree
+        rng = numpy.random.RandomState(2)
+        frames = list(rng.randint(0, 2000, size=1000)) + [0, 1, 1998, 1999]
+        for frame in frames:
+            frame = int(frame)
+            for i, chunk in enumerate(names):
+                if i < frame % 8:
+                    assert f.read_chunk(frame=frame, name=chunk)[0] == frame
+                else:
+                    assert not f.chunk_exists(frame=frame, name=chunk)
+
+        f2 = pickle.loads(pickle.dumps(f))
+        assert f2.search_tree
+        assert f2.read_chunk(frame=1999, name='g')[0] == 1999
+        f2.close()
+
+    with pytest.raises(ValueError):
+        gsd.fl.open(name=name, mode='rb+', search_tree=True)
+
+
+def test_search_tree_close(tmp_path):
+    """Test that closing a file frees its search tree."""
+    name = tmp_path / 'test_search_tree_close.gsd'
+    chunks = {
+        str(i): numpy.array([i], dtype=numpy.int32) for i in range(20)
+    }
+
+    with gsd.fl.open(name=name,
+                     mode='wb',
+                     application='test_search_tree_close',
+                     schema='none',
+                     schema_version=[1, 2]) as f:
+        for frame in range(10000):
+            f.write_chunks(chunks)
+
+    def resident_size():
+        with open('/proc/self/statm') as statm:
+            return int(statm.read().split()[1]) * os.sysconf('SC_PAGE_SIZE')
+
+    def open_close(n):
+        for i in range(n):
+            with gsd.fl.open(name=name, mode='rb', search_tree=True) as f:
+                assert f.search_tree
+                assert f.read_chunk(frame=9999, name='19')[0] == 19
+
+    open_close(50)
+    if not os.path.exists('/proc/self/statm'):
+        open_close(500)
+        return
+
+    # each tree of this file is about 25 kB
+    before = resident_size()
+    open_close(500)
+    assert resident_size() - before < 4 * 1024 * 1024
+
+
+def test_find_chunk_at_or_before(tmp_path, open_mode):
+    """Test finding the latest frame that contains a chunk."""
+    name = tmp_path / 'test_find_chunk_at_or_before.gsd'
+    with gsd.fl.open(name=name,
+                     mode='wb+',
+                     application='test_find_chunk_at_or_before',
+                     schema='none',
+                     schema_version=[1, 2]) as f:
+        for frame in range(10):
+            f.write_chunk(name='every', data=numpy.array([frame]))
+            if frame % 3 == 0:
+                f.write_chunk(name='third', data=numpy.array([frame]))
+            f.end_frame()
+
+            # the chunk lists are extended as frames are added
+            assert f.find_chunk_at_or_before(frame=frame,
+                                             name='third') == frame // 3 * 3
+
+        assert f.find_chunk_at_or_before(frame=100, name='every') == 9
+
+    with gsd.fl.open(name=name, mode=open_mode.read) as f:
+        for frame in range(10):
+            assert f.find_chunk_at_or_before(frame=frame,
+                                             name='every') == frame
+            assert f.find_chunk_at_or_before(frame=frame,
+                                             name='third') == frame // 3 * 3
+        assert f.find_chunk_at_or_before(frame=0, name='missing') is None
+        with pytest.raises(ValueError):
+            f.find_chunk_at_or_before(frame=-1, name='every')
+
+    with gsd.pygsd.GSDFile(open(name, mode='rb')) as f:
+        assert f.find_chunk_at_or_before(frame=5, name='third') == 3
+        assert f.find_chunk_at_or_before(frame=100, name='every') == 9
+        assert f.find_chunk_at_or_before(frame=0, name='missing') is None
+
+
+def test_many_names(tmp_path, open_mode):
+    """Test files with more names than the initial name map holds."""
+    name = tmp_path / 'test_many_names.gsd'
+    names = ['chunk/' + str(i) + '/' + 'x' * (i % 13) for i in range(3000)]
+
+    with gsd.fl.open(name=name,
+                     mode=open_mode.write,
+                     application='test_many_names',
+                     schema='none',
+                     schema_version=[1, 2]) as f:
+        for frame in range(3):
+            for i, chunk in enumerate(names[frame * 1000:(frame + 1)
+                                            * 1000]):
+                f.write_chunk(name=chunk, data=numpy.array([i]))
+            f.end_frame()
+
+    with gsd.fl.open(name=name, mode=open_mode.read) as f:
+        for i, chunk in enumerate(names):
+            assert f.read_chunk(frame=i // 1000, name=chunk)[0] == i % 1000
+            assert not f.chunk_exists(frame=(i // 1000 + 1) % 3, name=chunk)
+        assert not f.chunk_exists(frame=0, name='chunk/')
+
+
+def test_name_ids(tmp_path, open_mode):
+    """Test that cached chunk name ids remain correct."""
+    name = tmp_path / 'test_name_ids.gsd'
+    with gsd.fl.open(name=name,
+                     mode='wb+',
+                     application='test_name_ids',
+                     schema='none',
+                     schema_version=[1, 2]) as f:
+        assert not f.chunk_exists(frame=0, name='a')
+        for frame in range(3):
+            f.write_chunk(name='a', data=numpy.array([frame]))
+            f.write_chunk(name='b', data=numpy.array([frame * 10]))
+            f.end_frame()
+        assert f.read_chunk(frame=2, name='b')[0] == 20
+
+        # truncating removes the names, so they get new ids
+        f.truncate()
+        assert not f.chunk_exists(frame=0, name='a')
+        f.write_chunk(name='c', data=numpy.array([1]))
+        f.write_chunk(name='b', data=numpy.array([2]))
+        f.end_frame()
+        assert not f.chunk_exists(frame=0, name='a')
+        assert f.read_chunk(frame=0, name='b')[0] == 2
+        assert f.read_chunk(frame=0, name='c')[0] == 1
+
+    with gsd.fl.open(name=name, mode=open_mode.read) as f:
+        assert f.find_matching_chunk_names('') == ['c', 'b']
+        assert f.read_chunk(frame=0, name='b')[0] == 2
+        assert f.read_chunk(frame=0, name='b')[0] == 2
+        assert not f.chunk_exists(frame=0, name='a')
+
+    with gsd.fl.open(name=name, mode='rb') as f:
+        with pytest.raises(RuntimeError):
+            f.write_chunk(name='d', data=numpy.array([1]))
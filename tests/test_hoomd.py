@@ -6,6 +6,7 @@
 
 import gsd.fl
 import gsd.hoomd
+import gsd.pygsd
 import numpy
 import pickle
 import pytest
@@ -755,3 +756,366 @@ def test_pickle(tmp_path, open_mode):
         pkl = pickle.dumps(traj)
         with pickle.loads(pkl) as hf:
             assert len(hf) == 20
+
+
+def test_compression(tmp_path, open_mode):
+    """Test that compressed trajectories read back the written frames."""
+    snap = gsd.hoomd.Snapshot()
+    snap.particles.N = 1000
+    snap.particles.position = numpy.linspace(
+        0, 10, 3000, dtype=numpy.float32).reshape([1000, 3])
+    snap.particles.typeid = numpy.zeros(1000, dtype=numpy.uint32)
+
+    with gsd.hoomd.open(name=tmp_path / "test_compression.gsd",
+                        mode=open_mode.write,
+                        compression='lz4') as hf:
+        for step in range(2):
+            snap.configuration.step = step
+            hf.append(snap)
+
+    with gsd.hoomd.open(name=tmp_path / "test_compression.gsd",
+                        mode=open_mode.read) as hf:
+        assert len(hf) == 2
+        numpy.testing.assert_array_equal(hf[1].particles.position,
+                                         snap.particles.position)
+        numpy.testing.assert_array_equal(hf[1].particles.typeid,
+                                         snap.particles.typeid)
+
+
+def test_position_precision(tmp_path, open_mode):
+    """Test that quantized positions read back within the precision."""
+    rng = numpy.random.RandomState(0)
+    snap = gsd.hoomd.Snapshot()
+    snap.configuration.box = [20, 20, 20, 0, 0, 0]
+    snap.particles.N = 1000
+    snap.particles.position = ((rng.random_sample(size=(1000, 3)) - 0.5)
+                               * 20).astype(numpy.float32)
+
+    with gsd.hoomd.open(name=tmp_path / "test_position_precision.gsd",
+                        mode=open_mode.write,
+                        position_precision=1e-3) as hf:
+        for step in range(2):
+            snap.configuration.step = step
+            snap.particles.position = snap.particles.position + 0.25
+            hf.append(snap)
+
+    with gsd.hoomd.open(name=tmp_path / "test_position_precision.gsd",
+                        mode=open_mode.read) as hf:
+        assert len(hf) == 2
+        position = hf[1].particles.position
+        assert position.dtype == numpy.float32
+        numpy.testing.assert_allclose(position,
+                                      snap.particles.position,
+                                      rtol=0,
+                                      atol=0.5e-3 * 1.01)
+
+    with pytest.raises(ValueError):
+        gsd.hoomd.open(name=tmp_path / "test_position_precision.gsd",
+                       mode='wb',
+                       position_precision=0)
+
+
+def test_changed_only(tmp_path, open_mode):
+    """Test that changed_only files write and read only changed chunks."""
+    name = tmp_path / "test_changed_only.gsd"
+    snapshots = []
+    snap = gsd.hoomd.Snapshot()
+    snap.particles.N = 4
+    snap.particles.types = ['A', 'B']
+    snap.particles.typeid = [0, 0, 1, 1]
+    snap.particles.mass = [2, 2, 2, 2]
+    snap.configuration.box = [10, 10, 10, 0, 0, 0]
+    for step in range(10):
+        snap.configuration.step = step
+        snap.particles.position = numpy.full((snap.particles.N, 3),
+                                             step,
+                                             dtype=numpy.float32)
+        if step == 2:
+            snap.particles.mass = [1, 1, 1, 1]
+        if step in (3, 7):
+            snap.configuration.box = [10 + step, 10, 10, 0, 0, 0]
+        if step == 5:
+            snap.particles.typeid = [1, 1, 0, 0]
+        if step == 8:
+            snap.particles.N = 6
+            snap.particles.typeid = [0, 1, 0, 1, 0, 1]
+            snap.particles.mass = [1, 1, 1, 1, 1, 1]
+            snap.particles.position = numpy.full((6, 3),
+                                                 step,
+                                                 dtype=numpy.float32)
+        snap.log['value'] = [step // 4]
+        snap.validate()
+        snapshots.append(pickle.loads(pickle.dumps(snap)))
+
+    with gsd.hoomd.open(name=name, mode=open_mode.write,
+                        changed_only=True) as hf:
+        assert hf.changed_only
+        hf.extend(snapshots[:6])
+
+    # appending to an existing file continues the mode it was written in
+    with gsd.hoomd.open(name=name, mode='rb+') as hf:
+        assert hf.changed_only
+        hf.extend(snapshots[6:])
+
+    def check(hf):
+        assert len(hf) == 10
+        for expected, frame in zip(snapshots, hf):
+            assert frame.configuration.step == expected.configuration.step
+            numpy.testing.assert_array_equal(frame.configuration.box,
+                                             expected.configuration.box)
+            assert frame.particles.N == expected.particles.N
+            assert frame.particles.types == expected.particles.types
+            for field in ('typeid', 'mass', 'position'):
+                numpy.testing.assert_array_equal(
+                    getattr(frame.particles, field),
+                    getattr(expected.particles, field))
+            numpy.testing.assert_array_equal(frame.log['value'],
+                                             expected.log['value'])
+
+    with gsd.hoomd.open(name=name, mode=open_mode.read) as hf:
+        assert hf.changed_only
+        check(hf)
+
+        f = hf.file
+        assert f.find_chunk_at_or_before(frame=9,
+                                         name='configuration/box') == 7
+        assert f.find_chunk_at_or_before(frame=6,
+                                         name='configuration/box') == 3
+        assert f.find_chunk_at_or_before(frame=4,
+                                         name='particles/typeid') == 0
+        # default masses with a new N are not written
+        assert f.find_chunk_at_or_before(frame=9,
+                                         name='particles/mass') == 2
+        assert f.find_chunk_at_or_before(frame=9,
+                                         name='particles/types') == 0
+        assert f.find_chunk_at_or_before(frame=9, name='log/value') == 8
+        assert f.find_chunk_at_or_before(frame=9, name='missing') is None
+        assert not f.chunk_exists(frame=1, name='particles/typeid')
+
+    with gsd.hoomd.open(name=name, mode=open_mode.read, lazy=True) as hf:
+        check(hf)
+
+    with open(name, 'rb') as f:
+        check(gsd.hoomd.HOOMDTrajectory(gsd.pygsd.GSDFile(f)))
+
+
+def test_lazy(tmp_path, open_mode):
+    """Test that lazy trajectories read arrays when first accessed."""
+    snap = gsd.hoomd.Snapshot()
+    snap.particles.N = 3
+    snap.particles.types = ['A', 'B']
+    snap.particles.typeid = [0, 1, 1]
+    snap.particles.mass = [2, 3, 4]
+    snap.bonds.N = 1
+    snap.bonds.types = ['b']
+    snap.bonds.group = [[0, 1]]
+    snap.log['value'] = [1.5]
+    snapshots = []
+    for step in range(4):
+        snap.configuration.step = step
+        snap.particles.position = numpy.full((snap.particles.N, 3),
+                                             step,
+                                             dtype=numpy.float32)
+        if step == 2:
+            snap.particles.N = 2
+            snap.particles.typeid = [1, 0]
+            snap.particles.mass = None
+            snap.particles.position = [[1, 2, 3], [4, 5, 6]]
+        snap.validate()
+        snapshots.append(pickle.loads(pickle.dumps(snap)))
+
+    with gsd.hoomd.open(name=tmp_path / "test_lazy.gsd",
+                        mode=open_mode.write) as hf:
+        hf.extend(snapshots)
+
+    with gsd.hoomd.open(name=tmp_path / "test_lazy.gsd",
+                        mode=open_mode.read) as eager_hf, \
+            gsd.hoomd.open(name=tmp_path / "test_lazy.gsd",
+                           mode=open_mode.read,
+                           lazy=True) as hf:
+        for eager, frame in zip(eager_hf, hf):
+            # arrays are not read until they are accessed
+            assert 'position' not in vars(frame.particles)
+            assert frame.configuration.step == eager.configuration.step
+            assert frame.particles.N == eager.particles.N
+            assert frame.particles.types == eager.particles.types
+            assert frame.log == eager.log
+            for path in ('particles', 'bonds', 'angles', 'constraints'):
+                container = getattr(eager, path)
+                for name in container._default_value:
+                    data = getattr(getattr(frame, path), name)
+                    expected = getattr(container, name)
+                    numpy.testing.assert_array_equal(data, expected)
+                    if isinstance(expected, numpy.ndarray):
+                        assert data.dtype == expected.dtype
+                        assert (data.flags.writeable
+                                == expected.flags.writeable)
+
+            with pytest.raises(AttributeError):
+                frame.particles.missing
+
+        # assigned values replace arrays that have not been read
+        frame = hf[1]
+        frame.particles.position = [[7, 8, 9]] * 3
+        assert frame.particles.position == [[7, 8, 9]] * 3
+
+        # copies read all arrays
+        frame = pickle.loads(pickle.dumps(hf[3]))
+        assert '_loaders' not in vars(frame.particles)
+        numpy.testing.assert_array_equal(frame.particles.position,
+                                         snapshots[3].particles.position)
+        numpy.testing.assert_array_equal(frame.particles.mass, [1, 1])
+
+
+@pytest.mark.parametrize('changed_only', [False, True])
+def test_select(tmp_path, open_mode, changed_only):
+    """Test that selections read the same values as read_frame."""
+    snap = gsd.hoomd.Snapshot()
+    snap.configuration.box = [4, 5, 6, 0, 0, 0]
+    snap.particles.N = 3
+    snap.particles.types = ['A', 'B']
+    snap.particles.type_shapes = [{'type': 'Sphere', 'diameter': 2.0}, {}]
+    snap.particles.mass = [2, 3, 4]
+    snap.state['hpmc/integrate/d'] = [0.5]
+    snapshots = []
+    for step in range(6):
+        snap.configuration.step = step
+        snap.particles.position = numpy.full((snap.particles.N, 3),
+                                             step,
+                                             dtype=numpy.float32)
+        if step in (0, 2):
+            snap.log['value'] = [step]
+        if step == 3:
+            snap.particles.N = 2
+            snap.particles.mass = None
+            snap.particles.position = [[1, 2, 3], [4, 5, 6]]
+        if step == 4:
+            snap.configuration.box = [7, 8, 9, 0, 0, 0]
+        snap.validate()
+        snapshots.append(pickle.loads(pickle.dumps(snap)))
+
+    with gsd.hoomd.open(name=tmp_path / "test_select.gsd",
+                        mode=open_mode.write,
+                        changed_only=changed_only) as hf:
+        hf.extend(snapshots)
+
+    names = [
+        'configuration/step',
+        'configuration/box',
+        'particles/N',
+        'particles/types',
+        'particles/type_shapes',
+        'particles/position',
+        'particles/mass',
+        'particles/image',
+        'bonds/group',
+        'state/hpmc/integrate/d',
+        'log/value',
+    ]
+
+    def check(values, frame):
+        assert list(values.keys()) == names
+        assert values['configuration/step'] == frame.configuration.step
+        assert values['particles/N'] == frame.particles.N
+        assert values['particles/types'] == frame.particles.types
+        assert values['particles/type_shapes'] == frame.particles.type_shapes
+        for name in names:
+            path, quantity = name.split('/', 1)
+            if path == 'state':
+                expected = frame.state.get(quantity)
+            elif path == 'log':
+                expected = frame.log.get(quantity)
+            else:
+                expected = getattr(getattr(frame, path), quantity)
+            if expected is None:
+                assert values[name] is None
+            else:
+                numpy.testing.assert_array_equal(values[name], expected)
+
+    with gsd.hoomd.open(name=tmp_path / "test_select.gsd",
+                        mode=open_mode.read) as hf:
+        selection = hf.select(names)
+        assert len(selection) == 6
+        assert len(selection[::2]) == 3
+        for idx, values in enumerate(selection):
+            check(values, hf[idx])
+        for idx, values in zip(range(1, 6, 2), selection[1::2]):
+            check(values, hf[idx])
+        check(selection[-1], hf[5])
+        check(hf[::-2].select(names)[1], hf[3])
+
+    # a new trajectory reads the initial frame only for the selected chunks
+    with gsd.hoomd.open(name=tmp_path / "test_select.gsd",
+                        mode=open_mode.read) as hf:
+        values = hf.select(['particles/mass', 'configuration/box'])[2]
+        numpy.testing.assert_array_equal(values['particles/mass'], [2, 3, 4])
+        numpy.testing.assert_array_equal(values['configuration/box'],
+                                         [4, 5, 6, 0, 0, 0])
+
+        with pytest.raises(IndexError):
+            hf.select(['configuration/box'])[6]
+        with pytest.raises(ValueError):
+            hf.select(['particles/missing'])
+
+
+@pytest.mark.parametrize('changed_only', [False, True])
+def test_read_log(tmp_path, open_mode, changed_only):
+    """Test that read_log reads the same values as read_frame."""
+    snap = gsd.hoomd.Snapshot()
+    snap.particles.N = 2
+    snapshots = []
+    for step in range(8):
+        snap.configuration.step = step
+        snap.log = {'energy': [step * 1.5], 'vector': [[step, 2 * step]]}
+        if step == 0:
+            snap.log['initial'] = [7]
+        if step >= 3:
+            snap.log['late'] = [step]
+        if step in (2, 3):
+            snap.log['sparse'] = [step]
+        snapshots.append(pickle.loads(pickle.dumps(snap)))
+
+    with gsd.hoomd.open(name=tmp_path / "test_read_log.gsd",
+                        mode=open_mode.write,
+                        changed_only=changed_only) as hf:
+        hf.extend(snapshots)
+
+    with gsd.hoomd.open(name=tmp_path / "test_read_log.gsd",
+                        mode=open_mode.read) as hf:
+        log = hf.read_log()
+        assert set(log.keys()) == {'energy', 'vector', 'initial'}
+        for name in log:
+            assert len(log[name]) == 8
+            for idx, frame in enumerate(hf):
+                numpy.testing.assert_array_equal(log[name][idx],
+                                                 frame.log[name])
+
+        # frames before a quantity is first logged do not define it
+        assert 'late' not in hf[2].log
+        assert hf[5].log['late'] == [5]
+
+        log = hf.read_log(names=['vector'])
+        assert list(log.keys()) == ['vector']
+        assert log['vector'].shape == (8, 1, 2)
+
+        with pytest.raises(KeyError):
+            hf.read_log(names=['late'])
+        with pytest.raises(KeyError):
+            hf.read_log(names=['missing'])
+
+    with open(tmp_path / "test_read_log.gsd", 'rb') as f:
+        hf = gsd.hoomd.HOOMDTrajectory(gsd.pygsd.GSDFile(f))
+        numpy.testing.assert_array_equal(hf.read_log()['initial'], [[7]] * 8)
+
+
+def test_changed_only_errors(tmp_path):
+    """Test that changed_only must match files with frames."""
+    name = tmp_path / "test_changed_only_errors.gsd"
+    with gsd.hoomd.open(name=name, mode='wb') as hf:
+        hf.append(create_frame(0))
+
+    with pytest.raises(ValueError):
+        gsd.hoomd.open(name=name, mode='rb+', changed_only=True)
+
+    with gsd.hoomd.open(name=name, mode='rb+') as hf:
+        assert not hf.changed_only